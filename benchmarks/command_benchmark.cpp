@@ -0,0 +1,165 @@
+// Draw command recording of a 256k objects scene split in spatial chunks of 1024
+// objects, on 1 (serial, main thread only) to 8 threads: the recording into the
+// per-thread lists, then the sort and merge into the replayed stream.
+
+#include "core/jobs.hpp"
+#include "core/memory.hpp"
+#include "core/render_commands.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr u32 OBJECT_COUNT = 256 * 1024;
+	static constexpr u32 CHUNK_SIZE = 1024;
+	static constexpr u32 MATERIAL_COUNT = 32;
+	static constexpr u32 MESH_COUNT = 8;
+	static constexpr u32 RUN_COUNT = 30;
+
+	static constexpr std::array THREAD_COUNTS = { 1u, 2u, 4u, 8u };
+
+	struct Object
+	{
+		glm::mat4        model;
+		Handle<Mesh>     mesh;
+		Handle<Material> material;
+	};
+
+	struct Result
+	{
+		f64 record_ms = 1e9;
+		f64 merge_ms = 1e9;
+	};
+
+	static std::vector<Object> make_scene()
+	{
+		std::vector<Object> objects(OBJECT_COUNT);
+		for (u32 i = 0; i < OBJECT_COUNT; ++i)
+		{
+			const glm::vec3 position{ static_cast<f32>(i % 64), static_cast<f32>((i / 64) % 64),
+				                      -static_cast<f32>(i / 4096) };
+			objects[i].model = glm::translate(glm::mat4{ 1.0f }, position);
+			// neighbours rarely share their state, as in a real scene
+			objects[i].material = { (i * 7) % MATERIAL_COUNT, 0 };
+			objects[i].mesh = { (i * 3) % MESH_COUNT, 0 };
+		}
+		return objects;
+	}
+
+	static void record(
+	    const std::vector<Object>& objects, const glm::mat4& view, CommandRecorder* recorder,
+	    u32 begin, u32 end)
+	{
+		for (u32 chunk = begin; chunk < end; ++chunk)
+		{
+			CommandList& list = recorder->get_list();
+			for (u32 i = chunk * CHUNK_SIZE; i < (chunk + 1) * CHUNK_SIZE; ++i)
+			{
+				const Object& object = objects[i];
+				DrawItem      item{ .model = object.model, .mesh = object.mesh,
+					                .material = object.material };
+				item.sort_key =
+				    make_sort_key(object.material, object.mesh, -(view * object.model[3]).z);
+				list.push(item);
+			}
+		}
+	}
+
+	static b8 is_valid(const std::vector<DrawItem>& commands)
+	{
+		return commands.size() == OBJECT_COUNT &&
+		       std::is_sorted(
+		           commands.begin(), commands.end(),
+		           [](const DrawItem& lhs, const DrawItem& rhs)
+		           {
+			           return lhs.sort_key < rhs.sort_key;
+		           });
+	}
+
+	static Result measure(const std::vector<Object>& objects, u32 thread_count)
+	{
+		// the main thread is one of them
+		jobs::init({ .worker_threads = std::max(thread_count, 2u) - 1 });
+
+		const glm::mat4 view = glm::lookAt(glm::vec3{ 32.0f, 32.0f, 10.0f },
+		                                   glm::vec3{ 32.0f, 32.0f, 0.0f },
+		                                   glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+		CommandRecorder       recorder{ { .max_commands_per_thread = OBJECT_COUNT } };
+		std::vector<DrawItem> commands;
+		Result                result;
+
+		constexpr u32 CHUNK_COUNT = OBJECT_COUNT / CHUNK_SIZE;
+
+		for (u32 run = 0; run < RUN_COUNT; ++run)
+		{
+			recorder.begin_frame();
+
+			const auto start = std::chrono::steady_clock::now();
+			if (thread_count == 1)
+			{
+				record(objects, view, &recorder, 0, CHUNK_COUNT);
+			}
+			else
+			{
+				jobs::parallel_for(
+				    CHUNK_COUNT,
+				    [&objects, &view, &recorder](u32 begin, u32 end)
+				    {
+					    record(objects, view, &recorder, begin, end);
+				    },
+				    1);
+			}
+			const auto recorded = std::chrono::steady_clock::now();
+			recorder.merge(&commands);
+			const auto merged = std::chrono::steady_clock::now();
+
+			if (!is_valid(commands))
+			{
+				SPDLOG_ERROR("Merged commands are incomplete or unsorted.");
+				break;
+			}
+
+			result.record_ms = std::min(
+			    result.record_ms, std::chrono::duration<f64, std::milli>(recorded - start).count());
+			result.merge_ms = std::min(
+			    result.merge_ms, std::chrono::duration<f64, std::milli>(merged - recorded).count());
+		}
+
+		jobs::shutdown();
+		return result;
+	}
+}  // namespace
+
+i32 main()
+{
+	memory::init({});
+
+	SPDLOG_INFO(
+	    "{} objects in chunks of {}, {} runs, best times", OBJECT_COUNT, CHUNK_SIZE, RUN_COUNT);
+
+	const std::vector<Object> objects = make_scene();
+
+	f64 serial_ms = 0.0;
+	for (const u32 thread_count : THREAD_COUNTS)
+	{
+		const Result result = measure(objects, thread_count);
+		const f64    total_ms = result.record_ms + result.merge_ms;
+		serial_ms = thread_count == 1 ? total_ms : serial_ms;
+
+		SPDLOG_INFO(
+		    "{} threads: record {:7.3f} ms, sort and merge {:7.3f} ms, speedup {:4.2f}x",
+		    thread_count, result.record_ms, result.merge_ms, serial_ms / total_ms);
+	}
+
+	memory::shutdown();
+	return 0;
+}
@@ -0,0 +1,232 @@
+// Transform + velocity integration over 1M entities: the ECS (sequential and on
+// the job system) against an array of game objects (AoS). Then a value derived
+// from the velocity, recomputed for every entity against only for the chunks
+// whose velocity changed since the system's last run.
+
+#include "core/ecs.hpp"
+#include "core/jobs.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr u32 ENTITY_COUNT = 1'000'000;
+	static constexpr u32 RUN_COUNT = 20;
+	static constexpr f32 DELTA_TIME = 1.0f / 60.0f;
+	// velocities written between two runs of the schedule, spread over the entities
+	static constexpr u32 CHANGED_COUNT = 64;
+
+	struct Transform
+	{
+		glm::vec3 position{ 0.0f };
+		glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+		glm::vec3 scale{ 1.0f };
+	};
+
+	struct Velocity
+	{
+		glm::vec3 linear{ 0.0f };
+	};
+
+	// data a game object usually carries along, not touched by the update
+	struct RenderData
+	{
+		glm::mat4 model{ 1.0f };
+		u32       mesh = 0;
+		u32       material = 0;
+	};
+
+	// derived from the velocity
+	struct Speed
+	{
+		f32 value = 0.0f;
+	};
+
+	struct GameObject
+	{
+		Transform  transform;
+		Velocity   velocity;
+		RenderData render_data;
+	};
+
+	static Velocity make_velocity(u32 i)
+	{
+		return { { static_cast<f32>(i % 7), static_cast<f32>(i % 11), static_cast<f32>(i % 13) } };
+	}
+
+	template<typename Fn>
+	static void measure(const char* name, Fn&& fn)
+	{
+		f64 best_ms = 1e9;
+		f64 total_ms = 0.0;
+
+		for (u32 run = 0; run < RUN_COUNT; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			fn();
+			const auto end = std::chrono::steady_clock::now();
+
+			const f64 ms = std::chrono::duration<f64, std::milli>(end - start).count();
+			best_ms = std::min(best_ms, ms);
+			total_ms += ms;
+		}
+
+		SPDLOG_INFO(
+		    "{:<24} best {:7.3f} ms, average {:7.3f} ms", name, best_ms, total_ms / RUN_COUNT);
+	}
+}  // namespace
+
+i32 main()
+{
+	jobs::init({});
+
+	SPDLOG_INFO("{} entities, {} runs, {} threads", ENTITY_COUNT, RUN_COUNT, jobs::get_thread_count());
+
+	// AoS baseline
+	{
+		auto objects = std::make_unique<GameObject[]>(ENTITY_COUNT);
+		for (u32 i = 0; i < ENTITY_COUNT; ++i)
+		{
+			objects[i].velocity = make_velocity(i);
+		}
+
+		measure(
+		    "AoS",
+		    [&objects]
+		    {
+			    for (u32 i = 0; i < ENTITY_COUNT; ++i)
+			    {
+				    objects[i].transform.position += objects[i].velocity.linear * DELTA_TIME;
+			    }
+		    });
+	}
+
+	// archetype SoA
+	{
+		ecs::World world;
+		for (u32 i = 0; i < ENTITY_COUNT; ++i)
+		{
+			world.create_entity(Transform{}, make_velocity(i), RenderData{});
+		}
+
+		auto query = world.query<Transform, const Velocity>();
+
+		measure(
+		    "ECS each",
+		    [&query]
+		    {
+			    query.each(
+			        [](Transform& transform, const Velocity& velocity)
+			        {
+				        transform.position += velocity.linear * DELTA_TIME;
+			        });
+		    });
+
+		measure(
+		    "ECS chunks",
+		    [&query]
+		    {
+			    query.for_each_chunk(
+			        [](u32 count, const ecs::Entity*, Transform* transforms, const Velocity* velocities)
+			        {
+				        for (u32 i = 0; i < count; ++i)
+				        {
+					        transforms[i].position += velocities[i].linear * DELTA_TIME;
+				        }
+			        });
+		    });
+
+		measure(
+		    "ECS parallel each",
+		    [&query]
+		    {
+			    query.parallel_each(
+			        [](Transform& transform, const Velocity& velocity)
+			        {
+				        transform.position += velocity.linear * DELTA_TIME;
+			        });
+		    });
+	}
+
+	// change tracking
+	{
+		ecs::World               world;
+		std::vector<ecs::Entity> entities;
+		entities.reserve(ENTITY_COUNT);
+		for (u32 i = 0; i < ENTITY_COUNT; ++i)
+		{
+			entities.push_back(world.create_entity(make_velocity(i), Speed{}));
+		}
+
+		auto update_speed =
+		    [](u32 count, const ecs::Entity*, Speed* speeds, const Velocity* velocities)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				speeds[i].value = glm::length(velocities[i].linear);
+			}
+		};
+
+		u32 updated_count = 0;
+
+		ecs::Schedule schedule;
+		schedule.add_system<Speed, const Velocity>(
+		    "Update speeds",
+		    [&update_speed, &updated_count](const ecs::SystemContext& context)
+		    {
+			    auto query = context.world.query<Speed, const Velocity>();
+			    query.changed_since<Velocity>(context.last_run_version);
+			    updated_count = query.count();
+			    query.for_each_chunk(update_speed);
+		    });
+
+		// the first run visits everything
+		schedule.run(world, DELTA_TIME);
+
+		// a different entity of the same chunks every run
+		u32  run = 0;
+		auto change_velocities = [&world, &entities, &run]
+		{
+			++run;
+			for (u32 i = 0; i < CHANGED_COUNT; ++i)
+			{
+				const u32 index = (i * (ENTITY_COUNT / CHANGED_COUNT) + run) % ENTITY_COUNT;
+				world.get_component<Velocity>(entities[index])->linear.x += 1.0f;
+			}
+		};
+
+		auto query = world.query<Speed, const Velocity>();
+		measure(
+		    "Speeds, all",
+		    [&change_velocities, &query, &update_speed]
+		    {
+			    change_velocities();
+			    query.for_each_chunk(update_speed);
+		    });
+
+		measure(
+		    "Speeds, changed only",
+		    [&change_velocities, &schedule, &world]
+		    {
+			    change_velocities();
+			    schedule.run(world, DELTA_TIME);
+		    });
+
+		SPDLOG_INFO(
+		    "{} velocities changed per run, {} entities in the changed chunks", CHANGED_COUNT,
+		    updated_count);
+	}
+
+	jobs::shutdown();
+	return 0;
+}
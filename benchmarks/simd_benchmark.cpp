@@ -0,0 +1,158 @@
+// Model and model-view-projection matrices of 16k objects from their TRS: glm one object at a
+// time against the batched kernels of every instruction set the CPU supports. The batched
+// results are checked against glm.
+
+#include "core/simd.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr u32 OBJECT_COUNT = 16 * 1024;
+	static constexpr u32 BLOCK_COUNT = OBJECT_COUNT / simd::LANES;
+	static constexpr u32 RUN_COUNT = 100;
+	static constexpr f32 TOLERANCE = 1e-4f;
+
+	struct Object
+	{
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+	};
+
+	template<typename Fn>
+	static f64 measure(const char* name, Fn&& fn)
+	{
+		f64 best_ms = 1e9;
+
+		for (u32 run = 0; run < RUN_COUNT; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			fn();
+			const auto end = std::chrono::steady_clock::now();
+
+			best_ms = std::min(best_ms, std::chrono::duration<f64, std::milli>(end - start).count());
+		}
+
+		SPDLOG_INFO(
+		    "{:<8} best {:7.3f} ms, {:8.1f} objects/us", name, best_ms,
+		    OBJECT_COUNT / (best_ms * 1000.0));
+		return best_ms;
+	}
+
+	// relative to the magnitude of the expected value
+	static f32 get_max_error(
+	    const std::vector<glm::mat4>& expected, const std::vector<simd::mat4x8>& batches)
+	{
+		f32 max_error = 0.0f;
+
+		for (u32 i = 0; i < OBJECT_COUNT; ++i)
+		{
+			const glm::mat4 actual = simd::get_lane(batches[i / simd::LANES], i % simd::LANES);
+
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+				{
+					const f32 reference = expected[i][column][row];
+					const f32 error =
+					    std::abs(actual[column][row] - reference) / std::max(1.0f, std::abs(reference));
+					max_error = std::max(max_error, error);
+				}
+			}
+		}
+
+		return max_error;
+	}
+}  // namespace
+
+i32 main()
+{
+	SPDLOG_INFO(
+	    "{} objects, {} runs, {} supported", OBJECT_COUNT, RUN_COUNT,
+	    simd::get_isa_name(simd::get_supported_isa()));
+
+	const glm::mat4 view_projection =
+	    glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+	    glm::lookAt(glm::vec3{ 0.0f, 2.0f, 5.0f }, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+	std::vector<Object> objects(OBJECT_COUNT);
+	for (u32 i = 0; i < OBJECT_COUNT; ++i)
+	{
+		const f32 t = static_cast<f32>(i);
+		objects[i].position = { std::sin(t) * 20.0f, std::cos(t * 0.5f) * 10.0f, -t * 0.01f };
+		objects[i].rotation =
+		    glm::angleAxis(t * 0.1f, glm::normalize(glm::vec3{ 1.0f, 0.3f + std::sin(t), 0.5f }));
+		objects[i].scale = glm::vec3{ 0.5f + static_cast<f32>(i % 5) * 0.25f };
+	}
+
+	// glm, one object at a time as the renderer used to do it
+	std::vector<glm::mat4> expected(OBJECT_COUNT);
+	measure(
+	    "glm",
+	    [&]
+	    {
+		    for (u32 i = 0; i < OBJECT_COUNT; ++i)
+		    {
+			    glm::mat4 model = glm::translate(glm::mat4{ 1.0f }, objects[i].position);
+			    model *= glm::mat4_cast(objects[i].rotation);
+			    model = glm::scale(model, objects[i].scale);
+			    expected[i] = view_projection * model;
+		    }
+	    });
+
+	std::vector<simd::vec3x8> positions(BLOCK_COUNT);
+	std::vector<simd::quatx8> rotations(BLOCK_COUNT);
+	std::vector<simd::vec3x8> scales(BLOCK_COUNT);
+	std::vector<simd::mat4x8> models(BLOCK_COUNT);
+	std::vector<simd::mat4x8> results(BLOCK_COUNT);
+
+	for (u32 i = 0; i < OBJECT_COUNT; ++i)
+	{
+		simd::set_lane(&positions[i / simd::LANES], i % simd::LANES, objects[i].position);
+		simd::set_lane(&rotations[i / simd::LANES], i % simd::LANES, objects[i].rotation);
+		simd::set_lane(&scales[i / simd::LANES], i % simd::LANES, objects[i].scale);
+	}
+
+	i32 exit_code = 0;
+
+	for (const simd::Isa isa :
+	     { simd::Isa::SCALAR, simd::Isa::SSE4_2, simd::Isa::AVX2, simd::Isa::AVX512 })
+	{
+		if (isa > simd::get_supported_isa())
+		{
+			break;
+		}
+
+		simd::set_isa(isa);
+		std::ranges::fill(results, simd::mat4x8{});
+
+		measure(
+		    simd::get_isa_name(isa),
+		    [&]
+		    {
+			    simd::compose_trs(positions, rotations, scales, models);
+			    simd::multiply(view_projection, models, results);
+		    });
+
+		const f32 max_error = get_max_error(expected, results);
+		if (max_error > TOLERANCE)
+		{
+			SPDLOG_ERROR(
+			    "{} differs from glm, max relative error {}", simd::get_isa_name(isa), max_error);
+			exit_code = 1;
+		}
+	}
+
+	return exit_code;
+}
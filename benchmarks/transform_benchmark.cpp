@@ -0,0 +1,114 @@
+// World matrices of a 100k nodes hierarchy (1000 trees of three levels): everything
+// animated, only the roots animated (the children follow) and nothing animated.
+
+#include "core/jobs.hpp"
+#include "core/transform_hierarchy.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr u32 ROOT_COUNT = 1000;
+	static constexpr u32 CHILDREN_PER_NODE = 9;
+	static constexpr u32 GRANDCHILDREN_PER_NODE = 10;
+	static constexpr u32 NODE_COUNT =
+	    ROOT_COUNT * (1 + CHILDREN_PER_NODE * (1 + GRANDCHILDREN_PER_NODE));
+	static constexpr u32 RUN_COUNT = 50;
+
+	static Transform make_transform(u32 i)
+	{
+		const f32 angle = static_cast<f32>(i) * 0.01f;
+		return { .position = { static_cast<f32>(i % 7), static_cast<f32>(i % 11), 1.0f },
+			     .rotation = glm::angleAxis(angle, glm::vec3{ 0.0f, 1.0f, 0.0f }) };
+	}
+
+	// only the update is timed, `prepare` animates the nodes beforehand
+	template<typename Prepare>
+	static void measure(const char* name, TransformHierarchy* hierarchy, Prepare&& prepare)
+	{
+		f64 best_ms = 1e9;
+		f64 total_ms = 0.0;
+
+		for (u32 run = 0; run < RUN_COUNT; ++run)
+		{
+			prepare(run);
+
+			const auto start = std::chrono::steady_clock::now();
+			hierarchy->update();
+			const auto end = std::chrono::steady_clock::now();
+
+			const f64 ms = std::chrono::duration<f64, std::milli>(end - start).count();
+			best_ms = std::min(best_ms, ms);
+			total_ms += ms;
+		}
+
+		SPDLOG_INFO(
+		    "{:<16} {:6} updated, best {:7.3f} ms, average {:7.3f} ms", name,
+		    hierarchy->get_last_update_count(), best_ms, total_ms / RUN_COUNT);
+	}
+}  // namespace
+
+i32 main()
+{
+	jobs::init({});
+
+	SPDLOG_INFO("{} nodes, {} runs, {} threads", NODE_COUNT, RUN_COUNT, jobs::get_thread_count());
+
+	TransformHierarchy             hierarchy{ NODE_COUNT };
+	std::vector<Handle<Transform>> nodes;
+	std::vector<Handle<Transform>> roots;
+	nodes.reserve(NODE_COUNT);
+
+	// created depth first, the first update sorts them by level
+	for (u32 root = 0; root < ROOT_COUNT; ++root)
+	{
+		const Handle<Transform> root_node = hierarchy.create(make_transform(root));
+		roots.push_back(root_node);
+		nodes.push_back(root_node);
+
+		for (u32 child = 0; child < CHILDREN_PER_NODE; ++child)
+		{
+			const Handle<Transform> child_node =
+			    hierarchy.create(make_transform(child), root_node);
+			nodes.push_back(child_node);
+
+			for (u32 grandchild = 0; grandchild < GRANDCHILDREN_PER_NODE; ++grandchild)
+			{
+				nodes.push_back(hierarchy.create(make_transform(grandchild), child_node));
+			}
+		}
+	}
+
+	hierarchy.update();
+
+	measure(
+	    "All animated", &hierarchy,
+	    [&](u32 run)
+	    {
+		    for (u32 i = 0; i < nodes.size(); ++i)
+		    {
+			    hierarchy.set_local(nodes[i], make_transform(i + run));
+		    }
+	    });
+
+	measure(
+	    "Roots animated", &hierarchy,
+	    [&](u32 run)
+	    {
+		    for (u32 i = 0; i < roots.size(); ++i)
+		    {
+			    hierarchy.set_local(roots[i], make_transform(i + run));
+		    }
+	    });
+
+	measure("Static", &hierarchy, [](u32) {});
+
+	jobs::shutdown();
+	return 0;
+}
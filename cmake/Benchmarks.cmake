@@ -0,0 +1,18 @@
+#[[ Adds the benchmark executable ${NAME} built from the sources in ${ARGN}, it
+    shares the compile options and the macro definitions of the main project. ]]
+function(add_benchmark NAME)
+    add_executable(${NAME} ${ARGN})
+    target_include_directories(${NAME} PRIVATE "${PROJECT_SOURCE_DIR}/src")
+    target_link_libraries(${NAME} PRIVATE
+            fmt::fmt
+            spdlog::spdlog
+            glm::glm
+            Tracy::TracyClient
+            Threads::Threads
+    )
+
+    get_target_property(MAIN_COMPILE_OPTIONS ${PROJECT_NAME} COMPILE_OPTIONS)
+    target_compile_options(${NAME} PRIVATE ${MAIN_COMPILE_OPTIONS})
+
+    setup_target_compiler_definitions(${NAME})
+endfunction()
@@ -36,4 +36,16 @@ function(setup_target_compiler_definitions TARGET)
     custom_add_macro_definition(${LOG_LEVEL_INFO} SPDLOG_ACTIVE_LEVEL=2 "Log level set to INFO") # equivalent to SPDLOG_LEVEL_INFO
     
     custom_add_macro_definition(${SHIPPING_BUILD} SPDLOG_NO_SOURCE_LOC "Disabling source code showing in logs.")
+
+    # content
+    custom_add_macro_definition(${EMBED_CONTENTS} EMBEDDED_CONTENTS "Contents embedded into the executable")
+
+    # memory
+    custom_add_macro_definition(${TRACK_ALLOCATIONS} TRACK_ALLOCATIONS "Tracking heap allocations")
+
+    # jobs
+    custom_add_macro_definition(${JOBS_USE_FIBERS} JOBS_USE_FIBERS "Job system running on fibers")
+
+    # OpenGL
+    custom_add_macro_definition(${COUNT_GL_CALLS} COUNT_GL_CALLS "Counting OpenGL calls")
 endfunction()
\ No newline at end of file
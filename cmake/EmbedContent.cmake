@@ -0,0 +1,67 @@
+#[[ Packs the content folder into a ZIP archive at build time and compiles it
+    into the target as a byte array (see "cmake/scripts/BinaryToSource.cmake"),
+    the virtual filesystem then mounts it from memory, no file is opened and no
+    content folder is needed next to the executable.
+
+    Parameters
+        TARGET_NAME: The target that will contain the archive.
+        CONTENT_DIR_NAME: The path to the contents, relative the the project root.
+]]
+function(embed_content TARGET_NAME CONTENT_DIR_NAME)
+    set(CONTENT_DIR_PATH ${PROJECT_ROOT_DIR}/${CONTENT_DIR_NAME})
+    get_filename_component(CONTENT_DIR ${CONTENT_DIR_PATH} NAME)
+
+    set(EMBED_DIR "${CMAKE_CURRENT_BINARY_DIR}/embedded")
+    set(ARCHIVE_FILE "${EMBED_DIR}/${CONTENT_DIR}.zip")
+    set(SOURCE_FILE "${EMBED_DIR}/${CONTENT_DIR}_archive.cpp")
+
+    # relative paths so that the archive root maps to the mount point
+    file(GLOB_RECURSE CONTENT_FILES
+            LIST_DIRECTORIES false
+            RELATIVE ${CONTENT_DIR_PATH}
+            CONFIGURE_DEPENDS
+            "${CONTENT_DIR_PATH}/*")
+    list(SORT CONTENT_FILES)
+    list(TRANSFORM CONTENT_FILES PREPEND "${CONTENT_DIR_PATH}/" OUTPUT_VARIABLE CONTENT_FILES_ABSOLUTE)
+
+    add_custom_command(
+            OUTPUT ${ARCHIVE_FILE}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${EMBED_DIR}
+            COMMAND ${CMAKE_COMMAND} -E tar cf ${ARCHIVE_FILE} --format=zip -- ${CONTENT_FILES}
+            WORKING_DIRECTORY ${CONTENT_DIR_PATH}
+            DEPENDS ${CONTENT_FILES_ABSOLUTE}
+            VERBATIM
+            COMMENT "Packing '${CONTENT_DIR_NAME}' into '${ARCHIVE_FILE}'"
+            COMMAND_EXPAND_LISTS)
+
+    add_custom_command(
+            OUTPUT ${SOURCE_FILE}
+            COMMAND ${CMAKE_COMMAND}
+            -DINPUT_FILE=${ARCHIVE_FILE}
+            -DOUTPUT_FILE=${SOURCE_FILE}
+            -DSYMBOL_NAME=g_contents_archive
+            -DNAMESPACE=core::embedded
+            -P ${PROJECT_ROOT_DIR}/cmake/scripts/BinaryToSource.cmake
+            COMMAND ${CMAKE_COMMAND}
+            -DFILE_PATH=${ARCHIVE_FILE}
+            "-DLABEL=Embedded contents archive"
+            -P ${PROJECT_ROOT_DIR}/cmake/scripts/PrintFileSize.cmake
+            DEPENDS ${ARCHIVE_FILE} ${PROJECT_ROOT_DIR}/cmake/scripts/BinaryToSource.cmake
+            VERBATIM
+            COMMENT "Embedding '${ARCHIVE_FILE}' as C++ source")
+
+    target_sources(${TARGET_NAME} PRIVATE ${SOURCE_FILE})
+endfunction()
+
+#[[ Prints the size of the target binary after every build, useful to compare
+    the embedded and the symlinked content modes.
+]]
+function(report_binary_size TARGET_NAME)
+    add_custom_command(
+            TARGET ${TARGET_NAME} POST_BUILD
+            COMMAND ${CMAKE_COMMAND}
+            -DFILE_PATH=$<TARGET_FILE:${TARGET_NAME}>
+            "-DLABEL=Binary size of '${TARGET_NAME}'"
+            -P ${PROJECT_ROOT_DIR}/cmake/scripts/PrintFileSize.cmake
+            VERBATIM)
+endfunction()
@@ -1,2 +1,7 @@
 # Put global options here
 option(FORCE_DISABLE_LOGGING "Disable all logging" OFF)
+option(EMBED_CONTENTS "Compile the contents folder into the executable (default for shipping builds)" ${SHIPPING_BUILD})
+option(TRACK_ALLOCATIONS "Count heap allocations per frame and assert on hot path allocations" ${DEV_BUILD})
+option(BUILD_BENCHMARKS "Build the benchmark executables" OFF)
+option(JOBS_USE_FIBERS "Run jobs on fibers, waiting jobs are parked instead of blocking the worker" OFF)
+option(COUNT_GL_CALLS "Count the OpenGL calls, draws and uploads per frame by wrapping the glad entry points" OFF)
@@ -38,7 +38,7 @@ block()
     force_bool(TRACY_PATCHABLE_NOPSLEDS OFF)  # Enable nopsleds for efficient patching by system-level tools (e.g. rr)
     force_bool(TRACY_DELAYED_INIT OFF)  # Enable delayed initialization of the library (init on first call)
     force_bool(TRACY_MANUAL_LIFETIME OFF)  # Enable the manual lifetime management of the profile
-    force_bool(TRACY_FIBERS OFF)  # Enable fibers support
+    force_bool(TRACY_FIBERS ${JOBS_USE_FIBERS})  # Enable fibers support (needed by the job system fibers)
     force_bool(TRACY_NO_CRASH_HANDLER OFF)  # Disable crash handling
     force_bool(TRACY_TIMER_FALLBACK OFF)  # Use lower resolution timers
     force_bool(TRACY_LIBUNWIND_BACKTRACE OFF)  # Use libunwind backtracing where supported
@@ -0,0 +1,46 @@
+#[[ Script mode (cmake -P) helper that converts a binary file into a C++ source
+    file defining a byte array, used to bake assets into the executable.
+
+    Parameters (passed with -D)
+        INPUT_FILE: The binary file to embed.
+        OUTPUT_FILE: The generated C++ source file.
+        SYMBOL_NAME: The name of the generated array, "${SYMBOL_NAME}_size" holds its size.
+        NAMESPACE: The namespace for the generated symbols.
+]]
+foreach (REQUIRED_VAR INPUT_FILE OUTPUT_FILE SYMBOL_NAME NAMESPACE)
+    if (NOT DEFINED ${REQUIRED_VAR})
+        message(FATAL_ERROR "BinaryToSource: '${REQUIRED_VAR}' was not defined.")
+    endif ()
+endforeach ()
+
+file(READ "${INPUT_FILE}" HEX_CONTENT HEX)
+file(SIZE "${INPUT_FILE}" INPUT_SIZE)
+
+# "0a1b..." -> "0x0a,0x1b,..." with 16 bytes per line
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_CONTENT}")
+string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)  # no {n} quantifier in CMake regexes
+string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n\t\t" BYTES "${BYTES}")
+
+get_filename_component(INPUT_NAME "${INPUT_FILE}" NAME)
+
+file(WRITE "${OUTPUT_FILE}.tmp"
+"// File: '${INPUT_NAME}' (${INPUT_SIZE} bytes)
+// Generated by 'cmake/scripts/BinaryToSource.cmake', do not edit.
+
+#include <cstddef>
+
+namespace ${NAMESPACE}
+{
+	// clang-format off
+	alignas(16) extern const unsigned char ${SYMBOL_NAME}[] = {
+		${BYTES}
+	};
+	// clang-format on
+
+	extern const std::size_t ${SYMBOL_NAME}_size = ${INPUT_SIZE};
+}  // namespace ${NAMESPACE}
+")
+
+# only touch the output when it changed, avoids needless recompilations
+file(COPY_FILE "${OUTPUT_FILE}.tmp" "${OUTPUT_FILE}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT_FILE}.tmp")
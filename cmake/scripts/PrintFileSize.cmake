@@ -0,0 +1,9 @@
+#[[ Script mode (cmake -P) helper that prints the size of a file.
+
+    Parameters (passed with -D)
+        FILE_PATH: The file to measure.
+        LABEL: Text printed before the size.
+]]
+file(SIZE "${FILE_PATH}" FILE_SIZE)
+math(EXPR FILE_SIZE_KIB "${FILE_SIZE} / 1024")
+message(STATUS "${LABEL}: ${FILE_SIZE} bytes (${FILE_SIZE_KIB} KiB)")
@@ -0,0 +1,29 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D source;
+uniform float sharpness; // 0 is a plain bilinear upscale
+
+void main()
+{
+    vec3 center = texture(source, TexCoord).rgb;
+    if (sharpness <= 0.0)
+    {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+
+    // unsharp mask over the neighbouring source texels, kept within their range against halos
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    vec3 up = texture(source, TexCoord + vec2(0.0, texel.y)).rgb;
+    vec3 down = texture(source, TexCoord - vec2(0.0, texel.y)).rgb;
+    vec3 left = texture(source, TexCoord - vec2(texel.x, 0.0)).rgb;
+    vec3 right = texture(source, TexCoord + vec2(texel.x, 0.0)).rgb;
+
+    vec3 low = min(center, min(min(up, down), min(left, right)));
+    vec3 high = max(center, max(max(up, down), max(left, right)));
+    vec3 detail = 4.0 * center - (up + down + left + right);
+    FragColor = vec4(clamp(center + detail * sharpness * 0.25, low, high), 1.0);
+}
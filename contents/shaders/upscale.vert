@@ -0,0 +1,11 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+out vec2 TexCoord;
+
+// a single triangle covering the screen, its corners outside are clipped
+void main()
+{
+    gl_Position = vec4(aPos, 0.0, 1.0);
+    TexCoord = aPos * 0.5 + 0.5;
+}
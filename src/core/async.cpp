@@ -0,0 +1,92 @@
+#include "core/async.hpp"
+
+#include <tracy/Tracy.hpp>
+
+#include <mutex>
+
+namespace
+{
+	using namespace core;
+
+	// intrusive FIFO, nodes are owned by the suspended coroutines
+	class ScheduleQueue
+	{
+	public:
+		void push(async::ScheduleNode* node)
+		{
+			node->next = nullptr;
+			if (m_tail)
+			{
+				m_tail->next = node;
+			}
+			else
+			{
+				m_head = node;
+			}
+			m_tail = node;
+		}
+
+		async::ScheduleNode* take_all()
+		{
+			async::ScheduleNode* head = m_head;
+			m_head = nullptr;
+			m_tail = nullptr;
+			return head;
+		}
+
+	private:
+		async::ScheduleNode* m_head = nullptr;
+		async::ScheduleNode* m_tail = nullptr;
+	};
+
+	static void run_node(async::ScheduleNode* node)
+	{
+		if (node->work)
+		{
+			node->work(node);
+		}
+		node->handle.resume();
+	}
+
+	static std::mutex    g_gl_thread_mutex;
+	static ScheduleQueue g_gl_thread_queue;
+}  // namespace
+
+void core::async::pump_gl_thread()
+{
+	ZoneScopedN("Async GL thread");
+
+	// coroutines scheduled while pumping run on the next frame
+	ScheduleNode* node = nullptr;
+	{
+		std::lock_guard lock{ g_gl_thread_mutex };
+		node = g_gl_thread_queue.take_all();
+	}
+
+	while (node)
+	{
+		// resuming may reuse the node (the coroutine awaits again), read it first
+		ScheduleNode* next = node->next;
+		run_node(node);
+		node = next;
+	}
+}
+
+void core::async::schedule_on_worker(ScheduleNode* node)
+{
+	node->job.function = [](void* data)
+	{
+		ZoneScopedN("Async work");
+		run_node(static_cast<ScheduleNode*>(data));
+	};
+	node->job.data = node;
+
+	// no counter, nobody waits for it, the coroutine itself is the continuation
+	jobs::run(&node->job, 1, nullptr);
+}
+
+void core::async::schedule_on_gl_thread(ScheduleNode* node)
+{
+	std::lock_guard lock{ g_gl_thread_mutex };
+	g_gl_thread_queue.push(node);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "core/filesystem.hpp"
+#include "core/jobs.hpp"
+#include "core/types.hpp"
+
+#include <coroutine>
+#include <utility>
+
+/**
+ * Awaitables to write loaders as a single `co_await` chain on top of `core::Task`,
+ * for example "read file -> decode on a worker -> upload on the GL thread".
+ * Scheduling a coroutine never allocates, every awaiter is an intrusive node of
+ * the queue it is pushed to (or embeds the job it runs as) and lives in the
+ * (pooled) coroutine frame. Worker steps run on the job system.
+ */
+namespace core::async
+{
+	struct ScheduleNode
+	{
+		std::coroutine_handle<> handle;
+		ScheduleNode*           next = nullptr;
+		void (*work)(ScheduleNode* node) = nullptr;  // optional, runs right before resuming
+		jobs::Job               job;
+	};
+
+	/**
+	 * Resumes every coroutine waiting for the thread owning the OpenGL context (the
+	 * render thread), call once per frame from that thread.
+	 */
+	void pump_gl_thread();
+
+	void schedule_on_worker(ScheduleNode* node);
+	void schedule_on_gl_thread(ScheduleNode* node);
+
+	/** Continues the coroutine on a job system worker, for CPU work. */
+	inline auto resume_on_worker()
+	{
+		struct Awaiter : ScheduleNode
+		{
+			b8 await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> coroutine) noexcept
+			{
+				handle = coroutine;
+				schedule_on_worker(this);
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		return Awaiter{ {} };
+	}
+
+	/**
+	 * Continues the coroutine on the GL (render) thread at the start of its next
+	 * frame, required for anything touching the OpenGL context.
+	 */
+	inline auto next_frame()
+	{
+		struct Awaiter : ScheduleNode
+		{
+			b8 await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> coroutine) noexcept
+			{
+				handle = coroutine;
+				schedule_on_gl_thread(this);
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		return Awaiter{ {} };
+	}
+
+	/**
+	 * Reads a file on a job system worker, the coroutine continues on that worker with
+	 * the file contents (ready to be decoded there).
+	 */
+	template<typename TOutput, CoreFile TBaseDir>
+	auto read_file(FileType<TBaseDir> file)
+	{
+		struct Awaiter : ScheduleNode
+		{
+			FileType<TBaseDir> file;
+			TOutput            contents;
+
+			b8 await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> coroutine) noexcept
+			{
+				handle = coroutine;
+				work = [](ScheduleNode* self)
+				{
+					auto* awaiter = static_cast<Awaiter*>(self);
+					awaiter->contents = fs::instance().read_file<TOutput>(awaiter->file);
+				};
+				schedule_on_worker(this);
+			}
+
+			TOutput await_resume() noexcept
+			{
+				return std::move(contents);
+			}
+		};
+
+		return Awaiter{ {}, std::move(file), {} };
+	}
+}  // namespace core::async
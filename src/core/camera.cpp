@@ -1,12 +1,13 @@
 #include "camera.hpp"
 
 #include "core/event_handler.hpp"
-#include "core/timing.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
 #include <imgui/imgui.h>
 
 #include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace
@@ -44,20 +45,46 @@ namespace
 		return rotation * translation;  // Remember to read from right to left (first translation
 		                                // then rotation)
 	}
+
+	// Gribb-Hartmann, the planes are sums of the rows of the view-projection matrix
+	static core::Frustum extract_frustum(const glm::mat4& view_projection)
+	{
+		const glm::mat4 rows = glm::transpose(view_projection);
+
+		core::Frustum frustum;
+		frustum.planes[core::Frustum::PLANE_LEFT] = rows[3] + rows[0];
+		frustum.planes[core::Frustum::PLANE_RIGHT] = rows[3] - rows[0];
+		frustum.planes[core::Frustum::PLANE_BOTTOM] = rows[3] + rows[1];
+		frustum.planes[core::Frustum::PLANE_TOP] = rows[3] - rows[1];
+		frustum.planes[core::Frustum::PLANE_NEAR] = rows[3] + rows[2];
+		frustum.planes[core::Frustum::PLANE_FAR] = rows[3] - rows[2];
+
+		for (glm::vec4& plane : frustum.planes)
+		{
+			plane /= glm::length(glm::vec3{ plane });
+		}
+
+		return frustum;
+	}
 }  // namespace
 
-enum class CameraMovement : u8
+b8 core::Frustum::intersects_sphere(const glm::vec3& center, f32 radius) const
 {
-	NONE,
-	FORWARD,
-	BACKWARD,
-	LEFT,
-	RIGHT
-};
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3{ plane }, center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
 core::Camera::Camera(
     f32 pos_x, f32 pos_y, f32 pos_z, f32 up_x, f32 up_y, f32 up_z, f32 yaw, f32 pitch)
     : m_position{ glm::vec3(pos_x, pos_y, pos_z) }
+    , m_previous_position{ m_position }
+    , m_render_position{ m_position }
     , m_front{ glm::vec3(0.0f, 0.0f, -1.0f) }
     , m_world_up{ glm::vec3(up_x, up_y, up_z) }
     , m_yaw{ yaw }
@@ -68,7 +95,6 @@ core::Camera::Camera(
     , m_fps_mode{ false }
     , m_use_custom_look_at{ false }
 {
-	update_vectors();
 }
 
 core::Camera::Camera(glm::vec3 position, glm::vec3 up, f32 yaw, f32 pitch)
@@ -76,8 +102,72 @@ core::Camera::Camera(glm::vec3 position, glm::vec3 up, f32 yaw, f32 pitch)
 {
 }
 
-void core::Camera::update_vectors()
+void core::Camera::set_aspect_ratio(f32 aspect_ratio)
+{
+	if (!std::isfinite(aspect_ratio) || aspect_ratio <= 0.0f || aspect_ratio == m_aspect_ratio)
+	{
+		return;
+	}
+
+	m_aspect_ratio = aspect_ratio;
+	mark_dirty(DIRTY_PROJECTION);
+}
+
+const glm::mat4& core::Camera::get_view_matrix() const
+{
+	update_matrices();
+	return m_view;
+}
+
+const glm::mat4& core::Camera::get_projection_matrix() const
 {
+	update_matrices();
+	return m_projection;
+}
+
+const glm::mat4& core::Camera::get_view_projection_matrix() const
+{
+	update_matrices();
+	return m_view_projection;
+}
+
+const glm::mat4& core::Camera::get_inverse_view_matrix() const
+{
+	update_matrices();
+	return m_inverse_view;
+}
+
+const glm::mat4& core::Camera::get_inverse_projection_matrix() const
+{
+	update_matrices();
+	return m_inverse_projection;
+}
+
+const glm::mat4& core::Camera::get_inverse_view_projection_matrix() const
+{
+	update_matrices();
+	return m_inverse_view_projection;
+}
+
+const core::Frustum& core::Camera::get_frustum() const
+{
+	update_matrices();
+	return m_frustum;
+}
+
+void core::Camera::mark_dirty(u8 flags)
+{
+	m_dirty_flags |= flags;
+	++m_version;
+}
+
+void core::Camera::update_vectors() const
+{
+	if ((m_dirty_flags & DIRTY_VECTORS) == 0)
+	{
+		return;
+	}
+
 	glm::vec3 front;
 	front.x = glm::cos(glm::radians(m_yaw)) * glm::cos(glm::radians(m_pitch));
 	front.y = glm::sin(glm::radians(m_pitch));
@@ -85,17 +175,39 @@ void core::Camera::update_vectors()
 	m_front = normalize(front);
 	m_right = normalize(cross(front, m_world_up));
 	m_up = normalize(cross(m_right, front));
+
+	m_dirty_flags &= ~DIRTY_VECTORS;
 }
 
-glm::mat4 core::Camera::get_view_matrix() const
+void core::Camera::update_matrices() const
 {
-	using LookAtFunc = glm::mat4 (*)(
-	    const glm::vec3& position, const glm::vec3& target, const glm::vec3& world_up);
+	if (m_dirty_flags == 0)
+	{
+		return;
+	}
 
-	LookAtFunc look_at_func = m_use_custom_look_at ? &custom_look_at_matrix :
-	                                                 &glm::lookAt<float, glm::defaultp>;
+	update_vectors();
 
-	return look_at_func(m_position, m_position + m_front, m_up);
+	if ((m_dirty_flags & DIRTY_VIEW) != 0)
+	{
+		const glm::vec3& eye = m_render_position;
+		m_view = m_use_custom_look_at ? custom_look_at_matrix(eye, eye + m_front, m_up)
+		                              : glm::lookAt(eye, eye + m_front, m_up);
+		m_inverse_view = glm::affineInverse(m_view);
+	}
+
+	if ((m_dirty_flags & DIRTY_PROJECTION) != 0)
+	{
+		m_projection =
+		    glm::perspective(glm::radians(m_zoom), m_aspect_ratio, NEAR_PLANE, FAR_PLANE);
+		m_inverse_projection = glm::inverse(m_projection);
+	}
+
+	m_view_projection = m_projection * m_view;
+	m_inverse_view_projection = m_inverse_view * m_inverse_projection;
+	m_frustum = extract_frustum(m_view_projection);
+
+	m_dirty_flags = 0;
 }
 
 void core::Camera::on_mouse_movement(f32 x_offset, f32 y_offset, b8 constrain_pitch)
@@ -109,71 +221,112 @@ void core::Camera::on_mouse_movement(f32 x_offset, f32 y_offset, b8 constrain_pi
 		m_pitch = std::clamp(m_pitch, -89.0f, 89.0f);
 	}
 
-	update_vectors();
+	// the vectors are computed once before their next use, not for every motion event
+	mark_dirty(DIRTY_VECTORS | DIRTY_VIEW);
 }
 
 void core::Camera::on_mouse_wheel_scroll(f32 mouse_wheel_direction)
 {
 	m_zoom -= ZOOM_SPEED * mouse_wheel_direction;
 	m_zoom = std::clamp(m_zoom, 1.0f, 45.0f);
+	mark_dirty(DIRTY_PROJECTION);
 }
 
 void core::Camera::handle_input(const EventHandler& handler)
 {
-	CameraMovement movement_direction = CameraMovement::NONE;
+	using input::Action;
+	using input::get_action_bit;
 
-	if (handler.is_key_pressed(SDLK_W))
+	static constexpr input::ActionMask MOVEMENT_ACTIONS =
+	    get_action_bit(Action::MOVE_FORWARD) | get_action_bit(Action::MOVE_BACKWARD) |
+	    get_action_bit(Action::MOVE_LEFT) | get_action_bit(Action::MOVE_RIGHT);
+
+	const input::ActionMask actions = handler.get_actions() & MOVEMENT_ACTIONS;
+	if (actions == 0)
 	{
-		movement_direction = CameraMovement::FORWARD;
+		m_move_direction = glm::vec3{ 0.0f };
+		return;
 	}
-	if (handler.is_key_pressed(SDLK_S))
+
+	update_vectors();
+
+	// opposite directions cancel out, diagonals move at the same speed
+	glm::vec3 direction{ 0.0f };
+	if ((actions & get_action_bit(Action::MOVE_FORWARD)) != 0)
 	{
-		movement_direction = CameraMovement::BACKWARD;
+		direction += m_front;
 	}
-	if (handler.is_key_pressed(SDLK_A))
+	if ((actions & get_action_bit(Action::MOVE_BACKWARD)) != 0)
 	{
-		movement_direction = CameraMovement::LEFT;
+		direction -= m_front;
 	}
-	if (handler.is_key_pressed(SDLK_D))
+	if ((actions & get_action_bit(Action::MOVE_LEFT)) != 0)
 	{
-		movement_direction = CameraMovement::RIGHT;
+		direction -= m_right;
+	}
+	if ((actions & get_action_bit(Action::MOVE_RIGHT)) != 0)
+	{
+		direction += m_right;
 	}
 
-	f32 current_y_pos = m_position.y;
+	m_move_direction =
+	    glm::dot(direction, direction) < 1e-6f ? glm::vec3{ 0.0f } : glm::normalize(direction);
+}
+
+void core::Camera::fixed_update(f32 tick_seconds)
+{
+	m_previous_position = m_position;
 
-	f32 velocity = m_movement_speed * timing::get_delta_time();
-	switch (movement_direction)
-	{
-	case CameraMovement::FORWARD:
-		m_position += m_front * velocity;
-		break;
-	case CameraMovement::BACKWARD:
-		m_position -= m_front * velocity;
-		break;
-	case CameraMovement::LEFT:
-		m_position -= m_right * velocity;
-		break;
-	case CameraMovement::RIGHT:
-		m_position += m_right * velocity;
-		break;
-	default:
-		break;
+	if (m_move_direction == glm::vec3{ 0.0f })
+	{
+		return;
 	}
 
+	f32 current_y_pos = m_position.y;
+
+	f32 velocity = m_movement_speed * tick_seconds;
+	m_position += m_move_direction * velocity;
+
 	if (m_fps_mode)
 	{
 		m_position.y = current_y_pos;
 	}
 }
 
+void core::Camera::interpolate(f32 interpolation)
+{
+	// handle_input is skipped while the dev UI has the mouse, the camera must not keep going
+	m_move_direction = glm::vec3{ 0.0f };
+
+	const glm::vec3 position = glm::mix(m_previous_position, m_position, interpolation);
+	if (position != m_render_position)
+	{
+		m_render_position = position;
+		mark_dirty(DIRTY_VIEW);
+	}
+}
+
 void core::Camera::prepare_dev_ui()
 {
 	if (ImGui::CollapsingHeader("Camera"))
 	{
-		ImGui::SliderFloat("FOV", &m_zoom, 10.0f, 120.0f, "%.0f deg");
+		if (ImGui::SliderFloat("FOV", &m_zoom, 10.0f, 120.0f, "%.0f deg"))
+		{
+			mark_dirty(DIRTY_PROJECTION);
+		}
 		ImGui::SliderFloat("Camera Speed", &m_movement_speed, 1.0f, 100.0f);
-		ImGui::InputFloat3("Camera Position", glm::value_ptr(m_position));
-		ImGui::Checkbox("Custom look at matrix", &m_use_custom_look_at);
+		if (ImGui::InputFloat3("Camera Position", glm::value_ptr(m_position)))
+		{
+			// a teleport, not a movement to interpolate
+			m_previous_position = m_position;
+			m_render_position = m_position;
+			mark_dirty(DIRTY_VIEW);
+		}
+		if (ImGui::Checkbox("Custom look at matrix", &m_use_custom_look_at))
+		{
+			mark_dirty(DIRTY_VIEW);
+		}
 		ImGui::Checkbox("FPS mode (lock XZ plane)", &m_fps_mode);
+		ImGui::Text("Version %llu", static_cast<unsigned long long>(m_version));
 	}
 }
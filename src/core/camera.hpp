@@ -4,10 +4,31 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
+
 namespace core
 {
 	class EventHandler;
 
+	/** Planes pointing inward, `dot(plane, (point, 1)) >= 0` inside, xyz normalized. */
+	struct Frustum
+	{
+		enum Plane : u8
+		{
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		std::array<glm::vec4, PLANE_COUNT> planes{};
+
+		[[nodiscard]] b8 intersects_sphere(const glm::vec3& center, f32 radius) const;
+	};
+
 	class Camera
 	{
 	public:
@@ -18,17 +39,53 @@ namespace core
 		    glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), f32 yaw = YAW_DEFAULT,
 		    f32 pitch = PITCH_DEFAULT);
 
-		glm::mat4 get_view_matrix() const;
-		void      on_mouse_movement(f32 x_offset, f32 y_offset, b8 constrain_pitch = true);
-		void      on_mouse_wheel_scroll(f32 mouse_wheel_direction);
-		void      handle_input(const EventHandler& handler);
-		void      prepare_dev_ui();
+		void on_mouse_movement(f32 x_offset, f32 y_offset, b8 constrain_pitch = true);
+		void on_mouse_wheel_scroll(f32 mouse_wheel_direction);
+		/** Reads the movement of the frame, applied by the fixed updates that follow. */
+		void handle_input(const EventHandler& handler);
+
+		/** Moves by one simulation tick. */
+		void fixed_update(f32 tick_seconds);
+
+		/** Renders the position between the last two ticks and ends the frame's movement. */
+		void interpolate(f32 interpolation);
+
+		void prepare_dev_ui();
+
+		/** Width over height of the viewport, invalid ratios (e.g. a minimized window) are
+		 *  ignored. */
+		void set_aspect_ratio(f32 aspect_ratio);
 
-		f32 get_zoom() const
+		/*
+		 * The matrices and the frustum are recomputed on first access after the position, the
+		 * orientation, the FOV or the aspect ratio changed. The references stay valid, their
+		 * values until the next change.
+		 */
+
+		[[nodiscard]] const glm::mat4& get_view_matrix() const;
+		[[nodiscard]] const glm::mat4& get_projection_matrix() const;
+		[[nodiscard]] const glm::mat4& get_view_projection_matrix() const;
+		[[nodiscard]] const glm::mat4& get_inverse_view_matrix() const;
+		[[nodiscard]] const glm::mat4& get_inverse_projection_matrix() const;
+		[[nodiscard]] const glm::mat4& get_inverse_view_projection_matrix() const;
+		[[nodiscard]] const Frustum&   get_frustum() const;
+
+		/** Incremented on every change, caches depending on the camera compare it to skip work. */
+		[[nodiscard]] u64 get_version() const
+		{
+			return m_version;
+		}
+
+		[[nodiscard]] f32 get_zoom() const
 		{
 			return m_zoom;
 		}
 
+		[[nodiscard]] f32 get_aspect_ratio() const
+		{
+			return m_aspect_ratio;
+		}
+
 	private:
 		static constexpr f32 YAW_DEFAULT = -90.0f;
 		static constexpr f32 PITCH_DEFAULT = 0.0f;
@@ -36,24 +93,50 @@ namespace core
 		static constexpr f32 SENSITIVITY_DEFAULT = 0.1f;
 		static constexpr f32 ZOOM_DEFAULT = 45.0f;
 		static constexpr f32 ZOOM_SPEED = 1.0f;
+		static constexpr f32 NEAR_PLANE = 0.1f;
+		static constexpr f32 FAR_PLANE = 100.0f;
+
+		enum DirtyFlags : u8
+		{
+			DIRTY_VECTORS = 1 << 0,
+			DIRTY_VIEW = 1 << 1,
+			DIRTY_PROJECTION = 1 << 2,
+		};
 
 		// camera Attributes
-		glm::vec3 m_position;
-		glm::vec3 m_front;
-		glm::vec3 m_up{};
-		glm::vec3 m_right{};
-		glm::vec3 m_world_up;
+		glm::vec3         m_position;
+		glm::vec3         m_previous_position;  // at the tick before
+		glm::vec3         m_render_position;  // the view matrix is built from it
+		glm::vec3         m_move_direction{ 0.0f };  // normalized, zero when not moving
+		mutable glm::vec3 m_front;  // front, up and right follow yaw and pitch lazily
+		mutable glm::vec3 m_up{};
+		mutable glm::vec3 m_right{};
+		glm::vec3         m_world_up;
 		// euler Angles
-		f32       m_yaw;
-		f32       m_pitch;
+		f32               m_yaw;
+		f32               m_pitch;
 		// camera options
-		f32       m_movement_speed;
-		f32       m_mouse_sensitivity;
-		f32       m_zoom;
-		b8        m_fps_mode;
-		b8        m_use_custom_look_at;
+		f32               m_movement_speed;
+		f32               m_mouse_sensitivity;
+		f32               m_zoom;
+		f32               m_aspect_ratio = 16.0f / 9.0f;
+		b8                m_fps_mode;
+		b8                m_use_custom_look_at;
+
+		// cached, recomputed by update_matrices
+		mutable glm::mat4 m_view{ 1.0f };
+		mutable glm::mat4 m_projection{ 1.0f };
+		mutable glm::mat4 m_view_projection{ 1.0f };
+		mutable glm::mat4 m_inverse_view{ 1.0f };
+		mutable glm::mat4 m_inverse_projection{ 1.0f };
+		mutable glm::mat4 m_inverse_view_projection{ 1.0f };
+		mutable Frustum   m_frustum;
+		mutable u8        m_dirty_flags = DIRTY_VECTORS | DIRTY_VIEW | DIRTY_PROJECTION;
+		u64               m_version = 1;
 
-		void update_vectors();
+		void mark_dirty(u8 flags);
+		void update_vectors() const;
+		void update_matrices() const;
 	};
 
 }  // namespace core
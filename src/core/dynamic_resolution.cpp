@@ -0,0 +1,252 @@
+#include "core/dynamic_resolution.hpp"
+
+#include "core/gpu_profiler.hpp"
+#include "core/render_target_pool.hpp"
+
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	using namespace core;
+
+	// a frame is resolved QUERY_FRAMES - 1 frames later at the earliest, its scale must remain
+	static_assert(DynamicResolution::SCALE_HISTORY_SIZE > GpuProfiler::QUERY_FRAMES);
+
+	static constexpr std::array<const char*, static_cast<u32>(UpscaleFilter::COUNT)>
+	    UPSCALE_FILTER_NAMES = {
+		    "Bilinear",
+		    "Sharpen",
+	    };
+
+	static const char* get_upscale_filter_name(UpscaleFilter upscale_filter)
+	{
+		return upscale_filter < UpscaleFilter::COUNT
+		           ? UPSCALE_FILTER_NAMES[static_cast<u32>(upscale_filter)]
+		           : "Unknown";
+	}
+
+	static f32 quantize_down(f32 scale)
+	{
+		return std::floor(scale / DynamicResolution::SCALE_STEP + 0.001f) *
+		       DynamicResolution::SCALE_STEP;
+	}
+}  // namespace
+
+core::DynamicResolution::DynamicResolution(const Config& config)
+    : m_is_enabled{ config.is_enabled }
+    , m_min_scale{ RenderTargetPool::MIN_RESOLUTION_SCALE }
+    , m_max_scale{ 1.0f }
+    , m_gpu_budget_ms{ 0.0f }
+    , m_upscale_filter{ UpscaleFilter::BILINEAR }
+    , m_sharpness{ 0.0f }
+    , m_measured_scope{ config.measured_scope }
+{
+	set_scale_bounds(config.min_scale, config.max_scale);
+	set_gpu_budget_ms(config.gpu_budget_ms);
+	set_upscale_filter(config.upscale_filter);
+	set_sharpness(config.sharpness);
+	m_scale = m_max_scale.load(std::memory_order_relaxed);
+}
+
+f32 core::DynamicResolution::update(f32 manual_scale, const GpuProfiler& gpu_profiler)
+{
+	ZoneScopedN("Dynamic resolution");
+
+	if (const GpuFrameTimings* timings = gpu_profiler.get_resolved_frame())
+	{
+		if (const GpuScopeTiming* scope = timings->find(m_measured_scope))
+		{
+			apply_measurement(
+			    scope->ms, m_scale_history[timings->frame_index % SCALE_HISTORY_SIZE]);
+		}
+	}
+
+	const f32 min_scale = m_min_scale.load(std::memory_order_relaxed);
+	const f32 max_scale = m_max_scale.load(std::memory_order_relaxed);
+	if (!m_is_enabled.load(std::memory_order_relaxed))
+	{
+		m_scale = std::clamp(
+		    manual_scale, RenderTargetPool::MIN_RESOLUTION_SCALE,
+		    RenderTargetPool::MAX_RESOLUTION_SCALE);
+		m_frames_under_budget = 0;
+	}
+	else
+	{
+		// the bounds may have moved since the last frame
+		m_scale = std::clamp(m_scale, min_scale, max_scale);
+	}
+
+	m_scale_history[gpu_profiler.get_frame_index() % SCALE_HISTORY_SIZE] = m_scale;
+	m_stat_scale.store(m_scale, std::memory_order_relaxed);
+	return m_scale;
+}
+
+f32 core::DynamicResolution::get_sharpness() const
+{
+	return m_upscale_filter.load(std::memory_order_relaxed) == UpscaleFilter::SHARPEN
+	           ? m_sharpness.load(std::memory_order_relaxed)
+	           : 0.0f;
+}
+
+void core::DynamicResolution::set_enabled(b8 is_enabled)
+{
+	m_is_enabled.store(is_enabled, std::memory_order_relaxed);
+}
+
+void core::DynamicResolution::set_scale_bounds(f32 min_scale, f32 max_scale)
+{
+	const f32 clamped_min = std::clamp(
+	    min_scale, RenderTargetPool::MIN_RESOLUTION_SCALE, RenderTargetPool::MAX_RESOLUTION_SCALE);
+	const f32 clamped_max =
+	    std::clamp(max_scale, clamped_min, RenderTargetPool::MAX_RESOLUTION_SCALE);
+	if (clamped_min != min_scale || clamped_max != max_scale)
+	{
+		SPDLOG_WARN(
+		    "Resolution scale bounds [{}, {}] outside of [{}, {}], clamped to [{}, {}].",
+		    min_scale, max_scale, RenderTargetPool::MIN_RESOLUTION_SCALE,
+		    RenderTargetPool::MAX_RESOLUTION_SCALE, clamped_min, clamped_max);
+	}
+
+	m_min_scale.store(clamped_min, std::memory_order_relaxed);
+	m_max_scale.store(clamped_max, std::memory_order_relaxed);
+}
+
+void core::DynamicResolution::set_gpu_budget_ms(f32 gpu_budget_ms)
+{
+	if (gpu_budget_ms < MIN_GPU_BUDGET_MS || gpu_budget_ms > MAX_GPU_BUDGET_MS)
+	{
+		SPDLOG_WARN(
+		    "GPU budget of {} ms outside of [{}, {}], clamped.", gpu_budget_ms, MIN_GPU_BUDGET_MS,
+		    MAX_GPU_BUDGET_MS);
+		gpu_budget_ms = std::clamp(gpu_budget_ms, MIN_GPU_BUDGET_MS, MAX_GPU_BUDGET_MS);
+	}
+
+	m_gpu_budget_ms.store(gpu_budget_ms, std::memory_order_relaxed);
+}
+
+void core::DynamicResolution::set_upscale_filter(UpscaleFilter upscale_filter)
+{
+	if (upscale_filter >= UpscaleFilter::COUNT)
+	{
+		SPDLOG_WARN("Unknown upscale filter, bilinear instead.");
+		upscale_filter = UpscaleFilter::BILINEAR;
+	}
+
+	m_upscale_filter.store(upscale_filter, std::memory_order_relaxed);
+}
+
+void core::DynamicResolution::set_sharpness(f32 sharpness)
+{
+	if (sharpness < 0.0f || sharpness > 1.0f)
+	{
+		SPDLOG_WARN("Sharpness of {} outside of [0, 1], clamped.", sharpness);
+		sharpness = std::clamp(sharpness, 0.0f, 1.0f);
+	}
+
+	m_sharpness.store(sharpness, std::memory_order_relaxed);
+}
+
+void core::DynamicResolution::prepare_dev_ui()
+{
+	ZoneScopedN("Dynamic resolution prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Dynamic resolution"))
+	{
+		b8 is_enabled = m_is_enabled.load(std::memory_order_relaxed);
+		if (ImGui::Checkbox("Enabled", &is_enabled))
+		{
+			set_enabled(is_enabled);
+		}
+
+		f32 min_scale = m_min_scale.load(std::memory_order_relaxed);
+		f32 max_scale = m_max_scale.load(std::memory_order_relaxed);
+		if (ImGui::DragFloatRange2(
+		        "Scale bounds", &min_scale, &max_scale, 0.01f,
+		        RenderTargetPool::MIN_RESOLUTION_SCALE, RenderTargetPool::MAX_RESOLUTION_SCALE,
+		        "%.2f"))
+		{
+			set_scale_bounds(min_scale, max_scale);
+		}
+
+		f32 gpu_budget_ms = m_gpu_budget_ms.load(std::memory_order_relaxed);
+		if (ImGui::SliderFloat(
+		        "GPU budget", &gpu_budget_ms, MIN_GPU_BUDGET_MS, 33.3f, "%.1f ms"))
+		{
+			set_gpu_budget_ms(gpu_budget_ms);
+		}
+
+		const UpscaleFilter upscale_filter = m_upscale_filter.load(std::memory_order_relaxed);
+		if (ImGui::BeginCombo("Upscale filter", get_upscale_filter_name(upscale_filter)))
+		{
+			for (u32 i = 0; i < UPSCALE_FILTER_NAMES.size(); ++i)
+			{
+				const auto filter = static_cast<UpscaleFilter>(i);
+				if (ImGui::Selectable(UPSCALE_FILTER_NAMES[i], filter == upscale_filter))
+				{
+					set_upscale_filter(filter);
+				}
+			}
+			ImGui::EndCombo();
+		}
+
+		if (upscale_filter == UpscaleFilter::SHARPEN)
+		{
+			f32 sharpness = m_sharpness.load(std::memory_order_relaxed);
+			if (ImGui::SliderFloat("Sharpness", &sharpness, 0.0f, 1.0f, "%.2f"))
+			{
+				set_sharpness(sharpness);
+			}
+		}
+
+		ImGui::Text("Scale: %.0f%%", m_stat_scale.load(std::memory_order_relaxed) * 100.0f);
+		ImGui::Text("GPU time: %.2f ms", m_stat_gpu_ms.load(std::memory_order_relaxed));
+		ImGui::Text(
+		    "Lowered: %llu times",
+		    static_cast<unsigned long long>(m_stat_lowered_count.load(std::memory_order_relaxed)));
+	}
+}
+
+void core::DynamicResolution::apply_measurement(f32 gpu_ms, f32 measured_scale)
+{
+	m_stat_gpu_ms.store(gpu_ms, std::memory_order_relaxed);
+	TracyPlot("Dynamic resolution GPU ms", gpu_ms);
+
+	// measured before the last change, or while disabled
+	if (!m_is_enabled.load(std::memory_order_relaxed) || measured_scale != m_scale)
+	{
+		return;
+	}
+
+	const f32 min_scale = m_min_scale.load(std::memory_order_relaxed);
+	const f32 max_scale = m_max_scale.load(std::memory_order_relaxed);
+	const f32 budget_ms = m_gpu_budget_ms.load(std::memory_order_relaxed);
+
+	if (gpu_ms > budget_ms)
+	{
+		// the cost follows the pixel count, the square of the scale
+		const f32 scale = quantize_down(m_scale * std::sqrt(budget_ms / gpu_ms));
+		m_frames_under_budget = 0;
+		if (scale < m_scale && m_scale > min_scale)
+		{
+			m_scale = std::max(scale, min_scale);
+			m_stat_lowered_count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	else if (gpu_ms < budget_ms * RAISE_THRESHOLD && m_scale < max_scale)
+	{
+		if (++m_frames_under_budget >= RAISE_DELAY_FRAMES)
+		{
+			m_scale = std::min(quantize_down(m_scale) + SCALE_STEP, max_scale);
+			m_frames_under_budget = 0;
+		}
+	}
+	else
+	{
+		m_frames_under_budget = 0;
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+
+/**
+ * Dynamic resolution: the scene renders offscreen at a scale of the window
+ * that follows the GPU time of the frame, so the frame rate holds when the
+ * scene gets heavy instead of frames being dropped. The upscale pass stretches
+ * it to the window (bilinear, or sharpened to hide the blur) before the dev UI
+ * is drawn at the native resolution.
+ *
+ * The GPU time is that of a scope of the GpuProfiler, read back frames later
+ * without the render thread ever waiting for it. The controller
+ * - lowers the scale as soon as a frame is over budget, by the square root of
+ *   the excess since the cost follows the pixel count,
+ * - raises it a step at a time, after frames well under budget,
+ * - only trusts the frames measured at the current scale, the frames still in
+ *   flight after a change do not move it twice.
+ * The scale is quantized to SCALE_STEP: the render target pool keeps a handful
+ * of sizes instead of one per frame.
+ */
+namespace core
+{
+	class GpuProfiler;
+
+	enum class UpscaleFilter : u8
+	{
+		BILINEAR,
+		SHARPEN,
+		COUNT
+	};
+
+	class DynamicResolution
+	{
+	public:
+		struct Config
+		{
+			b8            is_enabled = true;
+			f32           min_scale = 0.5f;
+			f32           max_scale = 1.0f;
+			f32           gpu_budget_ms = 12.0f;  // of the measured scope, not the whole frame
+			const char*   measured_scope = "Frame graph";  // scene and upscale, not the UI
+			UpscaleFilter upscale_filter = UpscaleFilter::SHARPEN;
+			f32           sharpness = 0.5f;
+		};
+
+		// scales of the frames not resolved yet by the GPU profiler
+		static constexpr u32 SCALE_HISTORY_SIZE = 8;
+		static constexpr f32 SCALE_STEP = 0.05f;
+		static constexpr f32 MIN_GPU_BUDGET_MS = 1.0f;
+		static constexpr f32 MAX_GPU_BUDGET_MS = 100.0f;
+
+		// under budget by that much for that many measured frames before a step up
+		static constexpr f32 RAISE_THRESHOLD = 0.8f;
+		static constexpr u32 RAISE_DELAY_FRAMES = 30;
+
+		explicit DynamicResolution(const Config& config);
+
+		DynamicResolution(const DynamicResolution& other) = delete;
+		DynamicResolution& operator=(const DynamicResolution& other) = delete;
+		DynamicResolution(DynamicResolution&& other) noexcept = delete;
+		DynamicResolution& operator=(DynamicResolution&& other) noexcept = delete;
+
+		/**
+		 * Render thread, after the profiler began the frame: steers by the frame it resolved
+		 * and returns the scale of this frame, `manual_scale` while disabled.
+		 */
+		[[nodiscard]] f32 update(f32 manual_scale, const GpuProfiler& gpu_profiler);
+
+		/** Render thread, 0 for a plain bilinear upscale. */
+		[[nodiscard]] f32 get_sharpness() const;
+
+		void set_enabled(b8 is_enabled);
+		void set_scale_bounds(f32 min_scale, f32 max_scale);
+		void set_gpu_budget_ms(f32 gpu_budget_ms);
+		void set_upscale_filter(UpscaleFilter upscale_filter);
+		void set_sharpness(f32 sharpness);
+
+		/** Main thread. */
+		void prepare_dev_ui();
+
+	private:
+		void apply_measurement(f32 gpu_ms, f32 measured_scale);
+
+		// written by the main thread, read by the render thread
+		std::atomic<b8>            m_is_enabled;
+		std::atomic<f32>           m_min_scale;
+		std::atomic<f32>           m_max_scale;
+		std::atomic<f32>           m_gpu_budget_ms;
+		std::atomic<UpscaleFilter> m_upscale_filter;
+		std::atomic<f32>           m_sharpness;
+
+		const char* m_measured_scope;
+
+		// render thread
+		std::array<f32, SCALE_HISTORY_SIZE> m_scale_history{};  // by frame index
+		f32                                 m_scale = 1.0f;
+		u32                                 m_frames_under_budget = 0;
+
+		// read by the dev UI
+		std::atomic<f32> m_stat_gpu_ms = 0.0f;
+		std::atomic<f32> m_stat_scale = 1.0f;
+		std::atomic<u64> m_stat_lowered_count = 0;
+	};
+}  // namespace core
@@ -0,0 +1,397 @@
+#include "core/ecs.hpp"
+
+#include "utils/assertions.hpp"
+
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <new>
+
+namespace
+{
+	using namespace core;
+	using ComponentMask = ecs::ComponentMask;
+
+	struct ComponentInfo
+	{
+		u32 size = 0;
+		u32 alignment = 0;
+	};
+
+	static std::atomic<ecs::ComponentId>                  g_component_count = 0;
+	static std::array<ComponentInfo, ecs::MAX_COMPONENTS> g_components;
+
+	static constexpr std::align_val_t CHUNK_ALIGNMENT{ 64 };
+
+	static u32 align_up(u32 value, u32 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	static void build_layout(ecs::Archetype* archetype)
+	{
+		ComponentMask remaining = archetype->mask;
+		u32           bytes_per_entity = sizeof(ecs::Entity);
+		u32           padding = 0;
+
+		archetype->column_by_id.fill(ecs::Archetype::NO_COLUMN);
+
+		// columns sorted by component id, the same set always gives the same layout
+		while (remaining != 0)
+		{
+			const auto id = static_cast<ecs::ComponentId>(std::countr_zero(remaining));
+			remaining &= remaining - 1;
+
+			const u32 column = archetype->component_count++;
+			archetype->components[column] = id;
+			archetype->sizes[column] = g_components[id].size;
+			archetype->column_by_id[id] = static_cast<u8>(column);
+
+			bytes_per_entity += g_components[id].size;
+			padding += g_components[id].alignment;
+		}
+
+		archetype->chunk_capacity = (ecs::CHUNK_SIZE - padding) / bytes_per_entity;
+
+		u32 offset = archetype->chunk_capacity * sizeof(ecs::Entity);
+		for (u32 column = 0; column < archetype->component_count; ++column)
+		{
+			const ComponentInfo& info = g_components[archetype->components[column]];
+			offset = align_up(offset, info.alignment);
+			archetype->offsets[column] = offset;
+			offset += archetype->chunk_capacity * info.size;
+		}
+
+		CHECK_MSG(offset <= ecs::CHUNK_SIZE, "Archetype layout doesn't fit in a chunk.");
+	}
+
+}  // namespace
+
+core::ecs::ComponentId core::ecs::detail::register_component(u32 size, u32 alignment)
+{
+	const ComponentId id = g_component_count.fetch_add(1, std::memory_order_relaxed);
+	CHECK_MSG(id < MAX_COMPONENTS, "Too many component types.");
+	CHECK_MSG(alignment <= 64, "Components can't be aligned on more than 64 bytes.");
+
+	g_components[id] = { size, alignment };
+	return id;
+}
+
+core::ecs::World::World()
+{
+	// the archetype without components, for entities created empty
+	get_or_create_archetype(0);
+}
+
+core::ecs::World::~World()
+{
+	for (Archetype& archetype : m_archetypes)
+	{
+		for (Chunk& chunk : archetype.chunks)
+		{
+			::operator delete(chunk.data, CHUNK_ALIGNMENT);
+		}
+	}
+}
+
+void core::ecs::World::destroy_entity(Entity entity)
+{
+	if (!is_alive(entity))
+	{
+		return;
+	}
+
+	EntityRecord& record = m_entities[entity.index];
+	release_row(record);
+
+	++record.generation;
+	record.is_alive = false;
+	record.next_free = m_first_free;
+	m_first_free = entity.index;
+	--m_alive_count;
+}
+
+b8 core::ecs::World::is_alive(Entity entity) const
+{
+	return entity.index < m_entities.size() && m_entities[entity.index].is_alive &&
+	       m_entities[entity.index].generation == entity.generation;
+}
+
+core::ecs::Entity core::ecs::World::create_entity_with_mask(ComponentMask mask)
+{
+	u32 index = m_first_free;
+	if (index != Entity::INVALID_INDEX)
+	{
+		m_first_free = m_entities[index].next_free;
+	}
+	else
+	{
+		index = static_cast<u32>(m_entities.size());
+		m_entities.emplace_back();
+	}
+
+	EntityRecord& record = m_entities[index];
+	record.is_alive = true;
+	record.next_free = Entity::INVALID_INDEX;
+	++m_alive_count;
+
+	const Entity entity{ index, record.generation };
+	allocate_row(get_or_create_archetype(mask), entity, &record);
+	return entity;
+}
+
+core::ecs::ComponentMask core::ecs::World::get_entity_mask(Entity entity) const
+{
+	if (!is_alive(entity))
+	{
+		return 0;
+	}
+	return m_archetypes[m_entities[entity.index].archetype].mask;
+}
+
+void core::ecs::World::change_archetype(Entity entity, ComponentMask new_mask)
+{
+	if (!is_alive(entity))
+	{
+		SPDLOG_ERROR("Changing the components of a dead entity.");
+		return;
+	}
+
+	EntityRecord& record = m_entities[entity.index];
+	if (m_archetypes[record.archetype].mask == new_mask)
+	{
+		return;
+	}
+
+	const u32          new_archetype_index = get_or_create_archetype(new_mask);
+	const EntityRecord old_record = record;
+
+	allocate_row(new_archetype_index, entity, &record);
+
+	// copy the components both archetypes have, the old row is then released
+	const Archetype& old_archetype = m_archetypes[old_record.archetype];
+	const Archetype& new_archetype = m_archetypes[new_archetype_index];
+	const Chunk&     old_chunk = old_archetype.chunks[old_record.chunk];
+	const Chunk&     new_chunk = new_archetype.chunks[record.chunk];
+
+	for (u32 column = 0; column < old_archetype.component_count; ++column)
+	{
+		const u8 new_column = new_archetype.column_by_id[old_archetype.components[column]];
+		if (new_column == Archetype::NO_COLUMN)
+		{
+			continue;
+		}
+
+		const u32 size = old_archetype.sizes[column];
+		std::memcpy(
+		    new_chunk.data + new_archetype.offsets[new_column] + record.row * size,
+		    old_chunk.data + old_archetype.offsets[column] + old_record.row * size, size);
+	}
+
+	release_row(old_record);
+}
+
+void* core::ecs::World::get_component_bytes(Entity entity, ComponentId id, b8 is_write)
+{
+	if (!is_alive(entity))
+	{
+		return nullptr;
+	}
+
+	const EntityRecord& record = m_entities[entity.index];
+	Archetype&          archetype = m_archetypes[record.archetype];
+	const u8            column = archetype.column_by_id[id];
+
+	if (column == Archetype::NO_COLUMN)
+	{
+		return nullptr;
+	}
+
+	Chunk& chunk = archetype.chunks[record.chunk];
+	if (is_write)
+	{
+		chunk.versions[column] = m_version;
+	}
+
+	return chunk.data + archetype.offsets[column] + record.row * archetype.sizes[column];
+}
+
+void core::ecs::World::set_component_bytes(Entity entity, ComponentId id, const void* bytes)
+{
+	if (void* destination = get_component_bytes(entity, id, true))
+	{
+		std::memcpy(destination, bytes, g_components[id].size);
+	}
+}
+
+u32 core::ecs::World::get_or_create_archetype(ComponentMask mask)
+{
+	if (auto it = m_archetype_by_mask.find(mask); it != m_archetype_by_mask.end())
+	{
+		return it->second;
+	}
+
+	CHECK_MSG(
+	    std::popcount(mask) <= static_cast<i32>(MAX_ARCHETYPE_COMPONENTS),
+	    "Too many components in an archetype.");
+
+	const auto index = static_cast<u32>(m_archetypes.size());
+	Archetype& archetype = m_archetypes.emplace_back();
+	archetype.mask = mask;
+	build_layout(&archetype);
+
+	m_archetype_by_mask.emplace(mask, index);
+	return index;
+}
+
+void core::ecs::World::allocate_row(u32 archetype_index, Entity entity, EntityRecord* record)
+{
+	Archetype& archetype = m_archetypes[archetype_index];
+
+	if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.chunk_capacity)
+	{
+		Chunk& chunk = archetype.chunks.emplace_back();
+		chunk.data = static_cast<std::byte*>(::operator new(CHUNK_SIZE, CHUNK_ALIGNMENT));
+	}
+
+	Chunk&    chunk = archetype.chunks.back();
+	const u32 row = chunk.count++;
+	++archetype.entity_count;
+
+	reinterpret_cast<Entity*>(chunk.data)[row] = entity;
+
+	// a new entity counts as a change of all its components
+	for (u32 column = 0; column < archetype.component_count; ++column)
+	{
+		chunk.versions[column] = m_version;
+	}
+
+	record->archetype = archetype_index;
+	record->chunk = static_cast<u32>(archetype.chunks.size()) - 1;
+	record->row = row;
+}
+
+void core::ecs::World::release_row(const EntityRecord& record)
+{
+	Archetype& archetype = m_archetypes[record.archetype];
+	Chunk&     chunk = archetype.chunks[record.chunk];
+	Chunk&     last_chunk = archetype.chunks.back();
+	const u32  last_row = last_chunk.count - 1;
+
+	// the last entity of the archetype fills the hole, chunks stay packed
+	if (&chunk != &last_chunk || record.row != last_row)
+	{
+		const Entity moved = reinterpret_cast<Entity*>(last_chunk.data)[last_row];
+		reinterpret_cast<Entity*>(chunk.data)[record.row] = moved;
+
+		for (u32 column = 0; column < archetype.component_count; ++column)
+		{
+			const u32 size = archetype.sizes[column];
+			const u32 offset = archetype.offsets[column];
+			std::memcpy(
+			    chunk.data + offset + record.row * size, last_chunk.data + offset + last_row * size,
+			    size);
+			chunk.versions[column] = m_version;
+		}
+
+		EntityRecord& moved_record = m_entities[moved.index];
+		moved_record.chunk = record.chunk;
+		moved_record.row = record.row;
+	}
+
+	--last_chunk.count;
+	--archetype.entity_count;
+
+	if (last_chunk.count == 0)
+	{
+		::operator delete(last_chunk.data, CHUNK_ALIGNMENT);
+		archetype.chunks.pop_back();
+	}
+}
+
+void core::ecs::Schedule::add_system_with_access(
+    const char* name, ComponentMask reads, ComponentMask writes, SystemFn fn)
+{
+	const u32 index = static_cast<u32>(m_systems.size());
+
+	// joins the last batch unless it conflicts with one of its systems
+	b8 is_conflicting = m_batch_starts.empty();
+	for (u32 i = is_conflicting ? index : m_batch_starts.back(); i < index; ++i)
+	{
+		const System& other = m_systems[i];
+		if ((writes & other.reads) != 0 || (other.writes & reads) != 0)
+		{
+			is_conflicting = true;
+			break;
+		}
+	}
+
+	if (is_conflicting)
+	{
+		m_batch_starts.push_back(index);
+	}
+
+	System& system = m_systems.emplace_back();
+	system.name = name;
+	system.reads = reads;
+	system.writes = writes;
+	system.fn = std::move(fn);
+}
+
+void core::ecs::Schedule::run(World& world, f32 delta_time)
+{
+	ZoneScopedN("ECS systems");
+
+	for (u32 batch = 0; batch < m_batch_starts.size(); ++batch)
+	{
+		const u32 begin = m_batch_starts[batch];
+		const u32 end = batch + 1 < m_batch_starts.size() ? m_batch_starts[batch + 1]
+		                                                   : static_cast<u32>(m_systems.size());
+
+		// every batch writes with a new version, the next batches see its changes
+		world.advance_version();
+
+		auto run_system = [](void* data)
+		{
+			auto* system = static_cast<System*>(data);
+			ZoneScopedN("System");
+			ZoneName(system->name, std::strlen(system->name));
+			system->fn({ *system->world, system->last_run_version, system->delta_time });
+		};
+
+		for (u32 i = begin; i < end; ++i)
+		{
+			System& system = m_systems[i];
+			system.world = &world;
+			system.delta_time = delta_time;
+			system.job.function = run_system;
+			system.job.data = &system;
+		}
+
+		if (end - begin == 1)
+		{
+			run_system(&m_systems[begin]);
+		}
+		else
+		{
+			jobs::Counter counter;
+			for (u32 i = begin; i < end; ++i)
+			{
+				jobs::run(&m_systems[i].job, 1, &counter);
+			}
+			jobs::wait(counter);
+		}
+
+		for (u32 i = begin; i < end; ++i)
+		{
+			m_systems[i].last_run_version = world.get_version();
+		}
+	}
+
+	// the writes until the next run (outside systems, new entities) are newer than every
+	// last run version, the systems see them
+	world.advance_version();
+}
@@ -0,0 +1,523 @@
+#pragma once
+
+#include "core/jobs.hpp"
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Archetype based entity-component system. Entities with the same set of
+ * components share an archetype, which stores them in fixed-size chunks with one
+ * array per component (SoA): iterating a query is a linear walk over arrays.
+ *
+ * Components must be trivially copyable, moving an entity between archetypes
+ * (adding or removing a component) copies its bytes. Structural changes (create,
+ * destroy, add, remove) are not allowed while iterating or running systems.
+ *
+ * Change tracking is per chunk and per component: a query with write access
+ * stamps the chunks it visits with the world version, `changed_since` skips the
+ * chunks whose components were not written after a given version.
+ */
+namespace core::ecs
+{
+	static constexpr u32 MAX_COMPONENTS = 64;
+	static constexpr u32 MAX_ARCHETYPE_COMPONENTS = 16;
+	// fits the L2 cache, long enough runs per column for the hardware prefetcher
+	static constexpr u32 CHUNK_SIZE = 64 * 1024;
+
+	using ComponentId = u32;
+	using ComponentMask = u64;
+
+	struct Entity
+	{
+		static constexpr u32 INVALID_INDEX = std::numeric_limits<u32>::max();
+
+		u32 index = INVALID_INDEX;
+		u32 generation = 0;
+
+		b8 is_null() const
+		{
+			return index == INVALID_INDEX;
+		}
+
+		friend b8 operator==(const Entity& lhs, const Entity& rhs) = default;
+	};
+
+	namespace detail
+	{
+		ComponentId register_component(u32 size, u32 alignment);
+
+		template<typename Component>
+		ComponentId get_component_id()
+		{
+			static_assert(
+			    std::is_trivially_copyable_v<Component>, "Components must be trivially copyable.");
+
+			static const ComponentId id =
+			    register_component(sizeof(Component), alignof(Component));
+			return id;
+		}
+	}  // namespace detail
+
+	/** `T` and `const T` are the same component. */
+	template<typename T>
+	ComponentId get_component_id()
+	{
+		return detail::get_component_id<std::remove_const_t<T>>();
+	}
+
+	template<typename... Ts>
+	ComponentMask get_component_mask()
+	{
+		return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << get_component_id<Ts>()));
+	}
+
+	/** Only the mutable types of the list. */
+	template<typename... Ts>
+	ComponentMask get_write_mask()
+	{
+		return (ComponentMask{ 0 } | ... |
+		        (std::is_const_v<Ts> ? ComponentMask{ 0 }
+		                             : ComponentMask{ 1 } << get_component_id<Ts>()));
+	}
+
+	struct Chunk
+	{
+		std::byte* data = nullptr;
+		u32        count = 0;
+		// last world version each column was written at
+		std::array<u32, MAX_ARCHETYPE_COMPONENTS> versions{};
+	};
+
+	struct Archetype
+	{
+		static constexpr u8 NO_COLUMN = 0xff;
+
+		ComponentMask mask = 0;
+		u32           component_count = 0;
+		u32           chunk_capacity = 0;
+		u32           entity_count = 0;
+
+		std::array<ComponentId, MAX_ARCHETYPE_COMPONENTS> components{};
+		std::array<u32, MAX_ARCHETYPE_COMPONENTS>         offsets{};  // in a chunk, entities at 0
+		std::array<u32, MAX_ARCHETYPE_COMPONENTS>         sizes{};
+		std::array<u8, MAX_COMPONENTS>                    column_by_id{};
+
+		std::vector<Chunk> chunks;  // only the last one is partially filled
+
+		template<typename T>
+		std::remove_const_t<T>* get_column(const Chunk& chunk) const
+		{
+			const u8 column = column_by_id[get_component_id<T>()];
+			return reinterpret_cast<std::remove_const_t<T>*>(chunk.data + offsets[column]);
+		}
+
+		const Entity* get_entities(const Chunk& chunk) const
+		{
+			return reinterpret_cast<const Entity*>(chunk.data);
+		}
+	};
+
+	class World;
+
+	/**
+	 * Iterates the entities having every component of `Ts` (const ones are read
+	 * only, the others are marked as written), plus the optional filters.
+	 */
+	template<typename... Ts>
+	class Query
+	{
+	public:
+		explicit Query(World* world);
+
+		template<typename... Us>
+		Query& with()
+		{
+			m_required |= get_component_mask<Us...>();
+			return *this;
+		}
+
+		template<typename... Us>
+		Query& without()
+		{
+			m_excluded |= get_component_mask<Us...>();
+			return *this;
+		}
+
+		/** Keeps the chunks where one of `Us` was written after `version`. */
+		template<typename... Us>
+		Query& changed_since(u32 version)
+		{
+			m_changed |= get_component_mask<Us...>();
+			m_changed_version = version;
+			return *this;
+		}
+
+		/** `fn(count, entities, Ts* columns...)` for every matching chunk. */
+		template<typename Fn>
+		void for_each_chunk(Fn&& fn);
+
+		/** `fn(Ts&...)` or `fn(Entity, Ts&...)` for every matching entity. */
+		template<typename Fn>
+		void each(Fn&& fn);
+
+		/** Same as `each`, chunks are spread over the job system. */
+		template<typename Fn>
+		void parallel_each(Fn&& fn);
+
+		[[nodiscard]] u32 count();
+
+	private:
+		b8 matches(const Archetype& archetype) const
+		{
+			return (archetype.mask & m_required) == m_required && (archetype.mask & m_excluded) == 0;
+		}
+
+		b8 passes_change_filter(const Archetype& archetype, const Chunk& chunk) const;
+
+		template<typename Fn>
+		void run_chunk(Archetype& archetype, Chunk& chunk, Fn& fn) const;
+
+		World*        m_world;
+		ComponentMask m_required;
+		ComponentMask m_excluded = 0;
+		ComponentMask m_changed = 0;
+		u32           m_changed_version = 0;
+	};
+
+	class World
+	{
+	public:
+		World();
+		~World();
+
+		World(const World& other) = delete;
+		World& operator=(const World& other) = delete;
+		World(World&& other) noexcept = delete;
+		World& operator=(World&& other) noexcept = delete;
+
+		template<typename... Ts>
+		Entity create_entity(const Ts&... components)
+		{
+			const Entity entity = create_entity_with_mask(get_component_mask<Ts...>());
+			(set_component_bytes(entity, get_component_id<Ts>(), &components), ...);
+			return entity;
+		}
+
+		void destroy_entity(Entity entity);
+
+		[[nodiscard]] b8 is_alive(Entity entity) const;
+
+		template<typename T>
+		void add_component(Entity entity, const T& component)
+		{
+			const ComponentId id = get_component_id<T>();
+			change_archetype(entity, get_entity_mask(entity) | (ComponentMask{ 1 } << id));
+			set_component_bytes(entity, id, &component);
+		}
+
+		template<typename T>
+		void remove_component(Entity entity)
+		{
+			change_archetype(
+			    entity, get_entity_mask(entity) & ~(ComponentMask{ 1 } << get_component_id<T>()));
+		}
+
+		template<typename T>
+		[[nodiscard]] b8 has_component(Entity entity) const
+		{
+			return is_alive(entity) && (get_entity_mask(entity) & get_component_mask<T>()) != 0;
+		}
+
+		/** Marks the component as written, nullptr when the entity doesn't have it. */
+		template<typename T>
+		[[nodiscard]] T* get_component(Entity entity)
+		{
+			return static_cast<T*>(get_component_bytes(entity, get_component_id<T>(), true));
+		}
+
+		template<typename T>
+		[[nodiscard]] const T* read_component(Entity entity)
+		{
+			return static_cast<const T*>(get_component_bytes(entity, get_component_id<T>(), false));
+		}
+
+		template<typename... Ts>
+		[[nodiscard]] Query<Ts...> query()
+		{
+			return Query<Ts...>{ this };
+		}
+
+		/** Version stamped on the components written from now on. */
+		[[nodiscard]] u32 get_version() const
+		{
+			return m_version;
+		}
+
+		u32 advance_version()
+		{
+			return ++m_version;
+		}
+
+		[[nodiscard]] u32 get_entity_count() const
+		{
+			return m_alive_count;
+		}
+
+		[[nodiscard]] std::vector<Archetype>& get_archetypes()
+		{
+			return m_archetypes;
+		}
+
+	private:
+		struct EntityRecord
+		{
+			u32 generation = 0;
+			u32 archetype = 0;
+			u32 chunk = 0;
+			u32 row = 0;
+			// next free record while dead
+			u32 next_free = Entity::INVALID_INDEX;
+			b8  is_alive = false;
+		};
+
+		Entity        create_entity_with_mask(ComponentMask mask);
+		ComponentMask get_entity_mask(Entity entity) const;
+		void          change_archetype(Entity entity, ComponentMask new_mask);
+		void*         get_component_bytes(Entity entity, ComponentId id, b8 is_write);
+		void          set_component_bytes(Entity entity, ComponentId id, const void* bytes);
+
+		u32  get_or_create_archetype(ComponentMask mask);
+		void allocate_row(u32 archetype_index, Entity entity, EntityRecord* record);
+		void release_row(const EntityRecord& record);
+
+		std::vector<Archetype>                 m_archetypes;
+		std::unordered_map<ComponentMask, u32> m_archetype_by_mask;
+		std::vector<EntityRecord>              m_entities;
+		u32                                    m_first_free = Entity::INVALID_INDEX;
+		u32                                    m_alive_count = 0;
+		u32                                    m_version = 1;
+	};
+
+	struct SystemContext
+	{
+		World& world;
+		// components written after this version changed since the last run
+		u32    last_run_version;
+		f32    delta_time;
+	};
+
+	/**
+	 * Ordered list of systems. Consecutive systems without conflicting accesses
+	 * (one writing what another reads or writes) form a batch and run in parallel
+	 * on the job system, batches run one after the other.
+	 */
+	class Schedule
+	{
+	public:
+		using SystemFn = std::function<void(const SystemContext& context)>;
+
+		/** `Ts` lists the accessed components, const ones are only read. */
+		template<typename... Ts>
+		void add_system(const char* name, SystemFn fn)
+		{
+			add_system_with_access(
+			    name, get_component_mask<Ts...>(), get_write_mask<Ts...>(), std::move(fn));
+		}
+
+		void run(World& world, f32 delta_time);
+
+	private:
+		struct System
+		{
+			const char*   name = nullptr;
+			ComponentMask reads = 0;
+			ComponentMask writes = 0;
+			SystemFn      fn;
+			u32           last_run_version = 0;
+			// set for the current run
+			jobs::Job     job;
+			World*        world = nullptr;
+			f32           delta_time = 0.0f;
+		};
+
+		void add_system_with_access(
+		    const char* name, ComponentMask reads, ComponentMask writes, SystemFn fn);
+
+		std::vector<System> m_systems;
+		std::vector<u32>    m_batch_starts;  // index of the first system of every batch
+	};
+
+	// Query implementation
+
+	template<typename... Ts>
+	Query<Ts...>::Query(World* world)
+	    : m_world{ world }
+	    , m_required{ get_component_mask<Ts...>() }
+	{
+	}
+
+	template<typename... Ts>
+	b8 Query<Ts...>::passes_change_filter(const Archetype& archetype, const Chunk& chunk) const
+	{
+		if (m_changed == 0)
+		{
+			return true;
+		}
+
+		for (u32 column = 0; column < archetype.component_count; ++column)
+		{
+			const ComponentMask bit = ComponentMask{ 1 } << archetype.components[column];
+			if ((m_changed & bit) != 0 && chunk.versions[column] > m_changed_version)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void Query<Ts...>::run_chunk(Archetype& archetype, Chunk& chunk, Fn& fn) const
+	{
+		if (chunk.count == 0 || !passes_change_filter(archetype, chunk))
+		{
+			return;
+		}
+
+		// stamp the written columns before handing them out
+		const u32 version = m_world->get_version();
+		(
+		    [&]
+		    {
+			    if constexpr (!std::is_const_v<Ts>)
+			    {
+				    chunk.versions[archetype.column_by_id[get_component_id<Ts>()]] = version;
+			    }
+		    }(),
+		    ...);
+
+		fn(chunk.count, archetype.get_entities(chunk), archetype.template get_column<Ts>(chunk)...);
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void Query<Ts...>::for_each_chunk(Fn&& fn)
+	{
+		for (Archetype& archetype : m_world->get_archetypes())
+		{
+			if (!matches(archetype))
+			{
+				continue;
+			}
+
+			for (Chunk& chunk : archetype.chunks)
+			{
+				run_chunk(archetype, chunk, fn);
+			}
+		}
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void Query<Ts...>::each(Fn&& fn)
+	{
+		for_each_chunk(
+		    [&fn](u32 count, const Entity* entities, Ts*... columns)
+		    {
+			    for (u32 i = 0; i < count; ++i)
+			    {
+				    if constexpr (std::is_invocable_v<Fn&, Entity, Ts&...>)
+				    {
+					    fn(entities[i], columns[i]...);
+				    }
+				    else
+				    {
+					    fn(columns[i]...);
+				    }
+			    }
+		    });
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void Query<Ts...>::parallel_each(Fn&& fn)
+	{
+		std::vector<Archetype>& archetypes = m_world->get_archetypes();
+
+		u32 chunk_count = 0;
+		for (const Archetype& archetype : archetypes)
+		{
+			chunk_count += matches(archetype) ? static_cast<u32>(archetype.chunks.size()) : 0;
+		}
+
+		auto run_range = [&](u32 begin, u32 end)
+		{
+			auto per_entity = [&fn](u32 count, const Entity* entities, Ts*... columns)
+			{
+				for (u32 i = 0; i < count; ++i)
+				{
+					if constexpr (std::is_invocable_v<Fn&, Entity, Ts&...>)
+					{
+						fn(entities[i], columns[i]...);
+					}
+					else
+					{
+						fn(columns[i]...);
+					}
+				}
+			};
+
+			// chunks are numbered across the matching archetypes, find the first one
+			u32 first = 0;
+			for (Archetype& archetype : archetypes)
+			{
+				if (!matches(archetype))
+				{
+					continue;
+				}
+
+				const u32 archetype_chunks = static_cast<u32>(archetype.chunks.size());
+				for (u32 i = std::max(begin, first); i < std::min(end, first + archetype_chunks); ++i)
+				{
+					run_chunk(archetype, archetype.chunks[i - first], per_entity);
+				}
+
+				first += archetype_chunks;
+				if (first >= end)
+				{
+					break;
+				}
+			}
+		};
+
+		jobs::parallel_for(chunk_count, run_range, 1);
+	}
+
+	template<typename... Ts>
+	u32 Query<Ts...>::count()
+	{
+		u32 total = 0;
+		for (const Archetype& archetype : m_world->get_archetypes())
+		{
+			if (!matches(archetype))
+			{
+				continue;
+			}
+
+			for (const Chunk& chunk : archetype.chunks)
+			{
+				total += passes_change_filter(archetype, chunk) ? chunk.count : 0;
+			}
+		}
+		return total;
+	}
+}  // namespace core::ecs
@@ -1,52 +1,132 @@
 #include "core/event_handler.hpp"
 
+#include "core/input_log.hpp"
+#include "core/timing.hpp"
 #include "dev_ui/dev_ui.hpp"
 
 #include <SDL3/SDL.h>
+#include <spdlog/spdlog.h>
 #include <tracy/Tracy.hpp>
 
+#include <algorithm>
+#include <cstdint>
+
 core::EventHandler::EventHandler(Config config)
     : m_window_resizing_fn{ std::move(config.windows_resizing_callback) }
     , m_window_quit_fn{ std::move(config.windows_quit_callback) }
     , m_mouse_captured{ true }
 {
+	// kept across frames, only bursts above it allocate
+	m_frame_events.reserve(FRAME_EVENTS_CAPACITY);
+}
+
+void core::EventHandler::wait_for_events(u64 timeout_ns)
+{
+	if (timeout_ns == 0)
+	{
+		return;
+	}
+
+	ZoneScopedN("Wait for events");
+
+	// without an event to fill, SDL only peeks: the queue is polled as usual afterwards
+	const u64 timeout_ms = (timeout_ns + 999'999) / 1'000'000;
+	SDL_WaitEventTimeout(nullptr, static_cast<i32>(std::min<u64>(timeout_ms, INT32_MAX)));
 }
 
-// TODO either handle all events here or defer them
 void core::EventHandler::collect_input()
 {
 	ZoneScopedN("Collect Input");
-	m_last_keyboard_state = m_current_keyboard_state;
+	m_previous_keys = m_keys;
+	m_snapshot = {};
+	m_frame_events.clear();
 
 	SDL_Event e;
 	while (SDL_PollEvent(&e))
 	{
+		// replayed frames only take the window events from SDL, keyboard and mouse are
+		// in the 0x300-0x5ff range
+		const b8 is_replayed_input = m_player != nullptr && e.type >= SDL_EVENT_KEY_DOWN &&
+		                             e.type < SDL_EVENT_JOYSTICK_AXIS_MOTION;
+		if (is_replayed_input)
+		{
+			continue;
+		}
+
 		if (m_mouse_captured)
 		{
 			dev_ui::process_input(e);
 		}
 
+		m_frame_events.push_back(e);
+
+		if (m_snapshot.event_count++ == 0)
+		{
+			m_snapshot.first_event_ns = e.common.timestamp;
+		}
+		m_snapshot.last_event_ns = e.common.timestamp;
+
 		switch (e.type)
 		{
 		case SDL_EVENT_QUIT:
-			m_window_quit_fn();
+			m_snapshot.is_quit_requested = true;
 			break;
 
 		case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
-			m_window_resizing_fn(e.window.data1, e.window.data2);
+			// only the final size matters, a drag produces many of these
+			m_snapshot.is_window_resized = true;
+			m_snapshot.window_width = e.window.data1;
+			m_snapshot.window_height = e.window.data2;
+			break;
+
+		case SDL_EVENT_WINDOW_SHOWN:
+		case SDL_EVENT_WINDOW_HIDDEN:
+			m_window_state.is_shown = e.type == SDL_EVENT_WINDOW_SHOWN;
+			break;
+
+		case SDL_EVENT_WINDOW_MINIMIZED:
+			m_window_state.is_minimized = true;
+			break;
+
+		case SDL_EVENT_WINDOW_RESTORED:
+		case SDL_EVENT_WINDOW_MAXIMIZED:
+			m_window_state.is_minimized = false;
+			m_window_state.is_occluded = false;
+			break;
+
+		// not sent by every platform, an exposed window is visible again
+		case SDL_EVENT_WINDOW_OCCLUDED:
+		case SDL_EVENT_WINDOW_EXPOSED:
+			m_window_state.is_occluded = e.type == SDL_EVENT_WINDOW_OCCLUDED;
+			break;
+
+		case SDL_EVENT_WINDOW_FOCUS_GAINED:
+		case SDL_EVENT_WINDOW_FOCUS_LOST:
+			m_window_state.is_focused = e.type == SDL_EVENT_WINDOW_FOCUS_GAINED;
+			break;
+
+		case SDL_EVENT_KEY_DOWN:
+		case SDL_EVENT_KEY_UP:
+			m_keys.set(e.key.scancode, e.key.down);
+			break;
+
+		case SDL_EVENT_KEYMAP_CHANGED:
+			m_action_map.resolve();
 			break;
 
 		case SDL_EVENT_MOUSE_WHEEL:
-			if (!m_mouse_captured && m_mouse_wheel_direction_fn)
+			if (!m_mouse_captured)
 			{
-				(*m_mouse_wheel_direction_fn)(e.wheel.y);
+				m_snapshot.mouse_wheel += e.wheel.y;
 			}
 			break;
 
 		case SDL_EVENT_MOUSE_MOTION:
-			if (!m_mouse_captured && m_mouse_offset_fn)
+			if (!m_mouse_captured)
 			{
-				(*m_mouse_offset_fn)(e.motion.xrel, -e.motion.yrel);
+				m_snapshot.mouse_x_offset += e.motion.xrel;
+				m_snapshot.mouse_y_offset -= e.motion.yrel;
+				++m_snapshot.mouse_motion_count;
 			}
 			break;
 		default:
@@ -54,41 +134,83 @@ void core::EventHandler::collect_input()
 		}
 	}
 
-	i32       num_keys;
-	const b8* keyboard_state = SDL_GetKeyboardState(&num_keys);
-	std::copy_n(
-	    keyboard_state, num_keys,
-	    m_current_keyboard_state.data());  // store the previous state
+	m_snapshot.collected_ns = SDL_GetTicksNS();
+
+	if (m_player != nullptr)
+	{
+		replay_frame();
+	}
+
+	if (m_recorder != nullptr)
+	{
+		m_recorder->write_frame({ timing::get_delta_time(), m_snapshot, m_keys });
+	}
+
+	// the edges are the changed keys that are down (pressed) or were down (released)
+	const input::KeySet changed = m_keys ^ m_previous_keys;
+	const input::KeySet pressed = changed & m_keys;
+	const input::KeySet released = changed & m_previous_keys;
+
+	m_actions = m_action_map.get_actions(m_keys);
+	m_pressed_actions = m_action_map.get_actions(pressed);
+	m_released_actions = m_action_map.get_actions(released);
+
+	if (m_snapshot.is_window_resized)
+	{
+		m_window_resizing_fn(m_snapshot.window_width, m_snapshot.window_height);
+	}
+
+	if (m_snapshot.is_quit_requested)
+	{
+		m_window_quit_fn();
+	}
+}
+
+void core::EventHandler::replay_frame()
+{
+	input::FrameRecord frame;
+	if (!m_player->read_frame(&frame))
+	{
+		SPDLOG_INFO("Replay finished after {} frames.", m_player->get_frame_count());
+		m_player = nullptr;
+		m_window_quit_fn();
+		return;
+	}
+
+	timing::set_delta_time(frame.delta_time);
+
+	m_snapshot.mouse_x_offset = frame.snapshot.mouse_x_offset;
+	m_snapshot.mouse_y_offset = frame.snapshot.mouse_y_offset;
+	m_snapshot.mouse_motion_count = frame.snapshot.mouse_motion_count;
+	m_snapshot.mouse_wheel = frame.snapshot.mouse_wheel;
+	m_keys = frame.keys;
 }
 
 void core::EventHandler::process_input()
 {
 	ZoneScopedN("Process Input");
+
+	if (m_snapshot.mouse_motion_count != 0 && m_mouse_offset_fn)
+	{
+		(*m_mouse_offset_fn)(m_snapshot.mouse_x_offset, m_snapshot.mouse_y_offset);
+	}
+
+	if (m_snapshot.mouse_wheel != 0.0f && m_mouse_wheel_direction_fn)
+	{
+		(*m_mouse_wheel_direction_fn)(m_snapshot.mouse_wheel);
+	}
+
 	if (m_keyboard_input_handler_fn)
 	{
 		(*m_keyboard_input_handler_fn)(*this);
 	}
 }
+
 void core::EventHandler::toggle_mouse_capture()
 {
 	m_mouse_captured = !m_mouse_captured;
 }
 
-b8 core::EventHandler::is_key_pressed(SDL_Keycode key_code) const
-{
-	return m_current_keyboard_state[SDL_GetScancodeFromKey(key_code, nullptr)];
-}
-
-b8 core::EventHandler::is_key_released(SDL_Keycode key_code) const
-{
-	return !is_key_pressed(SDL_GetScancodeFromKey(key_code, nullptr));
-}
-
-b8 core::EventHandler::is_key_just_pressed(SDL_Keycode key_code) const
-{
-	auto scancode = SDL_GetScancodeFromKey(key_code, nullptr);
-	return m_current_keyboard_state[scancode] && !m_last_keyboard_state[scancode];
-}
 b8 core::EventHandler::is_mouse_captured() const
 {
 	return m_mouse_captured;
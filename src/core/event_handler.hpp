@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/input.hpp"
 #include "core/types.hpp"
 
 #include <SDL3/SDL.h>
@@ -7,9 +8,48 @@
 #include <array>
 #include <functional>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace core
 {
+	namespace input
+	{
+		class InputRecorder;
+		class InputPlayer;
+	}  // namespace input
+
+	/** Everything that happened since the previous frame, with the per-event deltas summed. */
+	struct InputSnapshot
+	{
+		f32 mouse_x_offset = 0.0f;
+		f32 mouse_y_offset = 0.0f;  // positive upward
+		f32 mouse_wheel = 0.0f;
+		u32 mouse_motion_count = 0;  // motion events folded into the offsets
+		u32 event_count = 0;
+		i32 window_width = 0;  // last size when is_window_resized
+		i32 window_height = 0;
+		b8  is_window_resized = false;
+		b8  is_quit_requested = false;
+		u64 first_event_ns = 0;  // SDL timestamps, 0 without events
+		u64 last_event_ns = 0;
+		u64 collected_ns = 0;  // when collect_input ran
+	};
+
+	/** Follows the window events, a hidden window (minimized, occluded) has nothing to show. */
+	struct WindowState
+	{
+		b8 is_shown = true;
+		b8 is_minimized = false;
+		b8 is_occluded = false;
+		b8 is_focused = true;
+
+		[[nodiscard]] b8 is_visible() const
+		{
+			return is_shown && !is_minimized && !is_occluded;
+		}
+	};
+
 	class EventHandler
 	{
 		using MouseOffsetFn = std::function<void(f32 x_offset, f32 y_offset)>;
@@ -49,17 +89,116 @@ namespace core
 		}
 
 		void clear_optional_callbacks();
+
+		/** Every collected frame is written to the recorder, null stops recording. */
+		void set_recorder(input::InputRecorder* recorder)
+		{
+			m_recorder = recorder;
+		}
+
+		/**
+		 * Mouse, keyboard and delta times come from the player instead of SDL and the
+		 * clock, window events stay live. The window closes at the end of the log.
+		 */
+		void set_player(input::InputPlayer* player)
+		{
+			m_player = player;
+		}
+
+		/**
+		 * Blocks until an event arrives or the timeout expires, the event is left for
+		 * collect_input. Returns right away for a timeout of 0.
+		 */
+		void wait_for_events(u64 timeout_ns);
+
+		/** Polls SDL and builds the frame snapshot, only resizing and quitting are handled right
+		 *  away (once, with the last size). */
 		void collect_input();
+
+		/** Dispatches the snapshot, every callback runs at most once per frame. */
 		void process_input();
+
 		void toggle_mouse_capture();
-		b8   is_key_pressed(SDL_Keycode key_code) const;
-		b8   is_key_released(SDL_Keycode key_code) const;
-		b8   is_key_just_pressed(SDL_Keycode key_code) const;
 		b8   is_mouse_captured() const;
 
+		[[nodiscard]] b8 is_replaying() const
+		{
+			return m_player != nullptr;
+		}
+
+		[[nodiscard]] const WindowState& get_window_state() const
+		{
+			return m_window_state;
+		}
+
+		[[nodiscard]] input::ActionMap& get_action_map()
+		{
+			return m_action_map;
+		}
+
+		/** Actions whose keys are down, then the ones that started or stopped this frame. */
+		[[nodiscard]] input::ActionMask get_actions() const
+		{
+			return m_actions;
+		}
+
+		[[nodiscard]] input::ActionMask get_pressed_actions() const
+		{
+			return m_pressed_actions;
+		}
+
+		[[nodiscard]] input::ActionMask get_released_actions() const
+		{
+			return m_released_actions;
+		}
+
+		[[nodiscard]] b8 is_action_down(input::Action action) const
+		{
+			return (m_actions & input::get_action_bit(action)) != 0;
+		}
+
+		[[nodiscard]] b8 is_action_just_pressed(input::Action action) const
+		{
+			return (m_pressed_actions & input::get_action_bit(action)) != 0;
+		}
+
+		[[nodiscard]] b8 is_action_just_released(input::Action action) const
+		{
+			return (m_released_actions & input::get_action_bit(action)) != 0;
+		}
+
+		[[nodiscard]] b8 is_scancode_down(SDL_Scancode scancode) const
+		{
+			return m_keys.test(scancode);
+		}
+
+		[[nodiscard]] const InputSnapshot& get_snapshot() const
+		{
+			return m_snapshot;
+		}
+
+		/** The raw events of the frame in arrival order, `common.timestamp` in nanoseconds. */
+		[[nodiscard]] std::span<const SDL_Event> get_frame_events() const
+		{
+			return m_frame_events;
+		}
+
 	private:
-		std::array<b8, SDL_SCANCODE_COUNT>    m_current_keyboard_state{};
-		std::array<b8, SDL_SCANCODE_COUNT>    m_last_keyboard_state{};
+		static constexpr u32 FRAME_EVENTS_CAPACITY = 256;
+
+		void replay_frame();
+
+		InputSnapshot                         m_snapshot;
+		WindowState                           m_window_state;
+		input::InputRecorder*                 m_recorder = nullptr;
+		input::InputPlayer*                   m_player = nullptr;
+		std::vector<SDL_Event>                m_frame_events;
+		input::KeySet                         m_keys;
+		input::KeySet                         m_previous_keys;
+		input::ActionMap                      m_action_map;
+		input::ActionMask                     m_actions = 0;
+		input::ActionMask                     m_pressed_actions = 0;
+		input::ActionMask                     m_released_actions = 0;
 		std::optional<KeyboardInputHandlerFn> m_keyboard_input_handler_fn;
 		std::optional<MouseOffsetFn>          m_mouse_offset_fn;
 		std::optional<MouseWheelDirectionFn>  m_mouse_wheel_direction_fn;
@@ -0,0 +1,189 @@
+#include "core/fiber.hpp"
+
+#include "utils/assertions.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+namespace
+{
+	static std::size_t get_page_size()
+	{
+#ifdef PLATFORM_WINDOWS
+		SYSTEM_INFO system_info;
+		GetSystemInfo(&system_info);
+		return system_info.dwPageSize;
+#else
+		return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+}  // namespace
+
+core::Fiber::~Fiber()
+{
+#ifdef PLATFORM_WINDOWS
+	if (m_handle && !m_is_thread)
+	{
+		DeleteFiber(m_handle);
+	}
+#endif
+}
+
+#ifdef PLATFORM_WINDOWS
+
+void core::Fiber::create(
+    M_UNUSED std::byte* stack, std::size_t stack_size, EntryFn entry, void* argument)
+{
+	m_entry = entry;
+	m_argument = argument;
+	m_handle = CreateFiber(stack_size, &Fiber::trampoline, this);
+
+	if (m_handle == nullptr)
+	{
+		SPDLOG_CRITICAL("Cannot create fiber: error {}", GetLastError());
+	}
+}
+
+void core::Fiber::convert_from_thread()
+{
+	m_handle = ConvertThreadToFiber(nullptr);
+	m_is_thread = true;
+}
+
+void core::Fiber::convert_to_thread()
+{
+	ConvertFiberToThread();
+	m_handle = nullptr;
+	m_is_thread = false;
+}
+
+void core::Fiber::switch_to(M_UNUSED Fiber& from, Fiber& to)
+{
+	SwitchToFiber(to.m_handle);
+}
+
+void __stdcall core::Fiber::trampoline(void* fiber)
+{
+	auto* self = static_cast<Fiber*>(fiber);
+	self->m_entry(self->m_argument);
+
+	CHECK_MSG(false, "A fiber entry function returned.");
+	std::abort();
+}
+
+#else
+
+void core::Fiber::create(std::byte* stack, std::size_t stack_size, EntryFn entry, void* argument)
+{
+	m_entry = entry;
+	m_argument = argument;
+
+	getcontext(&m_context);
+	m_context.uc_stack.ss_sp = stack;
+	m_context.uc_stack.ss_size = stack_size;
+	m_context.uc_link = nullptr;
+
+	// makecontext only forwards int arguments, split the pointer in two halves
+	const auto address = reinterpret_cast<std::uintptr_t>(this);
+	makecontext(
+	    &m_context, reinterpret_cast<void (*)()>(&Fiber::trampoline), 2,
+	    static_cast<unsigned int>(static_cast<std::uint64_t>(address) >> 32u),
+	    static_cast<unsigned int>(address & 0xffffffffu));
+}
+
+void core::Fiber::convert_from_thread()
+{
+	// nothing to do, the context is saved on the first switch
+}
+
+void core::Fiber::convert_to_thread()
+{
+}
+
+void core::Fiber::switch_to(Fiber& from, Fiber& to)
+{
+	swapcontext(&from.m_context, &to.m_context);
+}
+
+void core::Fiber::trampoline(unsigned int fiber_high, unsigned int fiber_low)
+{
+	const std::uintptr_t address =
+	    static_cast<std::uintptr_t>((static_cast<std::uint64_t>(fiber_high) << 32u) | fiber_low);
+	auto* self = reinterpret_cast<Fiber*>(address);
+	self->m_entry(self->m_argument);
+
+	CHECK_MSG(false, "A fiber entry function returned.");
+	std::abort();
+}
+
+#endif
+
+std::size_t core::fiber_stacks::get_aligned_size(std::size_t stack_size)
+{
+	const std::size_t page_size = get_page_size();
+	return (stack_size + page_size - 1) / page_size * page_size;
+}
+
+std::byte* core::fiber_stacks::allocate(
+    M_UNUSED u32 count, M_UNUSED std::size_t aligned_stack_size)
+{
+#ifdef PLATFORM_WINDOWS
+	// the OS owns the fiber stacks
+	return nullptr;
+#else
+	const std::size_t page_size = get_page_size();
+	const std::size_t slot_size = aligned_stack_size + page_size;
+
+	void* memory = mmap(
+	    nullptr, slot_size * count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (memory == MAP_FAILED)
+	{
+		SPDLOG_CRITICAL("Cannot allocate {} fiber stacks of {} bytes.", count, aligned_stack_size);
+		return nullptr;
+	}
+
+	auto* stacks = static_cast<std::byte*>(memory);
+
+	// stacks grow downward, an overflow hits the guard page below each stack
+	for (u32 i = 0; i < count; ++i)
+	{
+		mprotect(stacks + i * slot_size, page_size, PROT_NONE);
+	}
+
+	return stacks;
+#endif
+}
+
+void core::fiber_stacks::release(
+    M_UNUSED std::byte* stacks, M_UNUSED u32 count, M_UNUSED std::size_t aligned_stack_size)
+{
+#ifndef PLATFORM_WINDOWS
+	if (stacks)
+	{
+		munmap(stacks, (aligned_stack_size + get_page_size()) * count);
+	}
+#endif
+}
+
+std::byte* core::fiber_stacks::get_stack(
+    std::byte* stacks, u32 index, std::size_t aligned_stack_size)
+{
+	if (stacks == nullptr)
+	{
+		return nullptr;
+	}
+
+	const std::size_t page_size = get_page_size();
+	return stacks + index * (aligned_stack_size + page_size) + page_size;
+}
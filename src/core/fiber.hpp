@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cstddef>
+
+#ifndef PLATFORM_WINDOWS
+#	include <ucontext.h>
+#endif
+
+namespace core
+{
+	/**
+	 * User-space execution context with its own stack, switching between fibers
+	 * does not involve the OS scheduler. Uses Win32 fibers on Windows and ucontext
+	 * everywhere else. A thread must become a fiber itself (`convert_from_thread`)
+	 * before switching to other fibers.
+	 */
+	class Fiber
+	{
+	public:
+		using EntryFn = void (*)(void* argument);
+
+		Fiber() = default;
+		~Fiber();
+
+		Fiber(const Fiber& other) = delete;
+		Fiber& operator=(const Fiber& other) = delete;
+		Fiber(Fiber&& other) noexcept = delete;
+		Fiber& operator=(Fiber&& other) noexcept = delete;
+
+		/**
+		 * Prepares the fiber to run `entry(argument)` on the given stack, the stack is
+		 * not owned (see `fiber_stacks`). The entry function must never return,
+		 * switch to another fiber instead. On Windows the OS allocates the stack.
+		 */
+		void create(std::byte* stack, std::size_t stack_size, EntryFn entry, void* argument);
+
+		/** Turns the calling thread into a fiber, to be able to switch from it. */
+		void convert_from_thread();
+		void convert_to_thread();
+
+		/** Saves the current context into `from` and continues `to`. */
+		static void switch_to(Fiber& from, Fiber& to);
+
+	private:
+#ifdef PLATFORM_WINDOWS
+		void* m_handle = nullptr;
+		b8    m_is_thread = false;
+#else
+		ucontext_t m_context{};
+#endif
+		EntryFn m_entry = nullptr;
+		void*   m_argument = nullptr;
+
+#ifndef PLATFORM_WINDOWS
+		static void trampoline(unsigned int fiber_high, unsigned int fiber_low);
+#else
+		static void __stdcall trampoline(void* fiber);
+#endif
+	};
+
+	/** Fixed-size fiber stacks in a single allocation, each one with a guard page. */
+	namespace fiber_stacks
+	{
+		/** Rounds up to whole pages (the guard page is not part of the usable size). */
+		[[nodiscard]] std::size_t get_aligned_size(std::size_t stack_size);
+
+		[[nodiscard]] std::byte* allocate(u32 count, std::size_t aligned_stack_size);
+		void release(std::byte* stacks, u32 count, std::size_t aligned_stack_size);
+
+		/** The usable stack `index` from a block returned by `allocate`. */
+		[[nodiscard]] std::byte* get_stack(
+		    std::byte* stacks, u32 index, std::size_t aligned_stack_size);
+	}  // namespace fiber_stacks
+}  // namespace core
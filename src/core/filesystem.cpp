@@ -1,11 +1,43 @@
 #include "core/filesystem.hpp"
 
 #include <SDL3/SDL_filesystem.h>
+#include <SDL3/SDL_timer.h>
 #include <physfs.h>
 #include <spdlog/spdlog.h>
 
+#ifdef EMBEDDED_CONTENTS
+namespace core::embedded
+{
+	// defined in the source generated by 'cmake/EmbedContent.cmake'
+	extern const unsigned char g_contents_archive[];
+	extern const std::size_t   g_contents_archive_size;
+}  // namespace core::embedded
+#endif
+
+namespace
+{
+	static b8 mount_contents(std::string* out_content_root)
+	{
+#ifdef EMBEDDED_CONTENTS
+		// the name identifies the archive in the search path, the extension lets
+		// PhysFS pick the ZIP archiver first
+		*out_content_root = "contents.zip";
+
+		return PHYSFS_mountMemory(
+		    core::embedded::g_contents_archive, core::embedded::g_contents_archive_size, nullptr,
+		    out_content_root->c_str(), "/", false);
+#else
+		fmt::format_to(std::back_inserter(*out_content_root), "{}/contents", SDL_GetBasePath());
+
+		return PHYSFS_mount(out_content_root->c_str(), "/", false);
+#endif
+	}
+}  // namespace
+
 core::Filesystem::Filesystem(char** platform_argument)
 {
+	M_UNUSED const u64 start_counter = SDL_GetPerformanceCounter();
+
 	if (PHYSFS_init(std::strlen(platform_argument[0]) > 0 ? platform_argument[0] : nullptr))
 	{
 		SPDLOG_INFO("Virtual filesystem initialized.");
@@ -15,9 +47,7 @@ core::Filesystem::Filesystem(char** platform_argument)
 		SPDLOG_CRITICAL("Virtual filesystem error: {}.\n", PHYSFS_getLastError());
 	}
 
-	fmt::format_to(std::back_inserter(m_content_root), "{}/contents", SDL_GetBasePath());
-
-	if (PHYSFS_mount(m_content_root.c_str(), "/", false))
+	if (mount_contents(&m_content_root))
 	{
 		SPDLOG_DEBUG("Filesystem root '{}' mounted at '/' successfully.", m_content_root);
 	}
@@ -26,6 +56,16 @@ core::Filesystem::Filesystem(char** platform_argument)
 		SPDLOG_CRITICAL(
 		    "Cannot mount virtual filesystem from '{}': {}", m_content_root, PHYSFS_getLastError());
 	}
+
+	M_UNUSED const f64 elapsed_ms = static_cast<f64>(SDL_GetPerformanceCounter() - start_counter) *
+	                                1000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+#ifdef EMBEDDED_CONTENTS
+	SPDLOG_INFO(
+	    "Contents mounted in {:.3f} ms (embedded archive, {} bytes).", elapsed_ms,
+	    core::embedded::g_contents_archive_size);
+#else
+	SPDLOG_INFO("Contents mounted in {:.3f} ms (directory '{}').", elapsed_ms, m_content_root);
+#endif
 }
 
 core::Filesystem::~Filesystem()
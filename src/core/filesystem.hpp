@@ -5,6 +5,7 @@
 
 #include <fmt/format.h>
 #include <physfs.h>
+#include <spdlog/spdlog.h>
 
 #include <filesystem>
 #include <string>
@@ -31,18 +32,28 @@ namespace core
 	class FileType
 	{
 	public:
+		static constexpr std::size_t MAX_PATH_LENGTH = 256;
+
+		// formatted in place, creating a file type never allocates
 		explicit FileType(std::string_view path)
-		    : m_path{ fmt::format("/{}/{}", TBasePath::PATH, path) }
 		{
+			const auto result =
+			    fmt::format_to_n(m_path, MAX_PATH_LENGTH - 1, "/{}/{}", TBasePath::PATH, path);
+
+			if (result.size >= MAX_PATH_LENGTH)
+			{
+				SPDLOG_ERROR("File path too long, truncated: '{}'", path);
+			}
+			*result.out = '\0';
 		}
 
-		const std::string& get_path_name() const
+		const char* get_path_name() const
 		{
 			return m_path;
 		}
 
 	private:
-		std::string m_path;
+		char m_path[MAX_PATH_LENGTH];
 	};
 
 	using CoreShaderFile = FileType<ShaderFile>;
@@ -51,9 +62,9 @@ namespace core
 	class Filesystem
 	{
 		template<typename T>
-		void read_file_internal(const std::string& file_name, T* out_buf) const
+		void read_file_internal(const char* file_name, T* out_buf) const
 		{
-			if (auto* file = PHYSFS_openRead(file_name.c_str()))
+			if (auto* file = PHYSFS_openRead(file_name))
 			{
 				i64 file_size = PHYSFS_fileLength(file);
 				out_buf->resize(file_size);
@@ -78,12 +89,21 @@ namespace core
 		template<typename TOutput, CoreFile TBaseDir>
 		TOutput read_file(const FileType<TBaseDir>& f_type) const
 		{
-			auto    p = f_type.get_path_name();
 			TOutput buf;
-			read_file_internal(p, &buf);
+			read_file_internal(f_type.get_path_name(), &buf);
 			return buf;
 		}
 
+		/**
+		 * Reads into an existing container, e.g. a pmr one backed by a scratch arena
+		 * or a buffer reused between reads.
+		 */
+		template<typename TOutput, CoreFile TBaseDir>
+		void read_file(const FileType<TBaseDir>& f_type, TOutput* out_buf) const
+		{
+			read_file_internal(f_type.get_path_name(), out_buf);
+		}
+
 		// NOLINTNEXTLINE(*-convert-member-functions-to-static)
 		bool file_exists(const std::string& file_name) const
 		{
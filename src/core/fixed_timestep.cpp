@@ -0,0 +1,90 @@
+#include "core/fixed_timestep.hpp"
+
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+core::FixedTimestep::FixedTimestep(const Config& config)
+    : m_max_ticks_per_frame{ std::max(config.max_ticks_per_frame, 1u) }
+{
+	set_tick_rate(config.tick_rate);
+}
+
+u32 core::FixedTimestep::advance(f64 frame_seconds)
+{
+	// a clock going backwards or a NaN from a corrupted replay would stall the loop
+	if (!std::isfinite(frame_seconds) || frame_seconds < 0.0)
+	{
+		frame_seconds = 0.0;
+	}
+
+	m_accumulator += frame_seconds;
+
+	const auto pending_ticks = static_cast<u64>(m_accumulator / m_tick_seconds);
+	const auto tick_count =
+	    static_cast<u32>(std::min<u64>(pending_ticks, m_max_ticks_per_frame));
+
+	m_accumulator -= static_cast<f64>(tick_count) * m_tick_seconds;
+
+	// behind schedule, keep the fraction of a tick only
+	if (pending_ticks > tick_count)
+	{
+		const f64 remainder = std::fmod(m_accumulator, m_tick_seconds);
+		m_dropped_seconds += m_accumulator - remainder;
+		m_accumulator = remainder;
+	}
+
+	m_last_tick_count = tick_count;
+	m_tick_count += tick_count;
+
+	TracyPlot("Simulation ticks", static_cast<i64>(tick_count));
+
+	return tick_count;
+}
+
+void core::FixedTimestep::set_tick_rate(f64 tick_rate)
+{
+	if (!std::isfinite(tick_rate) || tick_rate < MIN_TICK_RATE || tick_rate > MAX_TICK_RATE)
+	{
+		SPDLOG_WARN(
+		    "Tick rate {} Hz outside of [{}, {}], clamped.", tick_rate, MIN_TICK_RATE, MAX_TICK_RATE);
+		tick_rate = std::isfinite(tick_rate) ? std::clamp(tick_rate, MIN_TICK_RATE, MAX_TICK_RATE)
+		                                     : MIN_TICK_RATE;
+	}
+
+	// the interpolation factor stays in [0, 1) with the new tick length
+	const f64 interpolation = m_tick_seconds > 0.0 ? m_accumulator / m_tick_seconds : 0.0;
+
+	m_tick_rate = tick_rate;
+	m_tick_seconds = 1.0 / tick_rate;
+	m_accumulator = interpolation * m_tick_seconds;
+}
+
+void core::FixedTimestep::prepare_dev_ui()
+{
+	ZoneScopedN("Fixed timestep prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Simulation"))
+	{
+		auto tick_rate = static_cast<f32>(m_tick_rate);
+		if (ImGui::SliderFloat(
+		        "Tick rate", &tick_rate, static_cast<f32>(MIN_TICK_RATE), 240.0f, "%.0f Hz"))
+		{
+			set_tick_rate(tick_rate);
+		}
+
+		i32 max_ticks = static_cast<i32>(m_max_ticks_per_frame);
+		if (ImGui::SliderInt("Max ticks per frame", &max_ticks, 1, 16))
+		{
+			m_max_ticks_per_frame = static_cast<u32>(max_ticks);
+		}
+
+		ImGui::Text("Ticks this frame: %u", m_last_tick_count);
+		ImGui::Text("Total ticks: %llu", static_cast<unsigned long long>(m_tick_count));
+		ImGui::Text("Interpolation: %.2f", get_interpolation());
+		ImGui::Text("Dropped time: %.3f s", m_dropped_seconds);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/types.hpp"
+
+/**
+ * Runs the simulation at a fixed tick rate, independently of the frame rate:
+ * the frame time is accumulated and consumed in whole ticks, the remainder is
+ * the interpolation factor between the last two simulated states that the
+ * frame renders. When the simulation falls behind (a stall, a breakpoint, a
+ * tick rate too high for the machine) at most `max_ticks_per_frame` run and the
+ * rest of the time is dropped, the simulation slows down instead of spending
+ * ever more time catching up (spiral of death).
+ */
+namespace core
+{
+	class FixedTimestep
+	{
+	public:
+		struct Config
+		{
+			f64 tick_rate = 60.0;  // Hz
+			u32 max_ticks_per_frame = 5;
+		};
+
+		static constexpr f64 MIN_TICK_RATE = 10.0;
+		static constexpr f64 MAX_TICK_RATE = 1000.0;
+
+		explicit FixedTimestep(const Config& config);
+
+		FixedTimestep(const FixedTimestep& other) = delete;
+		FixedTimestep& operator=(const FixedTimestep& other) = delete;
+		FixedTimestep(FixedTimestep&& other) noexcept = delete;
+		FixedTimestep& operator=(FixedTimestep&& other) noexcept = delete;
+
+		/** Adds the frame time, returns the number of ticks to simulate this frame. */
+		u32 advance(f64 frame_seconds);
+
+		/** Takes effect from the next advance, the accumulated time is kept. */
+		void set_tick_rate(f64 tick_rate);
+
+		[[nodiscard]] f64 get_tick_rate() const
+		{
+			return m_tick_rate;
+		}
+
+		[[nodiscard]] f32 get_tick_seconds() const
+		{
+			return static_cast<f32>(m_tick_seconds);
+		}
+
+		/** Between the previous (0) and the last (1) simulated state. */
+		[[nodiscard]] f32 get_interpolation() const
+		{
+			return static_cast<f32>(m_accumulator / m_tick_seconds);
+		}
+
+		[[nodiscard]] u64 get_tick_count() const
+		{
+			return m_tick_count;
+		}
+
+		void prepare_dev_ui();
+
+	private:
+		f64 m_tick_rate = 0.0;
+		f64 m_tick_seconds = 0.0;
+		f64 m_accumulator = 0.0;
+		u32 m_max_ticks_per_frame;
+		u32 m_last_tick_count = 0;
+		u64 m_tick_count = 0;
+		f64 m_dropped_seconds = 0.0;
+	};
+}  // namespace core
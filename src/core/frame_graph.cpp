@@ -0,0 +1,691 @@
+#include "core/frame_graph.hpp"
+
+#include "core/gpu_profiler.hpp"
+
+#include <fmt/format.h>
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+#include <tracy/TracyOpenGL.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr u64 FNV_OFFSET = 14695981039346656037ull;
+	static constexpr u64 FNV_PRIME = 1099511628211ull;
+
+	/** FNV-1a over the bytes of a value. */
+	template<typename T>
+	static void hash_value(u64* hash, const T& value)
+	{
+		const auto* bytes = reinterpret_cast<const u8*>(&value);
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+		{
+			*hash = (*hash ^ bytes[i]) * FNV_PRIME;
+		}
+	}
+
+	/** Appends to a fixed buffer, always null terminated, the end is cut. */
+	class TextWriter
+	{
+	public:
+		explicit TextWriter(std::span<char> buffer)
+		    : m_buffer{ buffer }
+		{
+			m_buffer[0] = '\0';
+		}
+
+		template<typename... Args>
+		void write(fmt::format_string<Args...> format, Args&&... args)
+		{
+			const std::size_t available = m_buffer.size() - 1 - m_size;
+			char*             out = m_buffer.data() + m_size;
+			m_size += std::min(
+			    fmt::format_to_n(out, available, format, std::forward<Args>(args)...).size,
+			    available);
+			m_buffer[m_size] = '\0';
+		}
+
+	private:
+		std::span<char> m_buffer;
+		std::size_t     m_size = 0;
+	};
+
+	static f64 to_mib(std::size_t bytes)
+	{
+		return static_cast<f64>(bytes) / (1024.0 * 1024.0);
+	}
+}  // namespace
+
+core::Handle<core::RenderTarget> core::PassContext::get_target(u32 resource) const
+{
+	return graph->get_target(resource);
+}
+
+glm::ivec2 core::PassContext::get_size(u32 resource) const
+{
+	return graph->get_size(resource);
+}
+
+core::FrameGraph::FrameGraph(RenderTargetPool& render_targets, GpuProfiler& gpu_profiler)
+    : m_render_targets{ &render_targets }
+    , m_gpu_profiler{ &gpu_profiler }
+{
+}
+
+void core::FrameGraph::reset()
+{
+	m_pass_count = 0;
+	m_resource_count = 0;
+}
+
+u32 core::FrameGraph::create_texture(const char* name, const TargetDesc& desc)
+{
+	if (m_resource_count == MAX_RESOURCES)
+	{
+		SPDLOG_ERROR("Frame graph texture {} ignored, at most {} resources.", name, MAX_RESOURCES);
+		return INVALID_INDEX;
+	}
+
+	// the compiled fields stay, they are valid as long as the declarations do not change
+	Resource& resource = m_resources[m_resource_count];
+	resource.name = name;
+	resource.desc = desc;
+	resource.size = m_render_targets->get_size(desc);
+	resource.is_imported = false;
+	resource.target = {};
+	return m_resource_count++;
+}
+
+u32 core::FrameGraph::import_backbuffer(const char* name, i32 width, i32 height)
+{
+	if (m_resource_count == MAX_RESOURCES)
+	{
+		SPDLOG_ERROR("Frame graph import {} ignored, at most {} resources.", name, MAX_RESOURCES);
+		return INVALID_INDEX;
+	}
+
+	Resource& resource = m_resources[m_resource_count];
+	resource.name = name;
+	resource.desc = {};
+	resource.size = { std::max(width, 1), std::max(height, 1) };
+	resource.is_imported = true;
+	resource.target = {};
+	return m_resource_count++;
+}
+
+u32 core::FrameGraph::add_pass(const char* name, ExecuteFn execute, void* data)
+{
+	if (m_pass_count == MAX_PASSES)
+	{
+		SPDLOG_ERROR("Frame graph pass {} ignored, at most {} passes.", name, MAX_PASSES);
+		return INVALID_INDEX;
+	}
+
+	Pass& pass = m_passes[m_pass_count];
+	pass.name = name;
+	pass.execute = execute;
+	pass.data = data;
+	pass.access_count = 0;
+	return m_pass_count++;
+}
+
+void core::FrameGraph::read(u32 pass, u32 resource)
+{
+	add_access(pass, resource, Access::READ);
+}
+
+void core::FrameGraph::write(u32 pass, u32 resource)
+{
+	add_access(pass, resource, Access::WRITE);
+}
+
+void core::FrameGraph::compile()
+{
+	ZoneScopedN("Compile frame graph");
+
+	const u64 hash = hash_declarations();
+	if (hash == m_compiled_hash)
+	{
+		return;
+	}
+	m_compiled_hash = hash;
+	++m_compile_count;
+
+	cull();
+	order();
+	plan_lifetimes();
+	write_dump();
+}
+
+void core::FrameGraph::execute()
+{
+	ZoneScopedN("Execute frame graph");
+
+	for (u32 step = 0; step < m_step_count; ++step)
+	{
+		Pass& pass = m_passes[m_order[step]];
+
+		for (u32 i = 0; i < m_resource_count; ++i)
+		{
+			Resource& resource = m_resources[i];
+			if (!resource.is_imported && resource.first_step == step)
+			{
+				resource.target = m_render_targets->acquire(resource.desc);
+			}
+		}
+
+		// the attachments are the writes only, a pass never samples its own framebuffer
+		using Colors = std::array<Handle<RenderTarget>, RenderTargetPool::MAX_COLOR_ATTACHMENTS>;
+		Colors               colors{};
+		u32                  color_count = 0;
+		Handle<RenderTarget> depth;
+		b8                   is_writing_backbuffer = false;
+		glm::ivec2           size{ 0 };
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [index, access] = pass.accesses[i];
+			const Resource& resource = m_resources[index];
+			if (access != Access::WRITE)
+			{
+				continue;
+			}
+
+			size = resource.size;
+			if (resource.is_imported)
+			{
+				is_writing_backbuffer = true;
+			}
+			else if (is_depth_format(resource.desc.format))
+			{
+				depth = resource.target;
+			}
+			else if (color_count < colors.size())
+			{
+				colors[color_count++] = resource.target;
+			}
+		}
+
+		u32 framebuffer = 0;
+		if (!is_writing_backbuffer)
+		{
+			framebuffer = m_render_targets->get_framebuffer(
+			    std::span{ colors.data(), color_count }, depth);
+		}
+
+		// an incomplete framebuffer was logged by the pool, the window is not drawn over
+		if (is_writing_backbuffer || framebuffer != 0)
+		{
+			ZoneScopedN("Pass");
+			ZoneName(pass.name, std::strlen(pass.name));
+			TracyGpuZoneTransient(PassGpuZone, pass.name, true);
+			const GpuScope gpu_scope{ *m_gpu_profiler, pass.name };
+
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glViewport(0, 0, size.x, size.y);
+
+			const PassContext context{ .graph = this, .framebuffer = framebuffer, .size = size };
+			pass.execute(context, pass.data);
+		}
+
+		for (u32 i = 0; i < m_resource_count; ++i)
+		{
+			Resource& resource = m_resources[i];
+			if (!resource.is_imported && resource.last_step == step)
+			{
+				m_render_targets->release(resource.target);
+			}
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+core::Handle<core::RenderTarget> core::FrameGraph::get_target(u32 resource) const
+{
+	return resource < m_resource_count ? m_resources[resource].target : Handle<RenderTarget>{};
+}
+
+glm::ivec2 core::FrameGraph::get_size(u32 resource) const
+{
+	return resource < m_resource_count ? m_resources[resource].size : glm::ivec2{ 0 };
+}
+
+void core::FrameGraph::prepare_dev_ui()
+{
+	ZoneScopedN("Frame graph prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Frame graph"))
+	{
+		const std::lock_guard lock{ m_dump_mutex };
+
+		// paste into `dot -Tsvg` for a picture of the passes
+		if (ImGui::Button("Copy as Graphviz"))
+		{
+			ImGui::SetClipboardText(m_dot.data());
+		}
+		ImGui::TextUnformatted(m_dump.data());
+	}
+}
+
+void core::FrameGraph::add_access(u32 pass, u32 resource, Access access)
+{
+	if (pass >= m_pass_count || resource >= m_resource_count)
+	{
+		return;
+	}
+
+	Pass& declared = m_passes[pass];
+	for (u32 i = 0; i < declared.access_count; ++i)
+	{
+		if (declared.accesses[i].first == resource)
+		{
+			if (declared.accesses[i].second != access)
+			{
+				SPDLOG_ERROR(
+				    "Pass {} reads and writes {}, a texture cannot be sampled while attached.",
+				    declared.name, m_resources[resource].name);
+			}
+			return;
+		}
+	}
+
+	if (declared.access_count == MAX_PASS_RESOURCES)
+	{
+		SPDLOG_ERROR(
+		    "Pass {} ignores {}, at most {} resources per pass.", declared.name,
+		    m_resources[resource].name, MAX_PASS_RESOURCES);
+		return;
+	}
+	declared.accesses[declared.access_count++] = { resource, access };
+}
+
+void core::FrameGraph::cull()
+{
+	// reference counting: a resource nobody reads releases its writers, a pass whose
+	// writes are all unread releases what it reads, until only the passes with a
+	// side effect (writing an imported resource) and those they depend on remain
+	std::array<u32, MAX_PASSES>    pass_references{};
+	std::array<b8, MAX_PASSES>     has_side_effect{};
+	std::array<u32, MAX_RESOURCES> resource_references{};
+	std::array<u32, MAX_RESOURCES> unreferenced{};
+	u32                            unreferenced_count = 0;
+
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		Pass& pass = m_passes[p];
+		pass.is_culled = false;
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [resource, access] = pass.accesses[i];
+			if (access == Access::READ)
+			{
+				++resource_references[resource];
+			}
+			else
+			{
+				++pass_references[p];
+				has_side_effect[p] = has_side_effect[p] || m_resources[resource].is_imported;
+			}
+		}
+	}
+
+	for (u32 r = 0; r < m_resource_count; ++r)
+	{
+		if (resource_references[r] == 0 && !m_resources[r].is_imported)
+		{
+			unreferenced[unreferenced_count++] = r;
+		}
+	}
+
+	const auto cull_pass = [&](u32 p)
+	{
+		Pass& pass = m_passes[p];
+		pass.is_culled = true;
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [resource, access] = pass.accesses[i];
+			if (access == Access::READ && --resource_references[resource] == 0 &&
+			    !m_resources[resource].is_imported)
+			{
+				unreferenced[unreferenced_count++] = resource;
+			}
+		}
+	};
+
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		if (pass_references[p] == 0 && !has_side_effect[p])
+		{
+			cull_pass(p);
+		}
+	}
+
+	while (unreferenced_count > 0)
+	{
+		const u32 resource = unreferenced[--unreferenced_count];
+		for (u32 p = 0; p < m_pass_count; ++p)
+		{
+			Pass& pass = m_passes[p];
+			if (pass.is_culled)
+			{
+				continue;
+			}
+			for (u32 i = 0; i < pass.access_count; ++i)
+			{
+				if (pass.accesses[i] == std::pair{ resource, Access::WRITE } &&
+				    --pass_references[p] == 0 && !has_side_effect[p])
+				{
+					cull_pass(p);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void core::FrameGraph::order()
+{
+	// in declaration order, each access depends on the last write (read or write after
+	// write) and a write on the reads since (write after read)
+	std::array<u32, MAX_RESOURCES> last_writer;
+	std::array<u32, MAX_RESOURCES> readers{};  // since the last write
+	last_writer.fill(INVALID_INDEX);
+	m_transition_count = 0;
+
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		Pass& pass = m_passes[p];
+		pass.dependencies = 0;
+		if (pass.is_culled)
+		{
+			continue;
+		}
+
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [resource, access] = pass.accesses[i];
+			const u32 writer = last_writer[resource];
+			if (writer != INVALID_INDEX)
+			{
+				pass.dependencies |= 1u << writer;
+			}
+
+			if (access == Access::READ)
+			{
+				readers[resource] |= 1u << p;
+				if (writer == INVALID_INDEX)
+				{
+					SPDLOG_WARN(
+					    "Pass {} reads {} before any pass writes it.", pass.name,
+					    m_resources[resource].name);
+				}
+				else if (m_transition_count < MAX_TRANSITIONS)
+				{
+					m_transitions[m_transition_count++] = { resource, writer, p };
+				}
+			}
+			else
+			{
+				pass.dependencies |= readers[resource] & ~(1u << p);
+				readers[resource] = 0;
+				last_writer[resource] = p;
+			}
+		}
+	}
+
+	// Kahn's algorithm, the lowest declared pass first among the ready ones
+	u32 scheduled = 0;
+	m_step_count = 0;
+	for (;;)
+	{
+		u32 ready = INVALID_INDEX;
+		for (u32 p = 0; p < m_pass_count; ++p)
+		{
+			const Pass& pass = m_passes[p];
+			if (!pass.is_culled && (scheduled & (1u << p)) == 0 &&
+			    (pass.dependencies & ~scheduled) == 0)
+			{
+				ready = p;
+				break;
+			}
+		}
+
+		if (ready == INVALID_INDEX)
+		{
+			break;
+		}
+		scheduled |= 1u << ready;
+		m_order[m_step_count++] = ready;
+	}
+
+	u32 live_count = 0;
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		live_count += m_passes[p].is_culled ? 0 : 1;
+	}
+	if (m_step_count != live_count)
+	{
+		SPDLOG_ERROR("Frame graph has a dependency cycle, the passes run in declaration order.");
+		m_step_count = 0;
+		for (u32 p = 0; p < m_pass_count; ++p)
+		{
+			if (!m_passes[p].is_culled)
+			{
+				m_order[m_step_count++] = p;
+			}
+		}
+	}
+}
+
+void core::FrameGraph::plan_lifetimes()
+{
+	for (u32 r = 0; r < m_resource_count; ++r)
+	{
+		m_resources[r].first_step = INVALID_INDEX;
+		m_resources[r].last_step = INVALID_INDEX;
+		m_resources[r].alias = INVALID_INDEX;
+	}
+
+	for (u32 step = 0; step < m_step_count; ++step)
+	{
+		const Pass& pass = m_passes[m_order[step]];
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			Resource& resource = m_resources[pass.accesses[i].first];
+			resource.first_step = std::min(resource.first_step, step);
+			resource.last_step = resource.last_step == INVALID_INDEX
+			                         ? step
+			                         : std::max(resource.last_step, step);
+		}
+	}
+
+	// the pool hands a released target to the next acquisition with the same size, format
+	// and samples: simulated here to show which textures share one
+	std::array<u32, MAX_RESOURCES> alias_owner{};  // the resource that created the target
+	std::array<b8, MAX_RESOURCES>  is_alias_busy{};
+	m_alias_count = 0;
+	m_aliased_bytes = 0;
+	m_unaliased_bytes = 0;
+
+	for (u32 step = 0; step < m_step_count; ++step)
+	{
+		for (u32 r = 0; r < m_resource_count; ++r)
+		{
+			Resource& resource = m_resources[r];
+			if (resource.is_imported || resource.first_step != step)
+			{
+				continue;
+			}
+
+			const std::size_t bytes = get_target_byte_size(
+			    resource.size, resource.desc.format, std::max(resource.desc.samples, 1u));
+			m_unaliased_bytes += bytes;
+
+			for (u32 a = 0; a < m_alias_count; ++a)
+			{
+				const Resource& owner = m_resources[alias_owner[a]];
+				if (!is_alias_busy[a] && owner.size == resource.size &&
+				    owner.desc.format == resource.desc.format &&
+				    std::max(owner.desc.samples, 1u) == std::max(resource.desc.samples, 1u))
+				{
+					resource.alias = a;
+					break;
+				}
+			}
+			if (resource.alias == INVALID_INDEX)
+			{
+				resource.alias = m_alias_count;
+				alias_owner[m_alias_count++] = r;
+				m_aliased_bytes += bytes;
+			}
+			is_alias_busy[resource.alias] = true;
+		}
+
+		for (u32 r = 0; r < m_resource_count; ++r)
+		{
+			const Resource& resource = m_resources[r];
+			if (!resource.is_imported && resource.last_step == step)
+			{
+				is_alias_busy[resource.alias] = false;
+			}
+		}
+	}
+}
+
+void core::FrameGraph::write_dump()
+{
+	const std::lock_guard lock{ m_dump_mutex };
+
+	TextWriter dump{ m_dump };
+	dump.write(
+	    "Compiled {} times, {} of {} passes run\n", m_compile_count, m_step_count, m_pass_count);
+
+	for (u32 step = 0; step < m_step_count; ++step)
+	{
+		const Pass& pass = m_passes[m_order[step]];
+		dump.write("{}. {}", step + 1, pass.name);
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [resource, access] = pass.accesses[i];
+			dump.write(
+			    "{}{}", access == Access::READ ? "\n     reads " : "\n     writes ",
+			    m_resources[resource].name);
+		}
+		dump.write("\n");
+	}
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		if (m_passes[p].is_culled)
+		{
+			dump.write("culled: {}\n", m_passes[p].name);
+		}
+	}
+
+	dump.write("\nTextures:\n");
+	for (u32 r = 0; r < m_resource_count; ++r)
+	{
+		const Resource& resource = m_resources[r];
+		dump.write("{} {}x{}", resource.name, resource.size.x, resource.size.y);
+		if (resource.is_imported)
+		{
+			dump.write(" imported\n");
+		}
+		else if (resource.first_step == INVALID_INDEX)
+		{
+			dump.write(" {} unused\n", get_format_name(resource.desc.format));
+		}
+		else
+		{
+			dump.write(
+			    " {} steps {}-{} target {}\n", get_format_name(resource.desc.format),
+			    resource.first_step + 1, resource.last_step + 1, resource.alias);
+		}
+	}
+
+	dump.write("\nTransitions (attachment to sampled):\n");
+	for (u32 i = 0; i < m_transition_count; ++i)
+	{
+		const Transition& transition = m_transitions[i];
+		if (!m_resources[transition.resource].is_imported)
+		{
+			dump.write(
+			    "{}: {} -> {}\n", m_resources[transition.resource].name,
+			    m_passes[transition.writer].name, m_passes[transition.reader].name);
+		}
+	}
+
+	dump.write(
+	    "\nTargets: {}, {:.2f} MiB ({:.2f} MiB without aliasing)\n", m_alias_count,
+	    to_mib(m_aliased_bytes), to_mib(m_unaliased_bytes));
+
+	TextWriter dot{ m_dot };
+	dot.write("digraph FrameGraph {{\n\trankdir=LR;\n");
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		dot.write(
+		    "\tp{} [label=\"{}\" shape=box{}];\n", p, m_passes[p].name,
+		    m_passes[p].is_culled ? " style=dashed" : "");
+	}
+	for (u32 r = 0; r < m_resource_count; ++r)
+	{
+		const Resource& resource = m_resources[r];
+		dot.write(
+		    "\tr{} [label=\"{}\\n{}x{}\" shape=ellipse];\n", r, resource.name, resource.size.x,
+		    resource.size.y);
+	}
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		const Pass& pass = m_passes[p];
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			const auto [resource, access] = pass.accesses[i];
+			if (access == Access::READ)
+			{
+				dot.write("\tr{} -> p{};\n", resource, p);
+			}
+			else
+			{
+				dot.write("\tp{} -> r{};\n", p, resource);
+			}
+		}
+	}
+	dot.write("}}\n");
+}
+
+u64 core::FrameGraph::hash_declarations() const
+{
+	u64 hash = FNV_OFFSET;
+	hash_value(&hash, m_pass_count);
+	hash_value(&hash, m_resource_count);
+
+	for (u32 p = 0; p < m_pass_count; ++p)
+	{
+		const Pass& pass = m_passes[p];
+		hash_value(&hash, pass.name);
+		hash_value(&hash, pass.execute);
+		hash_value(&hash, pass.access_count);
+		for (u32 i = 0; i < pass.access_count; ++i)
+		{
+			hash_value(&hash, pass.accesses[i].first);
+			hash_value(&hash, pass.accesses[i].second);
+		}
+	}
+
+	for (u32 r = 0; r < m_resource_count; ++r)
+	{
+		const Resource& resource = m_resources[r];
+		hash_value(&hash, resource.name);
+		hash_value(&hash, resource.size);
+		hash_value(&hash, resource.desc.format);
+		hash_value(&hash, resource.desc.samples);
+		hash_value(&hash, resource.is_imported);
+	}
+	return hash;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "core/handle_pool.hpp"
+#include "core/render_target_pool.hpp"
+#include "core/types.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+/**
+ * The passes of a frame, declared every frame with the textures they read and
+ * write, then compiled and executed by the render thread:
+ * - culling: a pass whose outputs nobody reads is dropped, with the passes only
+ *   it depended on. Writing an imported resource (the window) keeps a pass.
+ *   A disabled effect costs neither memory nor GPU time, its pass is culled or
+ *   not declared at all.
+ * - ordering: the passes run in a topological order of their dependencies
+ *   (read after write, write after read and write), declaration order first.
+ * - aliasing: a transient texture is acquired from the RenderTargetPool before
+ *   its first pass and released after its last one, textures whose lifetimes do
+ *   not overlap share a target.
+ * - transitions: a texture written as an attachment then read by a later pass
+ *   is recorded. OpenGL 3.3 has no glMemoryBarrier, the driver orders render to
+ *   texture itself; what remains is never sampling a texture attached to the
+ *   bound framebuffer, each pass gets a framebuffer of its own writes only.
+ *
+ * The compiled plan is kept while the declarations (and the texture sizes) are
+ * the same as the frame before. Nothing allocates: the declarations live in
+ * fixed arrays and the dump for the dev UI in fixed buffers.
+ */
+namespace core
+{
+	class FrameGraph;
+	class GpuProfiler;
+
+	/** What a pass sees while it executes, its framebuffer is bound already. */
+	struct PassContext
+	{
+		const FrameGraph* graph = nullptr;
+		u32               framebuffer = 0;
+		glm::ivec2        size{ 0 };  // of the attachments, the viewport is set
+
+		[[nodiscard]] Handle<RenderTarget> get_target(u32 resource) const;
+		[[nodiscard]] glm::ivec2           get_size(u32 resource) const;
+	};
+
+	class FrameGraph
+	{
+	public:
+		using ExecuteFn = void (*)(const PassContext& context, void* data);
+
+		static constexpr u32 MAX_PASSES = 32;  // the dependencies are bit masks
+		static constexpr u32 MAX_RESOURCES = 64;
+		static constexpr u32 MAX_PASS_RESOURCES = 8;
+		static constexpr u32 MAX_TRANSITIONS = 64;
+		static constexpr u32 DUMP_SIZE = 4096;
+		static constexpr u32 INVALID_INDEX = Handle<RenderTarget>::INVALID_INDEX;
+
+		/** Each pass is a scope of the GPU profiler. */
+		FrameGraph(RenderTargetPool& render_targets, GpuProfiler& gpu_profiler);
+
+		FrameGraph(const FrameGraph& other) = delete;
+		FrameGraph& operator=(const FrameGraph& other) = delete;
+		FrameGraph(FrameGraph&& other) noexcept = delete;
+		FrameGraph& operator=(FrameGraph&& other) noexcept = delete;
+
+		/** Forgets the declarations of the previous frame, the compiled plan is kept. */
+		void reset();
+
+		/** A transient texture sized by the render target pool, the name must outlive the frame. */
+		[[nodiscard]] u32 create_texture(const char* name, const TargetDesc& desc);
+
+		/** The window, writing to it is a side effect: the pass is never culled. */
+		[[nodiscard]] u32 import_backbuffer(const char* name, i32 width, i32 height);
+
+		/** Returns INVALID_INDEX when full, reads and writes of that pass are ignored. */
+		[[nodiscard]] u32 add_pass(const char* name, ExecuteFn execute, void* data);
+
+		void read(u32 pass, u32 resource);
+
+		/** As an attachment, a pass writes one depth texture at most. */
+		void write(u32 pass, u32 resource);
+
+		/** Culls, orders and plans the lifetimes, unless nothing changed since the last frame. */
+		void compile();
+
+		void execute();
+
+		[[nodiscard]] Handle<RenderTarget> get_target(u32 resource) const;
+		[[nodiscard]] glm::ivec2           get_size(u32 resource) const;
+
+		/** Main thread. */
+		void prepare_dev_ui();
+
+	private:
+		enum class Access : u8
+		{
+			READ,
+			WRITE
+		};
+
+		struct Resource
+		{
+			const char*          name = nullptr;
+			TargetDesc           desc;
+			glm::ivec2           size{ 0 };
+			b8                   is_imported = false;
+			Handle<RenderTarget> target;
+
+			// compiled
+			u32 first_step = INVALID_INDEX;
+			u32 last_step = INVALID_INDEX;
+			u32 alias = INVALID_INDEX;  // the physical target, resources sharing one have the same
+		};
+
+		struct Pass
+		{
+			const char*                                            name = nullptr;
+			ExecuteFn                                              execute = nullptr;
+			void*                                                  data = nullptr;
+			std::array<std::pair<u32, Access>, MAX_PASS_RESOURCES> accesses{};
+			u32                                                    access_count = 0;
+
+			// compiled
+			u32 dependencies = 0;  // bit per pass that must run before
+			b8  is_culled = false;
+		};
+
+		struct Transition
+		{
+			u32 resource;
+			u32 writer;
+			u32 reader;
+		};
+
+		void add_access(u32 pass, u32 resource, Access access);
+		void cull();
+		void order();
+		void plan_lifetimes();
+		void write_dump();
+
+		[[nodiscard]] u64 hash_declarations() const;
+
+		RenderTargetPool* m_render_targets;
+		GpuProfiler*      m_gpu_profiler;
+
+		std::array<Pass, MAX_PASSES>        m_passes;
+		std::array<Resource, MAX_RESOURCES> m_resources;
+		u32                                 m_pass_count = 0;
+		u32                                 m_resource_count = 0;
+
+		// compiled plan
+		u64                                     m_compiled_hash = 0;
+		std::array<u32, MAX_PASSES>             m_order{};
+		u32                                     m_step_count = 0;
+		std::array<Transition, MAX_TRANSITIONS> m_transitions{};
+		u32                                     m_transition_count = 0;
+		u32                                     m_alias_count = 0;  // physical targets
+		std::size_t                             m_aliased_bytes = 0;
+		std::size_t                             m_unaliased_bytes = 0;
+		u32                                     m_compile_count = 0;
+
+		// written by compile, read by the dev UI
+		std::mutex                  m_dump_mutex;
+		std::array<char, DUMP_SIZE> m_dump{};
+		std::array<char, DUMP_SIZE> m_dot{};  // Graphviz
+	};
+}  // namespace core
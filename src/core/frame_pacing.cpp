@@ -0,0 +1,405 @@
+#include "core/frame_pacing.hpp"
+
+#include "core/event_handler.hpp"
+#include "core/timing.hpp"
+
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr std::array<const char*, static_cast<u32>(SwapMode::COUNT)> SWAP_MODE_NAMES = {
+		"Vsync",
+		"Adaptive vsync",
+		"Off",
+	};
+
+	// a GPU frame taking longer is hung or lost, it is not waited for any more
+	static constexpr u64 FENCE_TIMEOUT_NS = 1'000'000'000;
+
+	// weight of the last frame in the average wake up error
+	static constexpr f64 WAKE_ERROR_SMOOTHING = 0.05;
+
+	static const char* get_swap_mode_name(SwapMode swap_mode)
+	{
+		return swap_mode < SwapMode::COUNT ? SWAP_MODE_NAMES[static_cast<u32>(swap_mode)]
+		                                   : "Unknown";
+	}
+
+	static i32 get_swap_interval(SwapMode swap_mode)
+	{
+		switch (swap_mode)
+		{
+			case SwapMode::ADAPTIVE:
+				return -1;
+			case SwapMode::OFF:
+				return 0;
+			default:
+				return 1;
+		}
+	}
+
+	static f64 to_ms(u64 duration_ns)
+	{
+		return static_cast<f64>(duration_ns) / 1e6;
+	}
+
+	static u64 to_frame_ns(u32 fps)
+	{
+		return fps > 0 ? 1'000'000'000 / fps : 0;
+	}
+
+	static i32 to_fps(u64 frame_ns)
+	{
+		return frame_ns > 0 ? static_cast<i32>(std::lround(1e9 / static_cast<f64>(frame_ns))) : 0;
+	}
+}  // namespace
+
+core::FramePacer::FramePacer(const Config& config)
+    : m_spin_ms{ std::clamp(config.spin_ms, 0.0, MAX_SPIN_MS) }
+    , m_is_render_on_demand{ config.is_render_on_demand }
+    , m_requested_swap_mode{ config.swap_mode }
+    , m_active_swap_mode{ config.swap_mode }
+    , m_max_gpu_frames_ahead{ std::min(config.max_gpu_frames_ahead, MAX_GPU_FRAMES_AHEAD) }
+{
+	set_target_fps(config.target_fps);
+	set_background_fps(config.background_fps);
+	set_unfocused_fps(config.unfocused_fps);
+}
+
+u64 core::FramePacer::get_idle_wait_ns() const
+{
+	const b8 is_idle =
+	    !m_is_window_visible ||
+	    (m_is_render_on_demand && m_clean_frame_count > ON_DEMAND_EXTRA_FRAMES);
+
+	return is_idle ? m_background_frame_ns : 0;
+}
+
+void core::FramePacer::set_window_state(const WindowState& window_state)
+{
+	if (window_state.is_visible() != m_is_window_visible)
+	{
+		SPDLOG_DEBUG("Window {}.", window_state.is_visible() ? "visible" : "hidden, drawing stops");
+	}
+
+	m_is_window_visible = window_state.is_visible();
+	m_is_window_focused = window_state.is_focused;
+}
+
+b8 core::FramePacer::should_draw_frame(b8 is_frame_dirty)
+{
+	// counted up to the first idle frame only
+	if (is_frame_dirty)
+	{
+		m_clean_frame_count = 0;
+	}
+	else if (m_clean_frame_count <= ON_DEMAND_EXTRA_FRAMES)
+	{
+		++m_clean_frame_count;
+	}
+
+	const b8 should_draw =
+	    m_is_window_visible &&
+	    (!m_is_render_on_demand || m_clean_frame_count <= ON_DEMAND_EXTRA_FRAMES);
+
+	m_skipped_frame_count += should_draw ? 0 : 1;
+	return should_draw;
+}
+
+void core::FramePacer::limit_frame_rate()
+{
+	const u64 frame_ns = get_frame_ns();
+	if (frame_ns == 0)
+	{
+		m_next_deadline_ns = 0;
+		return;
+	}
+
+	ZoneScopedN("Limit frame rate");
+
+	const u64 deadline_ns = m_next_deadline_ns;
+	u64       now_ns = timing::get_ticks_ns();
+
+	// late, the cadence starts over: catching up would cram the next frames together
+	if (deadline_ns == 0 || now_ns >= deadline_ns)
+	{
+		m_missed_deadline_count += deadline_ns != 0 ? 1 : 0;
+		m_next_deadline_ns = now_ns + frame_ns;
+		return;
+	}
+
+	timing::PhaseScope phase{ timing::Phase::PACE };
+
+	const auto spin_ns = static_cast<u64>(m_spin_ms * 1e6);
+	if (deadline_ns - now_ns > spin_ns)
+	{
+		SDL_DelayNS(deadline_ns - now_ns - spin_ns);
+	}
+
+	while ((now_ns = timing::get_ticks_ns()) < deadline_ns)
+	{
+		std::this_thread::yield();
+	}
+
+	const f64 wake_error_ms = to_ms(now_ns - deadline_ns);
+	m_average_wake_error_ms += (wake_error_ms - m_average_wake_error_ms) * WAKE_ERROR_SMOOTHING;
+	m_max_wake_error_ms = std::max(m_max_wake_error_ms, wake_error_ms);
+
+	// from the deadline, not from the wake up: the errors do not add up
+	m_next_deadline_ns = deadline_ns + frame_ns;
+}
+
+void core::FramePacer::begin_gpu_frame()
+{
+	const SwapMode requested_swap_mode = m_requested_swap_mode.load(std::memory_order_relaxed);
+	if (requested_swap_mode != m_last_request)
+	{
+		apply_swap_mode(requested_swap_mode);
+		m_last_request = requested_swap_mode;
+	}
+
+	ZoneScopedN("Wait for GPU");
+
+	const u64 start_ns = timing::get_ticks_ns();
+
+	const u32 max_gpu_frames_ahead = m_max_gpu_frames_ahead.load(std::memory_order_relaxed);
+	while (m_fence_count > max_gpu_frames_ahead)
+	{
+		wait_for_oldest_fence();
+	}
+
+	const u64 wait_ns = timing::get_ticks_ns() - start_ns;
+	timing::add_phase_time(timing::Phase::GPU_WAIT, wait_ns);
+	m_gpu_wait_ns.store(wait_ns, std::memory_order_relaxed);
+}
+
+void core::FramePacer::end_gpu_frame()
+{
+	// only when the limit was raised between begin_gpu_frame and here
+	if (m_fence_count == m_fences.size())
+	{
+		wait_for_oldest_fence();
+	}
+
+	const u32 index = (m_first_fence + m_fence_count) % m_fences.size();
+	m_fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	++m_fence_count;
+}
+
+void core::FramePacer::release_gpu_frames()
+{
+	for (; m_fence_count > 0; --m_fence_count)
+	{
+		glDeleteSync(static_cast<GLsync>(m_fences[m_first_fence]));
+		m_first_fence = (m_first_fence + 1) % m_fences.size();
+	}
+
+	// a context made current again may have another swap interval
+	m_last_request = SwapMode::COUNT;
+}
+
+void core::FramePacer::set_swap_mode(SwapMode swap_mode)
+{
+	if (swap_mode >= SwapMode::COUNT)
+	{
+		SPDLOG_WARN("Unknown swap mode {}, ignored.", static_cast<u32>(swap_mode));
+		return;
+	}
+
+	m_requested_swap_mode.store(swap_mode, std::memory_order_relaxed);
+}
+
+void core::FramePacer::set_target_fps(u32 target_fps)
+{
+	if (target_fps > MAX_TARGET_FPS)
+	{
+		SPDLOG_WARN("Target of {} fps above {}, clamped.", target_fps, MAX_TARGET_FPS);
+		target_fps = MAX_TARGET_FPS;
+	}
+
+	m_frame_ns = to_frame_ns(target_fps);
+	m_next_deadline_ns = 0;
+}
+
+void core::FramePacer::set_background_fps(u32 background_fps)
+{
+	if (background_fps < MIN_BACKGROUND_FPS || background_fps > MAX_BACKGROUND_FPS)
+	{
+		SPDLOG_WARN(
+		    "Background rate of {} fps outside of [{}, {}], clamped.", background_fps,
+		    MIN_BACKGROUND_FPS, MAX_BACKGROUND_FPS);
+		background_fps = std::clamp(background_fps, MIN_BACKGROUND_FPS, MAX_BACKGROUND_FPS);
+	}
+
+	m_background_frame_ns = to_frame_ns(background_fps);
+}
+
+void core::FramePacer::set_unfocused_fps(u32 unfocused_fps)
+{
+	if (unfocused_fps > MAX_TARGET_FPS)
+	{
+		SPDLOG_WARN("Unfocused rate of {} fps above {}, clamped.", unfocused_fps, MAX_TARGET_FPS);
+		unfocused_fps = MAX_TARGET_FPS;
+	}
+
+	m_unfocused_frame_ns = to_frame_ns(unfocused_fps);
+}
+
+void core::FramePacer::set_max_gpu_frames_ahead(u32 max_gpu_frames_ahead)
+{
+	m_max_gpu_frames_ahead.store(
+	    std::min(max_gpu_frames_ahead, MAX_GPU_FRAMES_AHEAD), std::memory_order_relaxed);
+}
+
+void core::FramePacer::prepare_dev_ui()
+{
+	ZoneScopedN("Frame pacer prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Frame pacing"))
+	{
+		const SwapMode requested_swap_mode = m_requested_swap_mode.load(std::memory_order_relaxed);
+		const SwapMode active_swap_mode = m_active_swap_mode.load(std::memory_order_relaxed);
+
+		if (ImGui::BeginCombo("Swap mode", get_swap_mode_name(requested_swap_mode)))
+		{
+			for (u32 i = 0; i < SWAP_MODE_NAMES.size(); ++i)
+			{
+				const auto swap_mode = static_cast<SwapMode>(i);
+				if (ImGui::Selectable(SWAP_MODE_NAMES[i], swap_mode == requested_swap_mode))
+				{
+					set_swap_mode(swap_mode);
+				}
+			}
+			ImGui::EndCombo();
+		}
+		if (active_swap_mode != requested_swap_mode)
+		{
+			ImGui::Text("Active: %s", get_swap_mode_name(active_swap_mode));
+		}
+
+		i32 target_fps = to_fps(m_frame_ns);
+		if (ImGui::SliderInt("Target FPS", &target_fps, 0, 360, target_fps > 0 ? "%d" : "Off"))
+		{
+			set_target_fps(static_cast<u32>(std::max(target_fps, 0)));
+		}
+
+		i32 unfocused_fps = to_fps(m_unfocused_frame_ns);
+		if (ImGui::SliderInt(
+		        "Unfocused FPS", &unfocused_fps, 0, 120, unfocused_fps > 0 ? "%d" : "Off"))
+		{
+			set_unfocused_fps(static_cast<u32>(std::max(unfocused_fps, 0)));
+		}
+
+		i32 background_fps = to_fps(m_background_frame_ns);
+		if (ImGui::SliderInt(
+		        "Background FPS", &background_fps, static_cast<i32>(MIN_BACKGROUND_FPS),
+		        static_cast<i32>(MAX_BACKGROUND_FPS)))
+		{
+			set_background_fps(static_cast<u32>(background_fps));
+		}
+
+		ImGui::Checkbox("Render on demand", &m_is_render_on_demand);
+
+		auto spin_ms = static_cast<f32>(m_spin_ms);
+		if (ImGui::SliderFloat(
+		        "Spin before deadline", &spin_ms, 0.0f, static_cast<f32>(MAX_SPIN_MS), "%.1f ms"))
+		{
+			m_spin_ms = spin_ms;
+		}
+
+		i32 max_gpu_frames_ahead =
+		    static_cast<i32>(m_max_gpu_frames_ahead.load(std::memory_order_relaxed));
+		if (ImGui::SliderInt(
+		        "Max GPU frames ahead", &max_gpu_frames_ahead, 0,
+		        static_cast<i32>(MAX_GPU_FRAMES_AHEAD)))
+		{
+			set_max_gpu_frames_ahead(static_cast<u32>(max_gpu_frames_ahead));
+		}
+
+		ImGui::Text(
+		    "Wake up error: %.3f ms average, %.3f ms max", m_average_wake_error_ms,
+		    m_max_wake_error_ms);
+		ImGui::Text(
+		    "Missed deadlines: %llu", static_cast<unsigned long long>(m_missed_deadline_count));
+		ImGui::Text("GPU wait: %.3f ms", to_ms(m_gpu_wait_ns.load(std::memory_order_relaxed)));
+		ImGui::Text("Window: %s", m_is_window_focused ? "focused" : "unfocused");
+		ImGui::Text("Skipped frames: %llu", static_cast<unsigned long long>(m_skipped_frame_count));
+
+		if (ImGui::Button("Reset statistics"))
+		{
+			m_average_wake_error_ms = 0.0;
+			m_max_wake_error_ms = 0.0;
+			m_missed_deadline_count = 0;
+			m_skipped_frame_count = 0;
+		}
+	}
+}
+
+u64 core::FramePacer::get_frame_ns() const
+{
+	// the slower of the two limits, 0 is unlimited
+	if (m_is_window_focused || m_unfocused_frame_ns == 0)
+	{
+		return m_frame_ns;
+	}
+	return std::max(m_frame_ns, m_unfocused_frame_ns);
+}
+
+void core::FramePacer::apply_swap_mode(SwapMode swap_mode)
+{
+	SwapMode active_swap_mode = swap_mode;
+
+	if (!SDL_GL_SetSwapInterval(get_swap_interval(swap_mode)))
+	{
+		if (swap_mode == SwapMode::ADAPTIVE && SDL_GL_SetSwapInterval(1))
+		{
+			SPDLOG_WARN("Adaptive vsync is not supported ({}), vsync instead.", SDL_GetError());
+			active_swap_mode = SwapMode::VSYNC;
+		}
+		else
+		{
+			SPDLOG_ERROR(
+			    "Could not set the swap mode to {}: {}", get_swap_mode_name(swap_mode),
+			    SDL_GetError());
+
+			i32 interval = 0;
+			SDL_GL_GetSwapInterval(&interval);
+			active_swap_mode = interval < 0    ? SwapMode::ADAPTIVE
+			                   : interval == 0 ? SwapMode::OFF
+			                                   : SwapMode::VSYNC;
+		}
+	}
+	else
+	{
+		SPDLOG_INFO("Swap mode: {}.", get_swap_mode_name(swap_mode));
+	}
+
+	m_active_swap_mode.store(active_swap_mode, std::memory_order_relaxed);
+}
+
+void core::FramePacer::wait_for_oldest_fence()
+{
+	auto fence = static_cast<GLsync>(m_fences[m_first_fence]);
+
+	// the flush makes sure the fence reaches the GPU, it would never signal otherwise
+	const GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+	if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+	{
+		SPDLOG_WARN(
+		    "GPU frame not done after {} ms, no longer waiting for it.", to_ms(FENCE_TIMEOUT_NS));
+	}
+
+	glDeleteSync(fence);
+	m_first_fence = (m_first_fence + 1) % m_fences.size();
+	--m_fence_count;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+
+/**
+ * Frame pacing, for a low input to display latency and even frame times:
+ * - the swap interval (vsync, adaptive vsync which tears instead of waiting
+ *   for a late frame, or off), the driver default is never relied upon,
+ * - a frame rate limiter on the main thread, it sleeps until shortly before
+ *   the deadline then spins for the rest (the OS wakes up late by up to a few
+ *   milliseconds) and does so before the input is polled, not after it,
+ * - a fence after every swap on the render thread, at most
+ *   `max_gpu_frames_ahead` frames are queued in the driver before the next one
+ *   is submitted. Without it the driver buffers frames at will and each one
+ *   adds a refresh of latency.
+ *
+ * Idle frames are throttled as well: nothing is drawn while the window is
+ * hidden (minimized, occluded) and the loop blocks on the event queue between
+ * `background_fps` wake ups, an unfocused window is limited to `unfocused_fps`.
+ * In render on demand mode, frames are only drawn when input, an animation or
+ * a reload dirtied them, and a few more for the dev UI to settle.
+ */
+namespace core
+{
+	struct WindowState;
+
+	enum class SwapMode : u8
+	{
+		VSYNC,
+		ADAPTIVE,
+		OFF,
+		COUNT
+	};
+
+	class FramePacer
+	{
+	public:
+		struct Config
+		{
+			SwapMode swap_mode = SwapMode::VSYNC;
+			u32      target_fps = 0;  // 0 does not limit
+			u32      max_gpu_frames_ahead = 1;
+			f64      spin_ms = 2.0;  // before the deadline, spent spinning instead of sleeping
+			u32      background_fps = 4;  // hidden window, or clean frames on demand
+			u32      unfocused_fps = 30;  // 0 does not limit
+			b8       is_render_on_demand = false;
+		};
+
+		static constexpr u32 MAX_TARGET_FPS = 1000;
+		static constexpr u32 MAX_GPU_FRAMES_AHEAD = 3;
+		static constexpr f64 MAX_SPIN_MS = 10.0;
+		static constexpr u32 MIN_BACKGROUND_FPS = 1;
+		static constexpr u32 MAX_BACKGROUND_FPS = 60;
+
+		// drawn after the last dirty one, the dev UI reacts to input a frame late
+		static constexpr u32 ON_DEMAND_EXTRA_FRAMES = 3;
+
+		explicit FramePacer(const Config& config);
+
+		FramePacer(const FramePacer& other) = delete;
+		FramePacer& operator=(const FramePacer& other) = delete;
+		FramePacer(FramePacer&& other) noexcept = delete;
+		FramePacer& operator=(FramePacer&& other) noexcept = delete;
+
+		/** Main thread, before the input is polled: how long to wait for events, 0 not at all. */
+		[[nodiscard]] u64 get_idle_wait_ns() const;
+
+		/** Main thread, once the input is collected. */
+		void set_window_state(const WindowState& window_state);
+
+		/** Main thread, after the update: false skips the UI and the rendering of the frame. */
+		[[nodiscard]] b8 should_draw_frame(b8 is_frame_dirty);
+
+		/** Main thread, at the end of a drawn frame: waits for the target frame time. */
+		void limit_frame_rate();
+
+		/**
+		 * Render thread, before submitting a frame: applies a new swap mode and waits for
+		 * the GPU to catch up.
+		 */
+		void begin_gpu_frame();
+
+		/** Render thread, after the swap. */
+		void end_gpu_frame();
+
+		/** Render thread, before it gives the OpenGL context away. */
+		void release_gpu_frames();
+
+		void set_swap_mode(SwapMode swap_mode);
+		void set_target_fps(u32 target_fps);
+		void set_max_gpu_frames_ahead(u32 max_gpu_frames_ahead);
+		void set_background_fps(u32 background_fps);
+		void set_unfocused_fps(u32 unfocused_fps);
+
+		void prepare_dev_ui();
+
+	private:
+		[[nodiscard]] u64 get_frame_ns() const;
+
+		void apply_swap_mode(SwapMode swap_mode);
+		void wait_for_oldest_fence();
+
+		// main thread
+		u64 m_frame_ns = 0;
+		u64 m_background_frame_ns = 0;
+		u64 m_unfocused_frame_ns = 0;
+		f64 m_spin_ms;
+		u64 m_next_deadline_ns = 0;
+		f64 m_average_wake_error_ms = 0.0;
+		f64 m_max_wake_error_ms = 0.0;
+		u64 m_missed_deadline_count = 0;
+		u32 m_clean_frame_count = 0;
+		u64 m_skipped_frame_count = 0;
+		b8  m_is_window_visible = true;
+		b8  m_is_window_focused = true;
+		b8  m_is_render_on_demand;
+
+		// written by the main thread, applied by the render thread
+		std::atomic<SwapMode> m_requested_swap_mode;
+		std::atomic<SwapMode> m_active_swap_mode;
+		std::atomic<u32>      m_max_gpu_frames_ahead;
+		std::atomic<u64>      m_gpu_wait_ns = 0;
+
+		// render thread, a ring of GLsync (glad stays out of the headers)
+		std::array<void*, MAX_GPU_FRAMES_AHEAD + 1> m_fences{};
+		u32                                         m_first_fence = 0;
+		u32                                         m_fence_count = 0;
+		SwapMode                                    m_last_request = SwapMode::COUNT;
+	};
+}  // namespace core
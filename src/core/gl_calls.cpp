@@ -0,0 +1,495 @@
+#include "core/gl_calls.hpp"
+
+#ifdef COUNT_GL_CALLS
+
+#include "utils/helper_macros.hpp"
+
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+// every entry point of the glad loader (OpenGL 3.3 core), without the gl prefix
+#define GL_ENTRY_POINTS(X) \
+	X(ActiveTexture) X(AttachShader) X(BeginConditionalRender) X(BeginQuery) \
+	X(BeginTransformFeedback) X(BindAttribLocation) X(BindBuffer) X(BindBufferBase) \
+	X(BindBufferRange) X(BindFragDataLocation) X(BindFragDataLocationIndexed) \
+	X(BindFramebuffer) X(BindRenderbuffer) X(BindSampler) X(BindTexture) X(BindVertexArray) \
+	X(BlendColor) X(BlendEquation) X(BlendEquationSeparate) X(BlendFunc) \
+	X(BlendFuncSeparate) X(BlitFramebuffer) X(BufferData) X(BufferSubData) \
+	X(CheckFramebufferStatus) X(ClampColor) X(Clear) X(ClearBufferfi) X(ClearBufferfv) \
+	X(ClearBufferiv) X(ClearBufferuiv) X(ClearColor) X(ClearDepth) X(ClearStencil) \
+	X(ClientWaitSync) X(ColorMask) X(ColorMaski) X(CompileShader) X(CompressedTexImage1D) \
+	X(CompressedTexImage2D) X(CompressedTexImage3D) X(CompressedTexSubImage1D) \
+	X(CompressedTexSubImage2D) X(CompressedTexSubImage3D) X(CopyBufferSubData) \
+	X(CopyTexImage1D) X(CopyTexImage2D) X(CopyTexSubImage1D) X(CopyTexSubImage2D) \
+	X(CopyTexSubImage3D) X(CreateProgram) X(CreateShader) X(CullFace) X(DeleteBuffers) \
+	X(DeleteFramebuffers) X(DeleteProgram) X(DeleteQueries) X(DeleteRenderbuffers) \
+	X(DeleteSamplers) X(DeleteShader) X(DeleteSync) X(DeleteTextures) X(DeleteVertexArrays) \
+	X(DepthFunc) X(DepthMask) X(DepthRange) X(DetachShader) X(Disable) \
+	X(DisableVertexAttribArray) X(Disablei) X(DrawArrays) X(DrawArraysInstanced) \
+	X(DrawBuffer) X(DrawBuffers) X(DrawElements) X(DrawElementsBaseVertex) \
+	X(DrawElementsInstanced) X(DrawElementsInstancedBaseVertex) X(DrawRangeElements) \
+	X(DrawRangeElementsBaseVertex) X(Enable) X(EnableVertexAttribArray) X(Enablei) \
+	X(EndConditionalRender) X(EndQuery) X(EndTransformFeedback) X(FenceSync) X(Finish) \
+	X(Flush) X(FlushMappedBufferRange) X(FramebufferRenderbuffer) X(FramebufferTexture) \
+	X(FramebufferTexture1D) X(FramebufferTexture2D) X(FramebufferTexture3D) \
+	X(FramebufferTextureLayer) X(FrontFace) X(GenBuffers) X(GenFramebuffers) X(GenQueries) \
+	X(GenRenderbuffers) X(GenSamplers) X(GenTextures) X(GenVertexArrays) X(GenerateMipmap) \
+	X(GetActiveAttrib) X(GetActiveUniform) X(GetActiveUniformBlockName) \
+	X(GetActiveUniformBlockiv) X(GetActiveUniformName) X(GetActiveUniformsiv) \
+	X(GetAttachedShaders) X(GetAttribLocation) X(GetBooleani_v) X(GetBooleanv) \
+	X(GetBufferParameteri64v) X(GetBufferParameteriv) X(GetBufferPointerv) \
+	X(GetBufferSubData) X(GetCompressedTexImage) X(GetDoublev) X(GetError) X(GetFloatv) \
+	X(GetFragDataIndex) X(GetFragDataLocation) X(GetFramebufferAttachmentParameteriv) \
+	X(GetInteger64i_v) X(GetInteger64v) X(GetIntegeri_v) X(GetIntegerv) X(GetMultisamplefv) \
+	X(GetProgramInfoLog) X(GetProgramiv) X(GetQueryObjecti64v) X(GetQueryObjectiv) \
+	X(GetQueryObjectui64v) X(GetQueryObjectuiv) X(GetQueryiv) X(GetRenderbufferParameteriv) \
+	X(GetSamplerParameterIiv) X(GetSamplerParameterIuiv) X(GetSamplerParameterfv) \
+	X(GetSamplerParameteriv) X(GetShaderInfoLog) X(GetShaderSource) X(GetShaderiv) \
+	X(GetString) X(GetStringi) X(GetSynciv) X(GetTexImage) X(GetTexLevelParameterfv) \
+	X(GetTexLevelParameteriv) X(GetTexParameterIiv) X(GetTexParameterIuiv) \
+	X(GetTexParameterfv) X(GetTexParameteriv) X(GetTransformFeedbackVarying) \
+	X(GetUniformBlockIndex) X(GetUniformIndices) X(GetUniformLocation) X(GetUniformfv) \
+	X(GetUniformiv) X(GetUniformuiv) X(GetVertexAttribIiv) X(GetVertexAttribIuiv) \
+	X(GetVertexAttribPointerv) X(GetVertexAttribdv) X(GetVertexAttribfv) \
+	X(GetVertexAttribiv) X(Hint) X(IsBuffer) X(IsEnabled) X(IsEnabledi) X(IsFramebuffer) \
+	X(IsProgram) X(IsQuery) X(IsRenderbuffer) X(IsSampler) X(IsShader) X(IsSync) \
+	X(IsTexture) X(IsVertexArray) X(LineWidth) X(LinkProgram) X(LogicOp) X(MapBuffer) \
+	X(MapBufferRange) X(MultiDrawArrays) X(MultiDrawElements) X(MultiDrawElementsBaseVertex) \
+	X(PixelStoref) X(PixelStorei) X(PointParameterf) X(PointParameterfv) X(PointParameteri) \
+	X(PointParameteriv) X(PointSize) X(PolygonMode) X(PolygonOffset) \
+	X(PrimitiveRestartIndex) X(ProvokingVertex) X(QueryCounter) X(ReadBuffer) X(ReadPixels) \
+	X(RenderbufferStorage) X(RenderbufferStorageMultisample) X(SampleCoverage) \
+	X(SampleMaski) X(SamplerParameterIiv) X(SamplerParameterIuiv) X(SamplerParameterf) \
+	X(SamplerParameterfv) X(SamplerParameteri) X(SamplerParameteriv) X(Scissor) \
+	X(ShaderSource) X(StencilFunc) X(StencilFuncSeparate) X(StencilMask) \
+	X(StencilMaskSeparate) X(StencilOp) X(StencilOpSeparate) X(TexBuffer) X(TexImage1D) \
+	X(TexImage2D) X(TexImage2DMultisample) X(TexImage3D) X(TexImage3DMultisample) \
+	X(TexParameterIiv) X(TexParameterIuiv) X(TexParameterf) X(TexParameterfv) \
+	X(TexParameteri) X(TexParameteriv) X(TexSubImage1D) X(TexSubImage2D) X(TexSubImage3D) \
+	X(TransformFeedbackVaryings) X(Uniform1f) X(Uniform1fv) X(Uniform1i) X(Uniform1iv) \
+	X(Uniform1ui) X(Uniform1uiv) X(Uniform2f) X(Uniform2fv) X(Uniform2i) X(Uniform2iv) \
+	X(Uniform2ui) X(Uniform2uiv) X(Uniform3f) X(Uniform3fv) X(Uniform3i) X(Uniform3iv) \
+	X(Uniform3ui) X(Uniform3uiv) X(Uniform4f) X(Uniform4fv) X(Uniform4i) X(Uniform4iv) \
+	X(Uniform4ui) X(Uniform4uiv) X(UniformBlockBinding) X(UniformMatrix2fv) \
+	X(UniformMatrix2x3fv) X(UniformMatrix2x4fv) X(UniformMatrix3fv) X(UniformMatrix3x2fv) \
+	X(UniformMatrix3x4fv) X(UniformMatrix4fv) X(UniformMatrix4x2fv) X(UniformMatrix4x3fv) \
+	X(UnmapBuffer) X(UseProgram) X(ValidateProgram) X(VertexAttrib1d) X(VertexAttrib1dv) \
+	X(VertexAttrib1f) X(VertexAttrib1fv) X(VertexAttrib1s) X(VertexAttrib1sv) \
+	X(VertexAttrib2d) X(VertexAttrib2dv) X(VertexAttrib2f) X(VertexAttrib2fv) \
+	X(VertexAttrib2s) X(VertexAttrib2sv) X(VertexAttrib3d) X(VertexAttrib3dv) \
+	X(VertexAttrib3f) X(VertexAttrib3fv) X(VertexAttrib3s) X(VertexAttrib3sv) \
+	X(VertexAttrib4Nbv) X(VertexAttrib4Niv) X(VertexAttrib4Nsv) X(VertexAttrib4Nub) \
+	X(VertexAttrib4Nubv) X(VertexAttrib4Nuiv) X(VertexAttrib4Nusv) X(VertexAttrib4bv) \
+	X(VertexAttrib4d) X(VertexAttrib4dv) X(VertexAttrib4f) X(VertexAttrib4fv) \
+	X(VertexAttrib4iv) X(VertexAttrib4s) X(VertexAttrib4sv) X(VertexAttrib4ubv) \
+	X(VertexAttrib4uiv) X(VertexAttrib4usv) X(VertexAttribDivisor) X(VertexAttribI1i) \
+	X(VertexAttribI1iv) X(VertexAttribI1ui) X(VertexAttribI1uiv) X(VertexAttribI2i) \
+	X(VertexAttribI2iv) X(VertexAttribI2ui) X(VertexAttribI2uiv) X(VertexAttribI3i) \
+	X(VertexAttribI3iv) X(VertexAttribI3ui) X(VertexAttribI3uiv) X(VertexAttribI4bv) \
+	X(VertexAttribI4i) X(VertexAttribI4iv) X(VertexAttribI4sv) X(VertexAttribI4ubv) \
+	X(VertexAttribI4ui) X(VertexAttribI4uiv) X(VertexAttribI4usv) X(VertexAttribIPointer) \
+	X(VertexAttribP1ui) X(VertexAttribP1uiv) X(VertexAttribP2ui) X(VertexAttribP2uiv) \
+	X(VertexAttribP3ui) X(VertexAttribP3uiv) X(VertexAttribP4ui) X(VertexAttribP4uiv) \
+	X(VertexAttribPointer) X(Viewport) X(WaitSync)
+
+namespace
+{
+	using namespace core;
+
+	enum class EntryPoint : u16
+	{
+#define GL_ENTRY_POINT_ENUM(name) name,
+		GL_ENTRY_POINTS(GL_ENTRY_POINT_ENUM)
+#undef GL_ENTRY_POINT_ENUM
+		COUNT
+	};
+
+	static constexpr u32 ENTRY_POINT_COUNT = static_cast<u32>(EntryPoint::COUNT);
+
+	static constexpr std::array<const char*, ENTRY_POINT_COUNT> ENTRY_POINT_NAMES = {
+#define GL_ENTRY_POINT_NAME(name) "gl" #name,
+		GL_ENTRY_POINTS(GL_ENTRY_POINT_NAME)
+#undef GL_ENTRY_POINT_NAME
+	};
+
+	struct Counters
+	{
+		gl_calls::FrameCounters            totals;
+		std::array<u32, ENTRY_POINT_COUNT> calls{};
+	};
+
+	// counted by the thread owning the context, a single one at a time
+	static Counters g_current;
+
+	// the last frame
+	static std::mutex g_published_mutex;
+	static Counters   g_published;
+
+	static u64 get_triangle_count(GLenum mode, i64 vertex_count)
+	{
+		switch (mode)
+		{
+		case GL_TRIANGLES:
+			return static_cast<u64>(std::max<i64>(vertex_count / 3, 0));
+		case GL_TRIANGLE_STRIP:
+		case GL_TRIANGLE_FAN:
+			return static_cast<u64>(std::max<i64>(vertex_count - 2, 0));
+		case GL_TRIANGLES_ADJACENCY:
+			return static_cast<u64>(std::max<i64>(vertex_count / 6, 0));
+		case GL_TRIANGLE_STRIP_ADJACENCY:
+			return static_cast<u64>(std::max<i64>((vertex_count - 4) / 2, 0));
+		default:
+			return 0;  // points and lines
+		}
+	}
+
+	static u64 get_pixel_size(GLenum format, GLenum type)
+	{
+		// the packed types hold the whole pixel
+		switch (type)
+		{
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_10_10_10_2:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			return 4;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+		default:
+			break;
+		}
+
+		u64 component_size = 4;
+		if (type == GL_UNSIGNED_BYTE || type == GL_BYTE)
+		{
+			component_size = 1;
+		}
+		else if (type == GL_UNSIGNED_SHORT || type == GL_SHORT || type == GL_HALF_FLOAT)
+		{
+			component_size = 2;
+		}
+
+		switch (format)
+		{
+		case GL_RG:
+		case GL_RG_INTEGER:
+		case GL_DEPTH_STENCIL:
+			return component_size * 2;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			return component_size * 3;
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+		case GL_BGRA_INTEGER:
+			return component_size * 4;
+		default:
+			return component_size;  // a single channel, depth or stencil
+		}
+	}
+
+	// tightly packed, the unpack row length and alignment are not taken into account
+	static u64 get_image_size(i64 width, i64 height, i64 depth, GLenum format, GLenum type)
+	{
+		return static_cast<u64>(std::max<i64>(width * height * depth, 0)) *
+		       get_pixel_size(format, type);
+	}
+
+	static void add_draw(GLenum mode, i64 vertex_count, i64 instance_count)
+	{
+		++g_current.totals.draw_calls;
+		g_current.totals.triangles += get_triangle_count(mode, vertex_count) *
+		                              static_cast<u64>(std::max<i64>(instance_count, 0));
+	}
+
+	static void add_multi_draw(GLenum mode, const GLsizei* counts, GLsizei draw_count)
+	{
+		for (GLsizei i = 0; i < draw_count; ++i)
+		{
+			add_draw(mode, counts[i], 1);
+		}
+	}
+
+	static void add_texture_upload(const void* pixels, u64 bytes)
+	{
+		g_current.totals.texture_upload_bytes += pixels != nullptr ? bytes : 0;
+	}
+
+	template<EntryPoint ENTRY_POINT, typename... Args>
+	static void count_call(const Args&... args)
+	{
+		using enum EntryPoint;
+
+		++g_current.totals.calls;
+		++g_current.calls[static_cast<u32>(ENTRY_POINT)];
+
+		[[maybe_unused]] const std::tuple<const Args&...> a{ args... };
+		gl_calls::FrameCounters&                          totals = g_current.totals;
+
+		// draws
+		if constexpr (ENTRY_POINT == DrawArrays)
+		{
+			add_draw(std::get<0>(a), std::get<2>(a), 1);
+		}
+		else if constexpr (ENTRY_POINT == DrawArraysInstanced)
+		{
+			add_draw(std::get<0>(a), std::get<2>(a), std::get<3>(a));
+		}
+		else if constexpr (ENTRY_POINT == DrawElements || ENTRY_POINT == DrawElementsBaseVertex)
+		{
+			add_draw(std::get<0>(a), std::get<1>(a), 1);
+		}
+		else if constexpr (
+		    ENTRY_POINT == DrawElementsInstanced || ENTRY_POINT == DrawElementsInstancedBaseVertex)
+		{
+			add_draw(std::get<0>(a), std::get<1>(a), std::get<4>(a));
+		}
+		else if constexpr (
+		    ENTRY_POINT == DrawRangeElements || ENTRY_POINT == DrawRangeElementsBaseVertex)
+		{
+			add_draw(std::get<0>(a), std::get<3>(a), 1);
+		}
+		else if constexpr (ENTRY_POINT == MultiDrawArrays)
+		{
+			add_multi_draw(std::get<0>(a), std::get<2>(a), std::get<3>(a));
+		}
+		else if constexpr (
+		    ENTRY_POINT == MultiDrawElements || ENTRY_POINT == MultiDrawElementsBaseVertex)
+		{
+			add_multi_draw(std::get<0>(a), std::get<1>(a), std::get<4>(a));
+		}
+		// buffer uploads
+		else if constexpr (ENTRY_POINT == BufferData)
+		{
+			totals.buffer_upload_bytes +=
+			    std::get<2>(a) != nullptr ? static_cast<u64>(std::get<1>(a)) : 0;
+		}
+		else if constexpr (ENTRY_POINT == BufferSubData)
+		{
+			totals.buffer_upload_bytes +=
+			    std::get<3>(a) != nullptr ? static_cast<u64>(std::get<2>(a)) : 0;
+		}
+		// texture uploads
+		else if constexpr (ENTRY_POINT == TexImage1D)
+		{
+			const u64 bytes = get_image_size(std::get<3>(a), 1, 1, std::get<5>(a), std::get<6>(a));
+			add_texture_upload(std::get<7>(a), bytes);
+		}
+		else if constexpr (ENTRY_POINT == TexImage2D)
+		{
+			const u64 bytes =
+			    get_image_size(std::get<3>(a), std::get<4>(a), 1, std::get<6>(a), std::get<7>(a));
+			add_texture_upload(std::get<8>(a), bytes);
+		}
+		else if constexpr (ENTRY_POINT == TexImage3D)
+		{
+			const u64 bytes = get_image_size(
+			    std::get<3>(a), std::get<4>(a), std::get<5>(a), std::get<7>(a), std::get<8>(a));
+			add_texture_upload(std::get<9>(a), bytes);
+		}
+		else if constexpr (ENTRY_POINT == TexSubImage1D)
+		{
+			const u64 bytes = get_image_size(std::get<3>(a), 1, 1, std::get<4>(a), std::get<5>(a));
+			add_texture_upload(std::get<6>(a), bytes);
+		}
+		else if constexpr (ENTRY_POINT == TexSubImage2D)
+		{
+			const u64 bytes =
+			    get_image_size(std::get<4>(a), std::get<5>(a), 1, std::get<6>(a), std::get<7>(a));
+			add_texture_upload(std::get<8>(a), bytes);
+		}
+		else if constexpr (ENTRY_POINT == TexSubImage3D)
+		{
+			const u64 bytes = get_image_size(
+			    std::get<5>(a), std::get<6>(a), std::get<7>(a), std::get<8>(a), std::get<9>(a));
+			add_texture_upload(std::get<10>(a), bytes);
+		}
+		// compressed, the size is given
+		else if constexpr (ENTRY_POINT == CompressedTexImage1D)
+		{
+			add_texture_upload(std::get<6>(a), static_cast<u64>(std::get<5>(a)));
+		}
+		else if constexpr (ENTRY_POINT == CompressedTexImage2D)
+		{
+			add_texture_upload(std::get<7>(a), static_cast<u64>(std::get<6>(a)));
+		}
+		else if constexpr (ENTRY_POINT == CompressedTexImage3D)
+		{
+			add_texture_upload(std::get<8>(a), static_cast<u64>(std::get<7>(a)));
+		}
+		else if constexpr (ENTRY_POINT == CompressedTexSubImage1D)
+		{
+			add_texture_upload(std::get<6>(a), static_cast<u64>(std::get<5>(a)));
+		}
+		else if constexpr (ENTRY_POINT == CompressedTexSubImage2D)
+		{
+			add_texture_upload(std::get<8>(a), static_cast<u64>(std::get<7>(a)));
+		}
+		else if constexpr (ENTRY_POINT == CompressedTexSubImage3D)
+		{
+			add_texture_upload(std::get<10>(a), static_cast<u64>(std::get<9>(a)));
+		}
+		// binds
+		else if constexpr (ENTRY_POINT == UseProgram)
+		{
+			++totals.program_binds;
+		}
+		else if constexpr (ENTRY_POINT == BindTexture)
+		{
+			++totals.texture_binds;
+		}
+		else if constexpr (ENTRY_POINT == BindVertexArray)
+		{
+			++totals.vertex_array_binds;
+		}
+	}
+
+	/** Stands in for an entry point: counts, then calls the function glad loaded. */
+	template<EntryPoint ENTRY_POINT, typename Function>
+	struct Hook;
+
+	template<EntryPoint ENTRY_POINT, typename Result, typename... Args>
+	struct Hook<ENTRY_POINT, Result(GLAD_API_PTR*)(Args...)>
+	{
+		static inline Result(GLAD_API_PTR* original)(Args...) = nullptr;
+
+		static Result GLAD_API_PTR call(Args... args)
+		{
+			count_call<ENTRY_POINT>(args...);
+			return original(args...);
+		}
+	};
+
+	template<EntryPoint ENTRY_POINT, typename Function>
+	static void install_hook(Function* entry_point)
+	{
+		using EntryPointHook = Hook<ENTRY_POINT, Function>;
+
+		// not available in this context, or hooked already
+		if (*entry_point == nullptr || *entry_point == &EntryPointHook::call)
+		{
+			return;
+		}
+
+		EntryPointHook::original = *entry_point;
+		*entry_point = &EntryPointHook::call;
+	}
+}  // namespace
+
+void core::gl_calls::install()
+{
+#define GL_ENTRY_POINT_HOOK(name) install_hook<EntryPoint::name>(&glad_gl##name);
+	GL_ENTRY_POINTS(GL_ENTRY_POINT_HOOK)
+#undef GL_ENTRY_POINT_HOOK
+}
+
+void core::gl_calls::end_frame()
+{
+	M_UNUSED const FrameCounters& totals = g_current.totals;
+	TracyPlot("GL calls", static_cast<i64>(totals.calls));
+	TracyPlot("GL draw calls", static_cast<i64>(totals.draw_calls));
+	TracyPlot("GL triangles", static_cast<i64>(totals.triangles));
+	TracyPlot(
+	    "GL uploaded bytes",
+	    static_cast<i64>(totals.buffer_upload_bytes + totals.texture_upload_bytes));
+	TracyPlot(
+	    "GL binds",
+	    static_cast<i64>(totals.program_binds + totals.texture_binds + totals.vertex_array_binds));
+
+	{
+		const std::lock_guard lock{ g_published_mutex };
+		g_published = g_current;
+	}
+	g_current = {};
+}
+
+core::gl_calls::FrameCounters core::gl_calls::get_frame_counters()
+{
+	const std::lock_guard lock{ g_published_mutex };
+	return g_published.totals;
+}
+
+void core::gl_calls::prepare_dev_ui()
+{
+	ZoneScopedN("GL calls prepare DevUI");
+
+	if (!ImGui::CollapsingHeader("GL calls"))
+	{
+		return;
+	}
+
+	Counters counters;
+	{
+		const std::lock_guard lock{ g_published_mutex };
+		counters = g_published;
+	}
+
+	const FrameCounters& totals = counters.totals;
+	ImGui::Text("Calls: %u", totals.calls);
+	ImGui::Text(
+	    "Draw calls: %u (%llu triangles)", totals.draw_calls,
+	    static_cast<unsigned long long>(totals.triangles));
+	ImGui::Text(
+	    "Uploads: %llu bytes to buffers, %llu bytes to textures",
+	    static_cast<unsigned long long>(totals.buffer_upload_bytes),
+	    static_cast<unsigned long long>(totals.texture_upload_bytes));
+	ImGui::Text(
+	    "Binds: %u programs, %u textures, %u vertex arrays", totals.program_binds,
+	    totals.texture_binds, totals.vertex_array_binds);
+
+	// the most called first
+	std::array<u16, ENTRY_POINT_COUNT> order;
+	std::iota(order.begin(), order.end(), u16{ 0 });
+	std::ranges::stable_sort(
+	    order,
+	    [&counters](u16 lhs, u16 rhs)
+	    {
+		    return counters.calls[lhs] > counters.calls[rhs];
+	    });
+
+	if (ImGui::BeginTable("GL entry points", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("Entry point");
+		ImGui::TableSetupColumn("Calls");
+		ImGui::TableHeadersRow();
+
+		for (const u16 entry_point : order)
+		{
+			if (counters.calls[entry_point] == 0)
+			{
+				break;
+			}
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(ENTRY_POINT_NAMES[entry_point]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", counters.calls[entry_point]);
+		}
+		ImGui::EndTable();
+	}
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/types.hpp"
+
+/**
+ * With COUNT_GL_CALLS, every OpenGL entry point loaded by glad is routed
+ * through a wrapper that counts its calls, the draws with the triangles they
+ * submit, the bytes uploaded to buffers and textures and the program, texture
+ * and vertex array binds. The counts of the last frame are shown in the dev UI
+ * and plotted in Tracy. The dev UI backend loads its own entry points, its
+ * calls are not counted.
+ *
+ * Without the option every function here is an empty inline, the entry points
+ * are called directly.
+ */
+namespace core::gl_calls
+{
+	struct FrameCounters
+	{
+		u32 calls = 0;
+		u32 draw_calls = 0;
+		u64 triangles = 0;
+		u64 buffer_upload_bytes = 0;  // glBufferData and glBufferSubData with data
+		u64 texture_upload_bytes = 0;  // glTexImage* and glTexSubImage* with pixels
+		u32 program_binds = 0;
+		u32 texture_binds = 0;
+		u32 vertex_array_binds = 0;
+	};
+
+#ifdef COUNT_GL_CALLS
+	/** Right after glad loaded the entry points, on the thread owning the context. */
+	void install();
+
+	/** Thread owning the context, after the swap: publishes the counts, starts the next frame. */
+	void end_frame();
+
+	/** Of the last frame, any thread. */
+	[[nodiscard]] FrameCounters get_frame_counters();
+
+	void prepare_dev_ui();
+#else
+	inline void install()
+	{
+	}
+
+	inline void end_frame()
+	{
+	}
+
+	[[nodiscard]] inline FrameCounters get_frame_counters()
+	{
+		return {};
+	}
+
+	inline void prepare_dev_ui()
+	{
+	}
+#endif
+}  // namespace core::gl_calls
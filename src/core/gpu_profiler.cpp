@@ -0,0 +1,357 @@
+#include "core/gpu_profiler.hpp"
+
+#include "utils/assertions.hpp"
+
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr const char* FRAME_TIMER_NAME = "Frame";
+
+	static b8 is_same_name(const char* lhs, const char* rhs)
+	{
+		return lhs == rhs || std::strcmp(lhs, rhs) == 0;
+	}
+
+	static f32 to_ms(u64 ns)
+	{
+		return static_cast<f32>(static_cast<f64>(ns) / 1e6);
+	}
+
+	static b8 is_query_available(u32 query)
+	{
+		i32 is_available = GL_FALSE;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &is_available);
+		return is_available != GL_FALSE;
+	}
+
+	struct WindowStats
+	{
+		f32 average_ms = 0.0f;
+		f32 max_ms = 0.0f;
+	};
+
+	static WindowStats compute_window_stats(std::span<const f32> samples)
+	{
+		WindowStats stats;
+		if (samples.empty())
+		{
+			return stats;
+		}
+
+		f32 total = 0.0f;
+		for (const f32 sample : samples)
+		{
+			total += sample;
+			stats.max_ms = std::max(stats.max_ms, sample);
+		}
+		stats.average_ms = total / static_cast<f32>(samples.size());
+		return stats;
+	}
+
+	static u64 get_query_result(u32 query)
+	{
+		u64 result = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+		return result;
+	}
+}  // namespace
+
+const core::GpuScopeTiming* core::GpuFrameTimings::find(const char* name) const
+{
+	for (u32 i = 0; i < scope_count; ++i)
+	{
+		if (is_same_name(scopes[i].name, name))
+		{
+			return &scopes[i];
+		}
+	}
+	return nullptr;
+}
+
+core::GpuProfiler::~GpuProfiler()
+{
+	if (!m_has_queries)
+	{
+		return;
+	}
+
+	for (Frame& frame : m_frames)
+	{
+		glDeleteQueries(1, &frame.frame_query);
+		glDeleteQueries(
+		    static_cast<i32>(frame.timestamp_queries.size()), frame.timestamp_queries.data());
+	}
+}
+
+void core::GpuProfiler::begin_frame()
+{
+	ZoneScopedN("Begin GPU profiler frame");
+
+	if (!m_has_queries)
+	{
+		for (Frame& frame : m_frames)
+		{
+			glGenQueries(1, &frame.frame_query);
+			glGenQueries(
+			    static_cast<i32>(frame.timestamp_queries.size()), frame.timestamp_queries.data());
+		}
+		m_has_queries = true;
+	}
+
+	++m_frame_index;
+	m_is_resolved = false;
+
+	// oldest first, stops at the first frame the GPU has not finished
+	while (m_pending_count > 0 && is_available(m_frames[m_first_pending]))
+	{
+		resolve(m_frames[m_first_pending]);
+		m_first_pending = (m_first_pending + 1) % QUERY_FRAMES;
+		--m_pending_count;
+	}
+
+	m_open_scope_count = 0;
+	if (m_pending_count == QUERY_FRAMES)
+	{
+		++m_unmeasured_count;
+		m_is_measuring = false;
+		return;
+	}
+
+	Frame& frame = m_frames[(m_first_pending + m_pending_count) % QUERY_FRAMES];
+	frame.index = m_frame_index;
+	frame.scope_count = 0;
+	glBeginQuery(GL_TIME_ELAPSED, frame.frame_query);
+	m_is_measuring = true;
+}
+
+void core::GpuProfiler::end_frame()
+{
+	if (!m_is_measuring)
+	{
+		return;
+	}
+
+	if (m_open_scope_count > 0)
+	{
+		SPDLOG_WARN(
+		    "{} GPU scopes still open at the end of the frame, closed.", m_open_scope_count);
+		while (m_open_scope_count > 0)
+		{
+			end_scope(m_open_scopes[m_open_scope_count - 1]);
+		}
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+	m_is_measuring = false;
+	++m_pending_count;
+}
+
+u32 core::GpuProfiler::begin_scope(const char* name)
+{
+	if (!m_is_measuring || m_open_scope_count == MAX_DEPTH)
+	{
+		return INVALID_SCOPE;
+	}
+
+	Frame& frame = m_frames[(m_first_pending + m_pending_count) % QUERY_FRAMES];
+	if (frame.scope_count == MAX_SCOPES)
+	{
+		return INVALID_SCOPE;
+	}
+
+	const u32 scope = frame.scope_count++;
+	frame.scopes[scope] = { name, m_open_scope_count };
+	glQueryCounter(frame.timestamp_queries[scope * 2], GL_TIMESTAMP);
+	m_open_scopes[m_open_scope_count++] = scope;
+	return scope;
+}
+
+void core::GpuProfiler::end_scope(u32 scope)
+{
+	if (scope == INVALID_SCOPE || !m_is_measuring || m_open_scope_count == 0)
+	{
+		return;
+	}
+
+	// the scopes are strictly nested
+	CHECK_MSG(m_open_scopes[m_open_scope_count - 1] == scope, "GPU scopes must not overlap.");
+
+	Frame& frame = m_frames[(m_first_pending + m_pending_count) % QUERY_FRAMES];
+	glQueryCounter(frame.timestamp_queries[scope * 2 + 1], GL_TIMESTAMP);
+	--m_open_scope_count;
+}
+
+const core::GpuFrameTimings* core::GpuProfiler::get_resolved_frame() const
+{
+	return m_is_resolved ? &m_resolved : nullptr;
+}
+
+void core::GpuProfiler::prepare_dev_ui()
+{
+	ZoneScopedN("GPU profiler prepare DevUI");
+
+	if (!ImGui::CollapsingHeader("GPU timing"))
+	{
+		return;
+	}
+
+	const std::lock_guard lock{ m_timers_mutex };
+
+	ImGui::Text(
+	    "Unmeasured frames (all queries in flight): %llu",
+	    static_cast<unsigned long long>(m_stat_unmeasured_count));
+
+	if (!ImGui::BeginTable("GPU timers", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		return;
+	}
+
+	ImGui::TableSetupColumn("Scope");
+	ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed);
+	ImGui::TableSetupColumn("avg", ImGuiTableColumnFlags_WidthFixed);
+	ImGui::TableSetupColumn("max", ImGuiTableColumnFlags_WidthFixed);
+	ImGui::TableSetupColumn("Last frames", ImGuiTableColumnFlags_WidthStretch);
+	ImGui::TableHeadersRow();
+
+	for (u32 t = 0; t < m_timer_count; ++t)
+	{
+		const Timer& timer = m_timers[t];
+		const u32    count = static_cast<u32>(std::min<u64>(timer.sample_count, HISTORY_SIZE));
+		if (count == 0)
+		{
+			continue;
+		}
+
+		// the oldest sample is the next one overwritten once the window is full
+		const u32         next = static_cast<u32>(timer.sample_count % HISTORY_SIZE);
+		const u32         offset = count == HISTORY_SIZE ? next : 0;
+		const f32         last = timer.history[(next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+		const WindowStats stats = compute_window_stats({ timer.history.data(), count });
+
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::Indent(static_cast<f32>(timer.depth) * ImGui::GetStyle().IndentSpacing);
+		ImGui::TextUnformatted(timer.name);
+		ImGui::Unindent(static_cast<f32>(timer.depth) * ImGui::GetStyle().IndentSpacing);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", last);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.average_ms);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.max_ms);
+		ImGui::TableNextColumn();
+		ImGui::PushID(static_cast<i32>(t));
+		ImGui::PlotLines(
+		    "##history", timer.history.data(), static_cast<i32>(count), static_cast<i32>(offset),
+		    nullptr, 0.0f, stats.max_ms, ImVec2{ -1.0f, 24.0f });
+		ImGui::PopID();
+	}
+
+	ImGui::EndTable();
+}
+
+void core::GpuProfiler::log_stats()
+{
+	const std::lock_guard lock{ m_timers_mutex };
+
+	SPDLOG_INFO(
+	    "GPU times over the last {} frames at most (ms): {:>7} {:>7}", HISTORY_SIZE, "avg", "max");
+	for (u32 t = 0; t < m_timer_count; ++t)
+	{
+		const Timer& timer = m_timers[t];
+		const u32    count = static_cast<u32>(std::min<u64>(timer.sample_count, HISTORY_SIZE));
+		if (count == 0)
+		{
+			continue;
+		}
+
+		const WindowStats stats = compute_window_stats({ timer.history.data(), count });
+		SPDLOG_INFO(
+		    "{:>{}}{:<{}} {:7.3f} {:7.3f}", "", timer.depth * 2, timer.name, 16 - timer.depth * 2,
+		    stats.average_ms, stats.max_ms);
+	}
+	SPDLOG_INFO("Unmeasured GPU frames: {}", m_stat_unmeasured_count);
+}
+
+b8 core::GpuProfiler::is_available(const Frame& frame) const
+{
+	if (!is_query_available(frame.frame_query))
+	{
+		return false;
+	}
+
+	for (u32 i = 0; i < frame.scope_count * 2; ++i)
+	{
+		if (!is_query_available(frame.timestamp_queries[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void core::GpuProfiler::resolve(const Frame& frame)
+{
+	m_resolved.frame_index = frame.index;
+	m_resolved.frame_ms = to_ms(get_query_result(frame.frame_query));
+	m_resolved.scope_count = frame.scope_count;
+	for (u32 i = 0; i < frame.scope_count; ++i)
+	{
+		const u64 begin_ns = get_query_result(frame.timestamp_queries[i * 2]);
+		const u64 end_ns = get_query_result(frame.timestamp_queries[i * 2 + 1]);
+		m_resolved.scopes[i] = {
+			frame.scopes[i].name,
+			frame.scopes[i].depth,
+			to_ms(end_ns > begin_ns ? end_ns - begin_ns : 0),
+		};
+	}
+	m_is_resolved = true;
+
+	const std::lock_guard lock{ m_timers_mutex };
+
+	add_sample(FRAME_TIMER_NAME, 0, m_resolved.frame_ms);
+	TracyPlot("GPU frame ms", m_resolved.frame_ms);
+	for (u32 i = 0; i < m_resolved.scope_count; ++i)
+	{
+		const GpuScopeTiming& scope = m_resolved.scopes[i];
+		add_sample(scope.name, scope.depth + 1, scope.ms);
+	}
+	m_stat_unmeasured_count = m_unmeasured_count;
+}
+
+void core::GpuProfiler::add_sample(const char* name, u32 depth, f32 ms)
+{
+	Timer* timer = nullptr;
+	for (u32 t = 0; t < m_timer_count; ++t)
+	{
+		if (is_same_name(m_timers[t].name, name))
+		{
+			timer = &m_timers[t];
+			break;
+		}
+	}
+
+	if (timer == nullptr)
+	{
+		if (m_timer_count == MAX_TIMERS)
+		{
+			return;
+		}
+		timer = &m_timers[m_timer_count++];
+		timer->name = name;
+		timer->depth = depth;
+	}
+
+	timer->history[timer->sample_count % HISTORY_SIZE] = ms;
+	++timer->sample_count;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <mutex>
+
+/**
+ * GPU timings in every build, Tracy or not: the frame is measured with a
+ * GL_TIME_ELAPSED query and each scope with a pair of GL_TIMESTAMP queries, so
+ * scopes nest (a pass inside the frame graph inside the frame).
+ *
+ * The queries of a frame are read back QUERY_FRAMES - 1 frames later at the
+ * earliest, once the GPU is done with them: reading never stalls the render
+ * thread. While every frame of the ring is still in flight the new frame goes
+ * unmeasured instead.
+ *
+ * Resolved frames feed rolling windows per scope name for the dev UI graphs
+ * and the log at exit, and the latest one is kept for the systems steering by
+ * GPU time (the dynamic resolution). Nothing allocates.
+ */
+namespace core
+{
+	struct GpuScopeTiming
+	{
+		const char* name = nullptr;
+		u32         depth = 0;  // 0 directly in the frame
+		f32         ms = 0.0f;
+	};
+
+	struct GpuFrameTimings
+	{
+		static constexpr u32 MAX_SCOPES = 32;
+
+		u64                                    frame_index = 0;
+		f32                                    frame_ms = 0.0f;
+		std::array<GpuScopeTiming, MAX_SCOPES> scopes{};
+		u32                                    scope_count = 0;
+
+		/** The first scope with that name, nullptr without. */
+		[[nodiscard]] const GpuScopeTiming* find(const char* name) const;
+	};
+
+	class GpuProfiler
+	{
+	public:
+		static constexpr u32 QUERY_FRAMES = 4;
+		static constexpr u32 MAX_SCOPES = GpuFrameTimings::MAX_SCOPES;
+		static constexpr u32 MAX_DEPTH = 8;
+		static constexpr u32 MAX_TIMERS = 32;  // distinct scope names
+		static constexpr u32 HISTORY_SIZE = 256;  // frames of the rolling windows
+		static constexpr u32 INVALID_SCOPE = ~0u;
+
+		GpuProfiler() = default;
+		~GpuProfiler();
+
+		GpuProfiler(const GpuProfiler& other) = delete;
+		GpuProfiler& operator=(const GpuProfiler& other) = delete;
+		GpuProfiler(GpuProfiler&& other) noexcept = delete;
+		GpuProfiler& operator=(GpuProfiler&& other) noexcept = delete;
+
+		/** Render thread, before the first command of the frame: resolves the finished frames. */
+		void begin_frame();
+
+		/** Render thread, before the swap. */
+		void end_frame();
+
+		/** Render thread, the name must be a literal (or outlive the profiler). */
+		[[nodiscard]] u32 begin_scope(const char* name);
+		void              end_scope(u32 scope);
+
+		/** Render thread, of the current frame. */
+		[[nodiscard]] u64 get_frame_index() const
+		{
+			return m_frame_index;
+		}
+
+		/** Render thread, the latest frame resolved by begin_frame, nullptr when none was. */
+		[[nodiscard]] const GpuFrameTimings* get_resolved_frame() const;
+
+		/** Main thread. */
+		void prepare_dev_ui();
+
+		/** Any thread, averages and maxima over the rolling windows. */
+		void log_stats();
+
+	private:
+		struct Scope
+		{
+			const char* name = nullptr;
+			u32         depth = 0;
+		};
+
+		struct Frame
+		{
+			u64                             index = 0;
+			std::array<Scope, MAX_SCOPES>   scopes{};
+			u32                             scope_count = 0;
+			u32                             frame_query = 0;
+			std::array<u32, MAX_SCOPES * 2> timestamp_queries{};  // begin and end
+		};
+
+		struct Timer
+		{
+			const char*                   name = nullptr;
+			u32                           depth = 0;
+			std::array<f32, HISTORY_SIZE> history{};
+			u64                           sample_count = 0;
+		};
+
+		[[nodiscard]] b8 is_available(const Frame& frame) const;
+		void             resolve(const Frame& frame);
+		void             add_sample(const char* name, u32 depth, f32 ms);
+
+		// render thread
+		std::array<Frame, QUERY_FRAMES> m_frames{};
+		u32                             m_first_pending = 0;
+		u32                             m_pending_count = 0;
+		b8                              m_is_measuring = false;
+		b8                              m_has_queries = false;
+		u64                             m_frame_index = 0;
+		std::array<u32, MAX_DEPTH>      m_open_scopes{};
+		u32                             m_open_scope_count = 0;
+		GpuFrameTimings                 m_resolved;
+		b8                              m_is_resolved = false;
+		u64                             m_unmeasured_count = 0;
+
+		// written by the render thread, read by the dev UI
+		std::mutex                    m_timers_mutex;
+		std::array<Timer, MAX_TIMERS> m_timers{};
+		u32                           m_timer_count = 0;
+		u64                           m_stat_unmeasured_count = 0;
+	};
+
+	/** Times its scope on the GPU. */
+	class GpuScope
+	{
+	public:
+		GpuScope(GpuProfiler& profiler, const char* name)
+		    : m_profiler{ &profiler }
+		    , m_scope{ profiler.begin_scope(name) }
+		{
+		}
+
+		~GpuScope()
+		{
+			m_profiler->end_scope(m_scope);
+		}
+
+		GpuScope(const GpuScope& other) = delete;
+		GpuScope& operator=(const GpuScope& other) = delete;
+		GpuScope(GpuScope&& other) noexcept = delete;
+		GpuScope& operator=(GpuScope&& other) noexcept = delete;
+
+	private:
+		GpuProfiler* m_profiler;
+		u32          m_scope;
+	};
+}  // namespace core
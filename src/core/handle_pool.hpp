@@ -0,0 +1,203 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+	/**
+	 * Typed reference into a `HandlePool<T>`. The generation changes every time its
+	 * slot is reused, a handle to a destroyed object is detected instead of silently
+	 * aliasing the next one.
+	 */
+	template<typename T>
+	struct Handle
+	{
+		static constexpr u32 INVALID_INDEX = std::numeric_limits<u32>::max();
+
+		u32 index = INVALID_INDEX;
+		u32 generation = 0;
+
+		b8 is_null() const
+		{
+			return index == INVALID_INDEX;
+		}
+
+		friend b8 operator==(const Handle& lhs, const Handle& rhs) = default;
+	};
+
+	/**
+	 * Owns objects of type T addressed by generational handles. Objects are stored
+	 * densely (iteration is a linear walk), destroying one moves the last object in
+	 * its place. Creation, destruction and lookup are O(1), every buffer is reserved
+	 * at construction so the pool never allocates afterward.
+	 */
+	template<typename T>
+	class HandlePool
+	{
+	public:
+		explicit HandlePool(u32 capacity)
+		    : m_capacity{ capacity }
+		{
+			m_items.reserve(capacity);
+			m_item_slots.reserve(capacity);
+			m_slots.reserve(capacity);
+		}
+
+		HandlePool(const HandlePool& other) = delete;
+		HandlePool& operator=(const HandlePool& other) = delete;
+		HandlePool(HandlePool&& other) noexcept = default;
+		HandlePool& operator=(HandlePool&& other) noexcept = default;
+
+		/** Returns a null handle when the pool is full. */
+		template<typename... Args>
+		[[nodiscard]] Handle<T> create(Args&&... args)
+		{
+			u32 slot_index = Handle<T>::INVALID_INDEX;
+
+			if (m_first_free != Handle<T>::INVALID_INDEX)
+			{
+				slot_index = m_first_free;
+				m_first_free = m_slots[slot_index].item_or_next_free;
+			}
+			else if (m_slots.size() < m_capacity)
+			{
+				slot_index = static_cast<u32>(m_slots.size());
+				m_slots.push_back({});
+			}
+			else
+			{
+				SPDLOG_ERROR("Handle pool full ({} objects).", m_capacity);
+				return {};
+			}
+
+			Slot& slot = m_slots[slot_index];
+			slot.item_or_next_free = static_cast<u32>(m_items.size());
+			slot.is_alive = true;
+
+			m_items.emplace_back(std::forward<Args>(args)...);
+			m_item_slots.push_back(slot_index);
+
+			return { slot_index, slot.generation };
+		}
+
+		/** Destroys the object, returns false for a stale or null handle. */
+		b8 destroy(Handle<T> handle)
+		{
+			if (!is_valid(handle))
+			{
+				return false;
+			}
+
+			Slot&     slot = m_slots[handle.index];
+			const u32 item_index = slot.item_or_next_free;
+			const u32 last_index = static_cast<u32>(m_items.size()) - 1;
+
+			// keep the items dense: the last one takes the hole
+			if (item_index != last_index)
+			{
+				m_items[item_index] = std::move(m_items[last_index]);
+				m_item_slots[item_index] = m_item_slots[last_index];
+				m_slots[m_item_slots[item_index]].item_or_next_free = item_index;
+			}
+			m_items.pop_back();
+			m_item_slots.pop_back();
+
+			++slot.generation;
+			slot.is_alive = false;
+			slot.item_or_next_free = m_first_free;
+			m_first_free = handle.index;
+
+			return true;
+		}
+
+		[[nodiscard]] b8 is_valid(Handle<T> handle) const
+		{
+			return handle.index < m_slots.size() && m_slots[handle.index].is_alive &&
+			       m_slots[handle.index].generation == handle.generation;
+		}
+
+		/** Returns nullptr for a stale or null handle. */
+		[[nodiscard]] T* get(Handle<T> handle)
+		{
+			return is_valid(handle) ? &m_items[m_slots[handle.index].item_or_next_free] : nullptr;
+		}
+
+		[[nodiscard]] const T* get(Handle<T> handle) const
+		{
+			return is_valid(handle) ? &m_items[m_slots[handle.index].item_or_next_free] : nullptr;
+		}
+
+		void clear()
+		{
+			for (u32 slot_index : m_item_slots)
+			{
+				Slot& slot = m_slots[slot_index];
+				++slot.generation;
+				slot.is_alive = false;
+				slot.item_or_next_free = m_first_free;
+				m_first_free = slot_index;
+			}
+			m_items.clear();
+			m_item_slots.clear();
+		}
+
+		/** Handle of the object at the given dense position (see the iterators). */
+		[[nodiscard]] Handle<T> get_handle_at(u32 item_index) const
+		{
+			const u32 slot_index = m_item_slots[item_index];
+			return { slot_index, m_slots[slot_index].generation };
+		}
+
+		[[nodiscard]] u32 get_size() const
+		{
+			return static_cast<u32>(m_items.size());
+		}
+
+		[[nodiscard]] u32 get_capacity() const
+		{
+			return m_capacity;
+		}
+
+		// dense iteration, the order changes when objects are destroyed
+		auto begin()
+		{
+			return m_items.begin();
+		}
+
+		auto end()
+		{
+			return m_items.end();
+		}
+
+		auto begin() const
+		{
+			return m_items.begin();
+		}
+
+		auto end() const
+		{
+			return m_items.end();
+		}
+
+	private:
+		struct Slot
+		{
+			// index in the items while alive, next free slot otherwise
+			u32 item_or_next_free = Handle<T>::INVALID_INDEX;
+			u32 generation = 0;
+			b8  is_alive = false;
+		};
+
+		std::vector<T>    m_items;
+		std::vector<u32>  m_item_slots;  // owning slot of each item
+		std::vector<Slot> m_slots;
+		u32               m_first_free = Handle<T>::INVALID_INDEX;
+		u32               m_capacity;
+	};
+}  // namespace core
@@ -0,0 +1,92 @@
+#include "core/input.hpp"
+
+#include <bit>
+
+core::input::KeySet core::input::KeySet::operator&(const KeySet& other) const
+{
+	KeySet result;
+	for (u32 i = 0; i < WORD_COUNT; ++i)
+	{
+		result.m_words[i] = m_words[i] & other.m_words[i];
+	}
+	return result;
+}
+
+core::input::KeySet core::input::KeySet::operator^(const KeySet& other) const
+{
+	KeySet result;
+	for (u32 i = 0; i < WORD_COUNT; ++i)
+	{
+		result.m_words[i] = m_words[i] ^ other.m_words[i];
+	}
+	return result;
+}
+
+b8 core::input::ActionMap::bind(Action action, SDL_Keycode key_code)
+{
+	for (SDL_Keycode& slot : m_key_codes[static_cast<u32>(action)])
+	{
+		if (slot == SDLK_UNKNOWN || slot == key_code)
+		{
+			slot = key_code;
+			resolve();
+			return true;
+		}
+	}
+	return false;
+}
+
+void core::input::ActionMap::unbind_all(Action action)
+{
+	m_key_codes[static_cast<u32>(action)].fill(SDLK_UNKNOWN);
+	resolve();
+}
+
+void core::input::ActionMap::resolve()
+{
+	m_actions_by_scancode.fill(0);
+
+	for (u32 action = 0; action < m_key_codes.size(); ++action)
+	{
+		for (const SDL_Keycode key_code : m_key_codes[action])
+		{
+			if (key_code == SDLK_UNKNOWN)
+			{
+				continue;
+			}
+
+			const SDL_Scancode scancode = SDL_GetScancodeFromKey(key_code, nullptr);
+			if (scancode != SDL_SCANCODE_UNKNOWN)
+			{
+				m_actions_by_scancode[scancode] |= get_action_bit(static_cast<Action>(action));
+			}
+		}
+	}
+}
+
+core::input::ActionMask core::input::ActionMap::get_actions(const KeySet& keys) const
+{
+	ActionMask actions = 0;
+
+	const auto& words = keys.get_words();
+	for (u32 i = 0; i < KeySet::WORD_COUNT; ++i)
+	{
+		for (u64 word = words[i]; word != 0; word &= word - 1)
+		{
+			actions |= m_actions_by_scancode[i * 64 + std::countr_zero(word)];
+		}
+	}
+
+	return actions;
+}
+
+void core::input::bind_default_actions(ActionMap* action_map)
+{
+	action_map->bind(Action::MOVE_FORWARD, SDLK_W);
+	action_map->bind(Action::MOVE_BACKWARD, SDLK_S);
+	action_map->bind(Action::MOVE_LEFT, SDLK_A);
+	action_map->bind(Action::MOVE_RIGHT, SDLK_D);
+	action_map->bind(Action::TOGGLE_WIREFRAME, SDLK_U);
+	action_map->bind(Action::TOGGLE_MOUSE_CAPTURE, SDLK_I);
+	action_map->bind(Action::QUIT, SDLK_ESCAPE);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <array>
+
+/** Keyboard state as scancode bitsets and the actions bound to it. */
+namespace core::input
+{
+	/** One bit per scancode, the set operations run a word at a time. */
+	class KeySet
+	{
+	public:
+		static constexpr u32 WORD_COUNT = (SDL_SCANCODE_COUNT + 63) / 64;
+
+		void set(SDL_Scancode scancode, b8 is_down)
+		{
+			const u64 bit = u64{ 1 } << (scancode % 64);
+			m_words[scancode / 64] = is_down ? m_words[scancode / 64] | bit
+			                                 : m_words[scancode / 64] & ~bit;
+		}
+
+		[[nodiscard]] b8 test(SDL_Scancode scancode) const
+		{
+			return (m_words[scancode / 64] >> (scancode % 64)) & 1;
+		}
+
+		void clear()
+		{
+			m_words.fill(0);
+		}
+
+		[[nodiscard]] KeySet operator&(const KeySet& other) const;
+		[[nodiscard]] KeySet operator^(const KeySet& other) const;
+
+		[[nodiscard]] const std::array<u64, WORD_COUNT>& get_words() const
+		{
+			return m_words;
+		}
+
+		void set_word(u32 index, u64 word)
+		{
+			m_words[index] = word;
+		}
+
+	private:
+		std::array<u64, WORD_COUNT> m_words{};
+	};
+
+	enum class Action : u8
+	{
+		MOVE_FORWARD,
+		MOVE_BACKWARD,
+		MOVE_LEFT,
+		MOVE_RIGHT,
+		TOGGLE_WIREFRAME,
+		TOGGLE_MOUSE_CAPTURE,
+		QUIT,
+		COUNT
+	};
+
+	/** One bit per action. */
+	using ActionMask = u32;
+
+	static_assert(static_cast<u32>(Action::COUNT) <= sizeof(ActionMask) * 8);
+
+	[[nodiscard]] constexpr ActionMask get_action_bit(Action action)
+	{
+		return ActionMask{ 1 } << static_cast<u32>(action);
+	}
+
+	/**
+	 * Actions bound to key codes (layout dependent, W is W on AZERTY too), resolved
+	 * to scancodes when binding and when the keymap changes. Looking up the actions
+	 * of a key set only walks the keys that are down.
+	 */
+	class ActionMap
+	{
+	public:
+		static constexpr u32 MAX_KEYS_PER_ACTION = 2;
+
+		/** Returns false when the action already has MAX_KEYS_PER_ACTION keys. */
+		b8   bind(Action action, SDL_Keycode key_code);
+		void unbind_all(Action action);
+
+		/** Maps the key codes to scancodes again, after a keymap change. */
+		void resolve();
+
+		[[nodiscard]] ActionMask get_actions(const KeySet& keys) const;
+
+	private:
+		std::array<std::array<SDL_Keycode, MAX_KEYS_PER_ACTION>, static_cast<u32>(Action::COUNT)>
+		                                                m_key_codes{};
+		std::array<ActionMask, SDL_SCANCODE_COUNT> m_actions_by_scancode{};
+	};
+
+	void bind_default_actions(ActionMap* action_map);
+}  // namespace core::input
@@ -0,0 +1,230 @@
+#include "core/input_log.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+namespace
+{
+	using namespace core;
+
+	static constexpr char MAGIC[8] = { 'L', 'O', 'G', 'L', 'I', 'N', 'P', 'T' };
+	static constexpr u32  VERSION = 1;
+
+	static constexpr u32 BUFFER_SIZE = 64 * 1024;
+	// delta time, flags, mouse, wheel, key mask and every key word
+	static constexpr u32 MAX_FRAME_SIZE = 4 + 1 + 12 + 4 + 1 + input::KeySet::WORD_COUNT * 8;
+
+	static_assert(input::KeySet::WORD_COUNT <= 8, "The changed key words don't fit in a u8 mask.");
+
+	enum FrameFlags : u8
+	{
+		FRAME_MOUSE = 1 << 0,
+		FRAME_WHEEL = 1 << 1,
+		FRAME_KEYS = 1 << 2,
+	};
+
+	template<typename T>
+	static void append(std::vector<u8>* buffer, const T& value)
+	{
+		const std::size_t offset = buffer->size();
+		buffer->resize(offset + sizeof(T));
+		std::memcpy(buffer->data() + offset, &value, sizeof(T));
+	}
+
+	template<typename T>
+	static b8 consume(const u8* data, std::size_t size, std::size_t* offset, T* value)
+	{
+		if (*offset + sizeof(T) > size)
+		{
+			return false;
+		}
+
+		std::memcpy(value, data + *offset, sizeof(T));
+		*offset += sizeof(T);
+		return true;
+	}
+}  // namespace
+
+core::input::InputRecorder::InputRecorder(const char* path)
+    : m_stream{ SDL_IOFromFile(path, "wb") }
+{
+	if (m_stream == nullptr)
+	{
+		SPDLOG_ERROR("Cannot create the input log '{}': {}", path, SDL_GetError());
+		return;
+	}
+
+	m_buffer.reserve(BUFFER_SIZE);
+	append(&m_buffer, MAGIC);
+	append(&m_buffer, VERSION);
+
+	SPDLOG_INFO("Recording the input to '{}'.", path);
+}
+
+core::input::InputRecorder::~InputRecorder()
+{
+	if (m_stream == nullptr)
+	{
+		return;
+	}
+
+	flush();
+	SDL_CloseIO(m_stream);
+	SPDLOG_INFO("Recorded {} frames of input.", m_frame_count);
+}
+
+void core::input::InputRecorder::write_frame(const FrameRecord& frame)
+{
+	if (m_stream == nullptr)
+	{
+		return;
+	}
+
+	if (m_buffer.size() + MAX_FRAME_SIZE > BUFFER_SIZE)
+	{
+		flush();
+	}
+
+	const InputSnapshot& snapshot = frame.snapshot;
+
+	u8 changed_words = 0;
+	for (u32 i = 0; i < KeySet::WORD_COUNT; ++i)
+	{
+		if (frame.keys.get_words()[i] != m_previous_keys.get_words()[i])
+		{
+			changed_words |= static_cast<u8>(1 << i);
+		}
+	}
+
+	u8 flags = 0;
+	flags |= snapshot.mouse_motion_count != 0 ? FRAME_MOUSE : 0;
+	flags |= snapshot.mouse_wheel != 0.0f ? FRAME_WHEEL : 0;
+	flags |= changed_words != 0 ? FRAME_KEYS : 0;
+
+	append(&m_buffer, frame.delta_time);
+	append(&m_buffer, flags);
+
+	if ((flags & FRAME_MOUSE) != 0)
+	{
+		append(&m_buffer, snapshot.mouse_x_offset);
+		append(&m_buffer, snapshot.mouse_y_offset);
+		append(&m_buffer, snapshot.mouse_motion_count);
+	}
+
+	if ((flags & FRAME_WHEEL) != 0)
+	{
+		append(&m_buffer, snapshot.mouse_wheel);
+	}
+
+	if ((flags & FRAME_KEYS) != 0)
+	{
+		append(&m_buffer, changed_words);
+		for (u32 i = 0; i < KeySet::WORD_COUNT; ++i)
+		{
+			if ((changed_words & (1 << i)) != 0)
+			{
+				append(&m_buffer, frame.keys.get_words()[i]);
+			}
+		}
+	}
+
+	m_previous_keys = frame.keys;
+	++m_frame_count;
+}
+
+void core::input::InputRecorder::flush()
+{
+	if (m_buffer.empty())
+	{
+		return;
+	}
+
+	if (SDL_WriteIO(m_stream, m_buffer.data(), m_buffer.size()) != m_buffer.size())
+	{
+		SPDLOG_ERROR("Writing the input log failed: {}", SDL_GetError());
+	}
+	m_buffer.clear();
+}
+
+core::input::InputPlayer::InputPlayer(const char* path)
+{
+	std::size_t size = 0;
+	m_data.reset(static_cast<u8*>(SDL_LoadFile(path, &size)));
+
+	if (m_data == nullptr)
+	{
+		SPDLOG_ERROR("Cannot read the input log '{}': {}", path, SDL_GetError());
+		return;
+	}
+
+	char magic[sizeof(MAGIC)];
+	u32  version = 0;
+
+	if (!consume(m_data.get(), size, &m_offset, &magic) ||
+	    std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+	    !consume(m_data.get(), size, &m_offset, &version) || version != VERSION)
+	{
+		SPDLOG_ERROR("'{}' isn't an input log of version {}.", path, VERSION);
+		m_data.reset();
+		return;
+	}
+
+	m_size = size;
+	SPDLOG_INFO("Replaying the input from '{}'.", path);
+}
+
+b8 core::input::InputPlayer::read_frame(FrameRecord* frame)
+{
+	if (m_data == nullptr || m_offset == m_size)
+	{
+		return false;
+	}
+
+	const u8* data = m_data.get();
+
+	FrameRecord record;
+	u8          flags = 0;
+	b8          is_valid = consume(data, m_size, &m_offset, &record.delta_time) &&
+	              consume(data, m_size, &m_offset, &flags);
+
+	if (is_valid && (flags & FRAME_MOUSE) != 0)
+	{
+		is_valid = consume(data, m_size, &m_offset, &record.snapshot.mouse_x_offset) &&
+		           consume(data, m_size, &m_offset, &record.snapshot.mouse_y_offset) &&
+		           consume(data, m_size, &m_offset, &record.snapshot.mouse_motion_count);
+	}
+
+	if (is_valid && (flags & FRAME_WHEEL) != 0)
+	{
+		is_valid = consume(data, m_size, &m_offset, &record.snapshot.mouse_wheel);
+	}
+
+	if (is_valid && (flags & FRAME_KEYS) != 0)
+	{
+		u8 changed_words = 0;
+		is_valid = consume(data, m_size, &m_offset, &changed_words);
+
+		for (u32 i = 0; is_valid && i < KeySet::WORD_COUNT; ++i)
+		{
+			u64 word = 0;
+			if ((changed_words & (1 << i)) != 0)
+			{
+				is_valid = consume(data, m_size, &m_offset, &word);
+				m_keys.set_word(i, word);
+			}
+		}
+	}
+
+	if (!is_valid)
+	{
+		SPDLOG_ERROR("Input log truncated after {} frames.", m_frame_count);
+		m_offset = m_size;
+		return false;
+	}
+
+	record.keys = m_keys;
+	*frame = record;
+	++m_frame_count;
+	return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/event_handler.hpp"
+#include "core/input.hpp"
+#include "core/types.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Binary log of the per-frame input and delta times, replayed in place of SDL and
+ * the wall clock to run the exact same session on different builds.
+ *
+ * Layout (native endianness): the 8 bytes magic, a u32 version, then per frame the
+ * f32 delta time, a u8 of flags and the fields the flags announce: mouse offsets
+ * (2 f32) and motion count (u32), the wheel (f32), the mask of the changed key
+ * words (u8) followed by those words (u64 each). An idle frame takes 5 bytes.
+ */
+namespace core::input
+{
+	struct FrameRecord
+	{
+		f32           delta_time = 0.0f;
+		InputSnapshot snapshot;
+		KeySet        keys;
+	};
+
+	class InputRecorder
+	{
+	public:
+		explicit InputRecorder(const char* path);
+		~InputRecorder();
+
+		InputRecorder(const InputRecorder& other) = delete;
+		InputRecorder& operator=(const InputRecorder& other) = delete;
+		InputRecorder(InputRecorder&& other) noexcept = delete;
+		InputRecorder& operator=(InputRecorder&& other) noexcept = delete;
+
+		[[nodiscard]] b8 is_open() const
+		{
+			return m_stream != nullptr;
+		}
+
+		void write_frame(const FrameRecord& frame);
+
+		[[nodiscard]] u32 get_frame_count() const
+		{
+			return m_frame_count;
+		}
+
+	private:
+		void flush();
+
+		SDL_IOStream*   m_stream = nullptr;
+		std::vector<u8> m_buffer;
+		KeySet          m_previous_keys;
+		u32             m_frame_count = 0;
+	};
+
+	class InputPlayer
+	{
+	public:
+		explicit InputPlayer(const char* path);
+
+		InputPlayer(const InputPlayer& other) = delete;
+		InputPlayer& operator=(const InputPlayer& other) = delete;
+		InputPlayer(InputPlayer&& other) noexcept = delete;
+		InputPlayer& operator=(InputPlayer&& other) noexcept = delete;
+
+		[[nodiscard]] b8 is_open() const
+		{
+			return m_data != nullptr;
+		}
+
+		/** Returns false at the end of the log or when it is truncated. */
+		b8 read_frame(FrameRecord* frame);
+
+		[[nodiscard]] u32 get_frame_count() const
+		{
+			return m_frame_count;
+		}
+
+	private:
+		struct SdlDeleter
+		{
+			void operator()(void* data) const
+			{
+				SDL_free(data);
+			}
+		};
+
+		std::unique_ptr<u8[], SdlDeleter> m_data;
+		std::size_t                       m_size = 0;
+		std::size_t                       m_offset = 0;
+		KeySet                            m_keys;
+		u32                               m_frame_count = 0;
+	};
+}  // namespace core::input
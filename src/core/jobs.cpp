@@ -0,0 +1,749 @@
+#include "core/jobs.hpp"
+
+#include "core/fiber.hpp"
+#include "utils/assertions.hpp"
+#include "utils/helper_macros.hpp"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef PLATFORM_LINUX
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+namespace
+{
+	using namespace core;
+	using namespace core::jobs;
+
+	/**
+	 * Chase-Lev work-stealing deque ("Correct and Efficient Work-Stealing for Weak
+	 * Memory Models", Lê et al. 2013) with a fixed capacity. Only the owner pushes
+	 * and pops (bottom), any thread can steal (top).
+	 */
+	class WorkStealingDeque
+	{
+	public:
+		static constexpr i64 CAPACITY = 4096;  // must be a power of two
+		static constexpr i64 MASK = CAPACITY - 1;
+
+		b8 push(Job* job)
+		{
+			const i64 bottom = m_bottom.load(std::memory_order_relaxed);
+			const i64 top = m_top.load(std::memory_order_acquire);
+
+			if (bottom - top >= CAPACITY)
+			{
+				return false;
+			}
+
+			m_buffer[bottom & MASK].store(job, std::memory_order_relaxed);
+			// publishes the job to the thieves (acquire load of the bottom in steal)
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		Job* pop()
+		{
+			const i64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			i64 top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				// empty
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = m_buffer[bottom & MASK].load(std::memory_order_relaxed);
+
+			if (top == bottom)
+			{
+				// last element, race against the thieves
+				if (!m_top.compare_exchange_strong(
+				        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		Job* steal()
+		{
+			i64 top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const i64 bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			Job* job = m_buffer[top & MASK].load(std::memory_order_relaxed);
+
+			if (!m_top.compare_exchange_strong(
+			        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				// lost the race with another thief or the owner
+				return nullptr;
+			}
+
+			return job;
+		}
+
+	private:
+		// top and bottom are written by different threads, keep them apart
+		alignas(64) std::atomic<i64> m_top = 0;
+		alignas(64) std::atomic<i64> m_bottom = 0;
+		std::array<std::atomic<Job*>, CAPACITY> m_buffer{};
+	};
+
+	struct Worker
+	{
+		WorkStealingDeque deque;
+		std::thread       thread;
+		std::string       name;
+		u32               steal_seed = 0;
+	};
+
+	struct JobSystem
+	{
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		// jobs pushed from threads that are not workers
+		std::mutex injected_mutex;
+		Job*       injected_head = nullptr;
+		Job*       injected_tail = nullptr;
+
+		// sleeping
+		std::mutex              sleep_mutex;
+		std::condition_variable wake_up;
+		std::atomic<i64>        pending_jobs = 0;
+		std::atomic<b8>         should_stop = false;
+	};
+
+	static JobSystem g_jobs;
+
+	thread_local i32 t_thread_index = -1;
+
+	// a job may wait on a fiber and resume on another thread, never cache the address
+	M_NOINLINE static i32 thread_index()
+	{
+		return t_thread_index;
+	}
+
+#ifdef JOBS_USE_FIBERS
+	struct FiberSlot
+	{
+		Fiber       fiber;
+		std::string name;  // persistent, Tracy keeps the pointer
+	};
+
+	// what the fiber we switched away from needs, done by the fiber we switched to
+	// (it is only safe to reuse or resume a fiber once nothing runs on its stack)
+	enum class PendingAction : u8
+	{
+		NONE,
+		RELEASE,
+		PARK
+	};
+
+	struct PendingSwitch
+	{
+		PendingAction  action = PendingAction::NONE;
+		FiberSlot*     fiber = nullptr;
+		const Counter* counter = nullptr;
+	};
+
+	struct WaitingFiber
+	{
+		FiberSlot*     fiber;
+		const Counter* counter;
+	};
+
+	struct FiberScheduler
+	{
+		std::vector<std::unique_ptr<FiberSlot>> fibers;
+		std::byte*                              stacks = nullptr;
+		std::size_t                             stack_size = 0;
+
+		// every vector has the capacity for all the fibers, they never reallocate
+		std::mutex              free_mutex;
+		std::vector<FiberSlot*> free_fibers;
+
+		std::mutex                wait_mutex;
+		std::vector<WaitingFiber> waiting_fibers;
+		std::vector<FiberSlot*>   ready_fibers;
+		std::atomic<i64>          ready_count = 0;
+	};
+
+	static FiberScheduler g_fibers;
+
+	thread_local Fiber         t_thread_fiber;
+	thread_local FiberSlot*    t_current_fiber = nullptr;
+	thread_local PendingSwitch t_pending_switch;
+
+	M_NOINLINE static FiberSlot*& current_fiber()
+	{
+		return t_current_fiber;
+	}
+
+	M_NOINLINE static PendingSwitch& pending_switch()
+	{
+		return t_pending_switch;
+	}
+
+	M_NOINLINE static Fiber& thread_fiber()
+	{
+		return t_thread_fiber;
+	}
+
+	static FiberSlot* acquire_fiber()
+	{
+		std::lock_guard lock{ g_fibers.free_mutex };
+
+		if (g_fibers.free_fibers.empty())
+		{
+			return nullptr;
+		}
+
+		FiberSlot* fiber = g_fibers.free_fibers.back();
+		g_fibers.free_fibers.pop_back();
+		return fiber;
+	}
+
+	static void release_fiber(FiberSlot* fiber)
+	{
+		std::lock_guard lock{ g_fibers.free_mutex };
+		g_fibers.free_fibers.push_back(fiber);
+	}
+
+	static FiberSlot* pop_ready_fiber()
+	{
+		if (g_fibers.ready_count.load(std::memory_order_relaxed) == 0)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard lock{ g_fibers.wait_mutex };
+
+		if (g_fibers.ready_fibers.empty())
+		{
+			return nullptr;
+		}
+
+		FiberSlot* fiber = g_fibers.ready_fibers.back();
+		g_fibers.ready_fibers.pop_back();
+		g_fibers.ready_count.fetch_sub(1, std::memory_order_relaxed);
+		return fiber;
+	}
+
+	static void notify_ready_fibers()
+	{
+		{
+			std::lock_guard lock{ g_jobs.sleep_mutex };
+		}
+		g_jobs.wake_up.notify_all();
+	}
+
+	/** Moves the fibers waiting on the counter to the ready list. */
+	static void wake_waiting_fibers(const Counter* counter)
+	{
+		u32 woken = 0;
+		{
+			std::lock_guard lock{ g_fibers.wait_mutex };
+
+			auto& waiting = g_fibers.waiting_fibers;
+			for (std::size_t i = 0; i < waiting.size();)
+			{
+				if (waiting[i].counter == counter)
+				{
+					g_fibers.ready_fibers.push_back(waiting[i].fiber);
+					waiting[i] = waiting.back();
+					waiting.pop_back();
+					++woken;
+				}
+				else
+				{
+					++i;
+				}
+			}
+
+			g_fibers.ready_count.fetch_add(woken, std::memory_order_relaxed);
+		}
+
+		if (woken > 0)
+		{
+			notify_ready_fibers();
+		}
+	}
+
+	static void process_pending_switch()
+	{
+		const PendingSwitch pending = std::exchange(pending_switch(), {});
+
+		switch (pending.action)
+		{
+		case PendingAction::RELEASE:
+			release_fiber(pending.fiber);
+			break;
+
+		case PendingAction::PARK:
+		{
+			b8 is_ready = false;
+			{
+				// same lock as the waking side, the counter can't reach zero unnoticed
+				std::lock_guard lock{ g_fibers.wait_mutex };
+
+				if (pending.counter->is_done())
+				{
+					g_fibers.ready_fibers.push_back(pending.fiber);
+					g_fibers.ready_count.fetch_add(1, std::memory_order_relaxed);
+					is_ready = true;
+				}
+				else
+				{
+					g_fibers.waiting_fibers.push_back({ pending.fiber, pending.counter });
+				}
+			}
+
+			if (is_ready)
+			{
+				notify_ready_fibers();
+			}
+			break;
+		}
+
+		case PendingAction::NONE:
+			break;
+		}
+	}
+
+	/** Leaves the current fiber for `target`, returns when the current one resumes. */
+	static void switch_to_fiber(FiberSlot* target, PendingAction action, const Counter* counter)
+	{
+		FiberSlot* self = current_fiber();
+		pending_switch() = { action, self, counter };
+		current_fiber() = target;
+
+		Fiber::switch_to(self->fiber, target->fiber);
+
+		// resumed, maybe on another thread
+		process_pending_switch();
+		TracyFiberEnter(self->name.c_str());
+	}
+#endif
+
+	static void execute(Job* job)
+	{
+		// a job without counter may release its own memory, don't touch it afterward
+		Counter* counter = job->counter;
+		job->function(job->data);
+
+#ifdef JOBS_USE_FIBERS
+		if (counter && counter->decrement())
+		{
+			// the counter may be gone already, it is only used as a key
+			wake_waiting_fibers(counter);
+		}
+#else
+		if (counter)
+		{
+			counter->decrement();
+		}
+#endif
+	}
+
+	static Job* pop_injected()
+	{
+		std::lock_guard lock{ g_jobs.injected_mutex };
+
+		Job* job = g_jobs.injected_head;
+		if (job)
+		{
+			g_jobs.injected_head = job->next;
+			if (g_jobs.injected_head == nullptr)
+			{
+				g_jobs.injected_tail = nullptr;
+			}
+		}
+
+		return job;
+	}
+
+	static void push_injected(Job* job)
+	{
+		std::lock_guard lock{ g_jobs.injected_mutex };
+
+		job->next = nullptr;
+		if (g_jobs.injected_tail)
+		{
+			g_jobs.injected_tail->next = job;
+		}
+		else
+		{
+			g_jobs.injected_head = job;
+		}
+		g_jobs.injected_tail = job;
+	}
+
+	static Job* find_job()
+	{
+		const auto worker_count = static_cast<u32>(g_jobs.workers.size());
+
+		if (thread_index() >= 0)
+		{
+			Worker& self = *g_jobs.workers[thread_index()];
+
+			if (Job* job = self.deque.pop())
+			{
+				return job;
+			}
+
+			// steal starting from a pseudo random victim, spreads the contention
+			self.steal_seed = self.steal_seed * 1664525u + 1013904223u;
+			const u32 first_victim = self.steal_seed % worker_count;
+
+			for (u32 i = 0; i < worker_count; ++i)
+			{
+				const u32 victim = (first_victim + i) % worker_count;
+				if (victim == static_cast<u32>(thread_index()))
+				{
+					continue;
+				}
+
+				if (Job* job = g_jobs.workers[victim]->deque.steal())
+				{
+					return job;
+				}
+			}
+		}
+
+		return pop_injected();
+	}
+
+	static b8 has_work()
+	{
+#ifdef JOBS_USE_FIBERS
+		if (g_fibers.ready_count.load(std::memory_order_relaxed) > 0)
+		{
+			return true;
+		}
+#endif
+		return g_jobs.pending_jobs.load(std::memory_order_relaxed) > 0;
+	}
+
+	/** Runs jobs until the job system stops, on a thread or on a pool fiber. */
+	static void run_jobs_loop()
+	{
+		static constexpr u32 SPIN_COUNT = 64;
+		u32                  idle_spins = 0;
+
+		while (!g_jobs.should_stop.load(std::memory_order_relaxed))
+		{
+#ifdef JOBS_USE_FIBERS
+			if (FiberSlot* ready_fiber = pop_ready_fiber())
+			{
+				// this fiber is idle, give it back to the pool and continue the waiting one
+				switch_to_fiber(ready_fiber, PendingAction::RELEASE, nullptr);
+				idle_spins = 0;
+				continue;
+			}
+#endif
+
+			if (Job* job = find_job())
+			{
+				g_jobs.pending_jobs.fetch_sub(1, std::memory_order_relaxed);
+				{
+					M_UNUSED const std::string& name = g_jobs.workers[thread_index()]->name;
+					ZoneScopedN("Job");
+					ZoneName(name.c_str(), name.size());
+					execute(job);
+				}
+				idle_spins = 0;
+				continue;
+			}
+
+			if (++idle_spins < SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock lock{ g_jobs.sleep_mutex };
+			g_jobs.wake_up.wait(
+			    lock,
+			    []
+			    {
+				    return g_jobs.should_stop.load(std::memory_order_relaxed) || has_work();
+			    });
+			idle_spins = 0;
+		}
+	}
+
+#ifdef JOBS_USE_FIBERS
+	static void fiber_entry(M_UNUSED void* argument)
+	{
+		// started by a switch, finish what the previous fiber asked for
+		process_pending_switch();
+		TracyFiberEnter(current_fiber()->name.c_str());
+
+		run_jobs_loop();
+
+		// stopping, go back to the thread (any thread fiber works, it is the one
+		// of the thread running this fiber now)
+		FiberSlot* self = current_fiber();
+		pending_switch() = { PendingAction::RELEASE, self, nullptr };
+		current_fiber() = nullptr;
+		TracyFiberLeave;
+		Fiber::switch_to(self->fiber, thread_fiber());
+	}
+#endif
+
+	static void worker_loop(u32 index)
+	{
+		t_thread_index = static_cast<i32>(index);
+		tracy::SetThreadName(g_jobs.workers[index]->name.c_str());
+
+#ifdef JOBS_USE_FIBERS
+		thread_fiber().convert_from_thread();
+
+		FiberSlot* first_fiber = acquire_fiber();
+		CHECK_MSG(first_fiber != nullptr, "Not enough fibers for every worker.");
+		current_fiber() = first_fiber;
+		Fiber::switch_to(thread_fiber(), first_fiber->fiber);
+
+		// back on the thread fiber, the job system is stopping
+		process_pending_switch();
+		thread_fiber().convert_to_thread();
+#else
+		run_jobs_loop();
+#endif
+	}
+
+	static void pin_thread(M_UNUSED std::thread& thread, M_UNUSED u32 cpu)
+	{
+#ifdef PLATFORM_LINUX
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(cpu, &cpu_set);
+
+		if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) != 0)
+		{
+			SPDLOG_WARN("Cannot pin job worker to CPU {}.", cpu);
+		}
+#endif
+	}
+}  // namespace
+
+void core::jobs::init(const Config& config)
+{
+	const u32 hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	// at least one worker besides the main thread
+	const u32 worker_threads =
+	    config.worker_threads != 0
+	        ? config.worker_threads
+	        : std::max(hardware_threads - std::min(config.reserved_threads, hardware_threads), 1u);
+
+	g_jobs.should_stop = false;
+	g_jobs.workers.reserve(worker_threads + 1);
+
+#ifdef JOBS_USE_FIBERS
+	// one fiber per worker is always running, the rest are for parked jobs
+	const u32 fiber_count = std::max(config.fiber_count, worker_threads * 2);
+	g_fibers.stack_size = fiber_stacks::get_aligned_size(config.fiber_stack_size);
+	g_fibers.stacks = fiber_stacks::allocate(fiber_count, g_fibers.stack_size);
+	g_fibers.fibers.reserve(fiber_count);
+	g_fibers.free_fibers.reserve(fiber_count);
+	g_fibers.waiting_fibers.reserve(fiber_count);
+	g_fibers.ready_fibers.reserve(fiber_count);
+
+	for (u32 i = 0; i < fiber_count; ++i)
+	{
+		auto& slot = g_fibers.fibers.emplace_back(std::make_unique<FiberSlot>());
+		slot->name = fmt::format("Fiber {}", i);
+		slot->fiber.create(
+		    fiber_stacks::get_stack(g_fibers.stacks, i, g_fibers.stack_size), g_fibers.stack_size,
+		    &fiber_entry, nullptr);
+		g_fibers.free_fibers.push_back(slot.get());
+	}
+
+	SPDLOG_INFO(
+	    "Job system fibers: {} fibers with {} KiB stacks.", fiber_count, g_fibers.stack_size / 1024);
+#endif
+
+	// main thread
+	g_jobs.workers.push_back(std::make_unique<Worker>());
+	g_jobs.workers.back()->name = "Main";
+	t_thread_index = 0;
+
+	for (u32 i = 1; i <= worker_threads; ++i)
+	{
+		g_jobs.workers.push_back(std::make_unique<Worker>());
+		g_jobs.workers.back()->name = fmt::format("Worker {}", i);
+		g_jobs.workers.back()->steal_seed = i;
+	}
+
+	// start the threads once every worker exists, they steal from each other
+	for (u32 i = 1; i <= worker_threads; ++i)
+	{
+		Worker& worker = *g_jobs.workers[i];
+		worker.thread = std::thread(&worker_loop, i);
+
+		if (config.pin_threads)
+		{
+			// the reserved threads keep the first CPUs
+			pin_thread(worker.thread, (config.reserved_threads + i - 1) % hardware_threads);
+		}
+	}
+
+	SPDLOG_INFO(
+	    "Job system started with {} workers ({} hardware threads).", worker_threads,
+	    hardware_threads);
+}
+
+void core::jobs::shutdown()
+{
+	{
+		std::lock_guard lock{ g_jobs.sleep_mutex };
+		g_jobs.should_stop = true;
+	}
+	g_jobs.wake_up.notify_all();
+
+	for (auto& worker : g_jobs.workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+
+	g_jobs.workers.clear();
+	g_jobs.injected_head = nullptr;
+	g_jobs.injected_tail = nullptr;
+	g_jobs.pending_jobs = 0;
+	t_thread_index = -1;
+
+#ifdef JOBS_USE_FIBERS
+	// parked fibers are abandoned, their jobs never finish
+	const u32 fiber_count = static_cast<u32>(g_fibers.fibers.size());
+	g_fibers.free_fibers.clear();
+	g_fibers.waiting_fibers.clear();
+	g_fibers.ready_fibers.clear();
+	g_fibers.ready_count = 0;
+	g_fibers.fibers.clear();
+	fiber_stacks::release(g_fibers.stacks, fiber_count, g_fibers.stack_size);
+	g_fibers.stacks = nullptr;
+#endif
+
+	SPDLOG_INFO("Job system stopped.");
+}
+
+u32 core::jobs::get_thread_count()
+{
+	return static_cast<u32>(g_jobs.workers.size());
+}
+
+i32 core::jobs::get_thread_index()
+{
+	return thread_index();
+}
+
+void core::jobs::run(Job* jobs, u32 count, Counter* counter)
+{
+	CHECK_MSG(!g_jobs.workers.empty(), "Job system not initialized.");
+
+	if (counter)
+	{
+		counter->increment(count);
+	}
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		Job* job = &jobs[i];
+		job->counter = counter;
+
+		if (thread_index() >= 0)
+		{
+			if (!g_jobs.workers[thread_index()]->deque.push(job))
+			{
+				// deque full, better run it now than losing it
+				execute(job);
+				continue;
+			}
+		}
+		else
+		{
+			push_injected(job);
+		}
+
+		g_jobs.pending_jobs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	{
+		// taking the lock avoids missing a worker that is about to sleep
+		std::lock_guard lock{ g_jobs.sleep_mutex };
+	}
+	if (count > 1)
+	{
+		g_jobs.wake_up.notify_all();
+	}
+	else
+	{
+		g_jobs.wake_up.notify_one();
+	}
+}
+
+b8 core::jobs::try_run_one()
+{
+	if (Job* job = find_job())
+	{
+		g_jobs.pending_jobs.fetch_sub(1, std::memory_order_relaxed);
+		execute(job);
+		return true;
+	}
+
+	return false;
+}
+
+void core::jobs::wait(const Counter& counter)
+{
+	ZoneScopedN("Jobs wait");
+
+	while (!counter.is_done())
+	{
+#ifdef JOBS_USE_FIBERS
+		// on a worker fiber: park it and keep the thread busy with a fresh fiber,
+		// the main thread (not a fiber) or an exhausted pool fall back to helping
+		if (current_fiber() != nullptr)
+		{
+			if (FiberSlot* next_fiber = acquire_fiber())
+			{
+				switch_to_fiber(next_fiber, PendingAction::PARK, &counter);
+				continue;
+			}
+		}
+#endif
+
+		if (!try_run_one())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Work-stealing job system, one worker per hardware thread (minus the reserved
+ * ones). Every worker owns a Chase-Lev deque, pushes and pops at its bottom and
+ * steals from the top of the others when it runs out of work. The main thread
+ * is worker 0, it does not loop but helps while waiting on a counter.
+ *
+ * Jobs are not copied nor allocated: the caller owns the `Job` objects and must
+ * keep them alive until their counter reaches zero (usually by waiting on it).
+ *
+ * With JOBS_USE_FIBERS workers run jobs on fibers from a fixed pool, a job
+ * waiting on a counter parks its fiber and the worker picks other jobs instead
+ * of blocking, the fiber resumes (on any worker) once the counter reaches zero.
+ */
+namespace core::jobs
+{
+	class Counter
+	{
+	public:
+		Counter() = default;
+
+		Counter(const Counter& other) = delete;
+		Counter& operator=(const Counter& other) = delete;
+
+		b8 is_done() const
+		{
+			return m_value.load(std::memory_order_acquire) == 0;
+		}
+
+		u32 get_value() const
+		{
+			return m_value.load(std::memory_order_acquire);
+		}
+
+		void increment(u32 amount)
+		{
+			m_value.fetch_add(amount, std::memory_order_relaxed);
+		}
+
+		/** Returns true when the counter reached zero. */
+		b8 decrement()
+		{
+			return m_value.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+
+	private:
+		std::atomic<u32> m_value = 0;
+	};
+
+	struct Job
+	{
+		void (*function)(void* data) = nullptr;
+		void*    data = nullptr;
+		Counter* counter = nullptr;  // optional, decremented when the job is done
+		Job*     next = nullptr;  // intrusive link for jobs pushed from non worker threads
+	};
+
+	struct Config
+	{
+		// threads left free for the main and the render threads
+		u32 reserved_threads = 2;
+		// when not 0, replaces the count derived from the hardware (benchmarks)
+		u32 worker_threads = 0;
+		// Linux only, pins every worker to a different CPU
+		b8  pin_threads = false;
+		// fiber pool, only used with JOBS_USE_FIBERS
+		u32 fiber_count = 128;
+		u32 fiber_stack_size = 128 * 1024;
+	};
+
+	void init(const Config& config);
+	void shutdown();
+
+	/** Number of threads running jobs, including the main thread. */
+	[[nodiscard]] u32 get_thread_count();
+
+	/** Index of the calling thread (main thread is 0), -1 for non worker threads. */
+	[[nodiscard]] i32 get_thread_index();
+
+	/**
+	 * Queues the jobs, the counter (when given) is incremented by `count` and
+	 * reaches zero once all of them finished.
+	 */
+	void run(Job* jobs, u32 count, Counter* counter);
+
+	/** Runs other jobs until the counter reaches zero. */
+	void wait(const Counter& counter);
+
+	/** Runs one pending job if any, returns false when there was nothing to do. */
+	b8 try_run_one();
+
+	/**
+	 * Splits [0, count) in chunks and calls `fn(begin, end)` for each of them in
+	 * parallel, returns once every chunk finished. The number of chunks depends
+	 * on the amount of threads, `min_chunk_size` avoids too small chunks.
+	 */
+	template<typename Fn>
+	void parallel_for(u32 count, Fn&& fn, u32 min_chunk_size = 64)
+	{
+		static constexpr u32 MAX_CHUNKS = 256;
+		static constexpr u32 CHUNKS_PER_THREAD = 4;
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		const u32 max_chunks = std::min(MAX_CHUNKS, get_thread_count() * CHUNKS_PER_THREAD);
+		const u32 chunk_count =
+		    std::clamp(count / std::max(min_chunk_size, 1u), 1u, std::max(max_chunks, 1u));
+
+		if (chunk_count == 1)
+		{
+			fn(0u, count);
+			return;
+		}
+
+		// Fn is a reference type when called with an lvalue
+		using Function = std::remove_reference_t<Fn>;
+
+		struct Chunk
+		{
+			Function* fn;
+			u32 begin;
+			u32 end;
+		};
+
+		Chunk   chunks[MAX_CHUNKS];
+		Job     chunk_jobs[MAX_CHUNKS];
+		Counter counter;
+
+		const u32 chunk_size = count / chunk_count;
+		const u32 remainder = count % chunk_count;
+		u32       begin = 0;
+
+		for (u32 i = 0; i < chunk_count; ++i)
+		{
+			// the first chunks absorb the remainder, one extra element each
+			const u32 end = begin + chunk_size + (i < remainder ? 1 : 0);
+			chunks[i] = { &fn, begin, end };
+			chunk_jobs[i].function = [](void* data)
+			{
+				auto* chunk = static_cast<Chunk*>(data);
+				(*chunk->fn)(chunk->begin, chunk->end);
+			};
+			chunk_jobs[i].data = &chunks[i];
+			begin = end;
+		}
+
+		// the calling thread takes the first chunk itself
+		run(chunk_jobs + 1, chunk_count - 1, &counter);
+		chunk_jobs[0].function(chunk_jobs[0].data);
+		wait(counter);
+	}
+}  // namespace core::jobs
@@ -0,0 +1,488 @@
+#include "core/memory.hpp"
+
+#include "utils/assertions.hpp"
+
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#endif
+
+namespace
+{
+	using namespace core;
+
+	struct MemorySystem
+	{
+		memory::Config                                               config;
+		std::array<memory::LinearArena, memory::FRAME_ARENA_COUNT>   frame_arenas;
+		std::array<memory::ArenaResource, memory::FRAME_ARENA_COUNT> frame_resources{
+			memory::ArenaResource{ &frame_arenas[0] },
+			memory::ArenaResource{ &frame_arenas[1] },
+			memory::ArenaResource{ &frame_arenas[2] },
+			memory::ArenaResource{ &frame_arenas[3] },
+		};
+		u32                                                          current_frame_arena = 0;
+		// read by the hot path guards of the render thread
+		std::atomic<u64>                                             frame_index = 0;
+
+		memory::AllocationStats last_frame_stats;
+		memory::AllocationStats frame_start_stats;
+	};
+
+	static MemorySystem g_memory;
+
+	thread_local memory::LinearArena t_scratch_arena;
+
+#ifdef TRACK_ALLOCATIONS
+	static std::atomic<u64> g_allocation_count = 0;
+	static std::atomic<u64> g_allocated_bytes = 0;
+	thread_local u64        t_allocation_count = 0;
+
+	static void* tracked_allocate(std::size_t size)
+	{
+		g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+		g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+		++t_allocation_count;
+
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	static void* tracked_allocate_aligned(std::size_t size, std::align_val_t alignment)
+	{
+		g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+		g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+		++t_allocation_count;
+
+		const auto align = static_cast<std::size_t>(alignment);
+#	ifdef PLATFORM_WINDOWS
+		return _aligned_malloc(size == 0 ? 1 : size, align);
+#	else
+		void* pointer = nullptr;
+		const int result =
+		    posix_memalign(&pointer, std::max(align, sizeof(void*)), size == 0 ? 1 : size);
+		return result == 0 ? pointer : nullptr;
+#	endif
+	}
+
+	static void tracked_free_aligned(void* pointer)
+	{
+#	ifdef PLATFORM_WINDOWS
+		_aligned_free(pointer);
+#	else
+		std::free(pointer);
+#	endif
+	}
+
+	static void* checked(void* pointer)
+	{
+		if (pointer == nullptr)
+		{
+			// exceptions are not used in this codebase, running out of memory is fatal
+			std::abort();
+		}
+		return pointer;
+	}
+#endif
+
+#ifdef PLATFORM_LINUX
+	// MADV_HUGEPAGE succeeds even when the mode is never, the active mode is in brackets
+	static b8 is_transparent_huge_pages_enabled()
+	{
+		static const b8 is_enabled = []
+		{
+			std::FILE* file = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+			if (file == nullptr)
+			{
+				return false;
+			}
+
+			std::array<char, 128> modes{};
+			const b8              has_modes =
+			    std::fgets(modes.data(), static_cast<i32>(modes.size()), file) != nullptr;
+			std::fclose(file);
+
+			return has_modes && (std::strstr(modes.data(), "[always]") != nullptr ||
+			                     std::strstr(modes.data(), "[madvise]") != nullptr);
+		}();
+		return is_enabled;
+	}
+#endif
+}  // namespace
+
+#ifdef TRACK_ALLOCATIONS
+// replaced global allocation functions, they only count and forward to malloc
+
+void* operator new(std::size_t size)
+{
+	return checked(tracked_allocate(size));
+}
+
+void* operator new[](std::size_t size)
+{
+	return checked(tracked_allocate(size));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return checked(tracked_allocate_aligned(size, alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return checked(tracked_allocate_aligned(size, alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return tracked_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return tracked_allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return tracked_allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return tracked_allocate_aligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	tracked_free_aligned(pointer);
+}
+#endif
+
+core::memory::LinearArena::~LinearArena()
+{
+	release();
+}
+
+void core::memory::LinearArena::reserve(std::size_t capacity, M_UNUSED b8 use_huge_pages)
+{
+	release();
+
+#ifdef PLATFORM_WINDOWS
+	m_memory = static_cast<std::byte*>(
+	    VirtualAlloc(nullptr, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+	void* memory = MAP_FAILED;
+
+#	ifdef PLATFORM_LINUX
+	static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	if (use_huge_pages && capacity >= HUGE_PAGE_SIZE)
+	{
+		capacity = (capacity + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+		// explicit huge pages need a configured pool (vm.nr_hugepages), often empty
+		memory = mmap(
+		    nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+		    0);
+		m_is_using_huge_pages = memory != MAP_FAILED;
+
+		if (memory == MAP_FAILED)
+		{
+			// otherwise ask for transparent huge pages, the kernel decides
+			memory =
+			    mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			m_is_using_huge_pages = memory != MAP_FAILED &&
+			                        madvise(memory, capacity, MADV_HUGEPAGE) == 0 &&
+			                        is_transparent_huge_pages_enabled();
+		}
+	}
+#	endif
+
+	if (memory == MAP_FAILED)
+	{
+		memory = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+
+	m_memory = memory == MAP_FAILED ? nullptr : static_cast<std::byte*>(memory);
+#endif
+
+	if (m_memory == nullptr)
+	{
+		SPDLOG_CRITICAL("Cannot reserve an arena of {} bytes.", capacity);
+		m_is_using_huge_pages = false;
+		return;
+	}
+
+	m_capacity = capacity;
+	m_offset = 0;
+	m_high_water = 0;
+}
+
+void core::memory::LinearArena::release()
+{
+	if (m_memory == nullptr)
+	{
+		return;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	VirtualFree(m_memory, 0, MEM_RELEASE);
+#else
+	munmap(m_memory, m_capacity);
+#endif
+
+	m_memory = nullptr;
+	m_capacity = 0;
+	m_offset = 0;
+	m_high_water = 0;
+	m_is_using_huge_pages = false;
+}
+
+void* core::memory::LinearArena::allocate(std::size_t size, std::size_t alignment)
+{
+	const std::size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+
+	if (start + size > m_capacity)
+	{
+		return nullptr;
+	}
+
+	m_offset = start + size;
+	m_high_water = std::max(m_high_water, m_offset);
+	return m_memory + start;
+}
+
+void* core::memory::ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	if (void* pointer = m_arena->allocate(bytes, alignment))
+	{
+		return pointer;
+	}
+
+	SPDLOG_WARN(
+	    "Arena full ({} of {} bytes used), {} bytes allocated from the heap.", m_arena->get_used(),
+	    m_arena->get_capacity(), bytes);
+	return m_upstream->allocate(bytes, alignment);
+}
+
+void core::memory::ArenaResource::do_deallocate(
+    void* pointer, std::size_t bytes, std::size_t alignment)
+{
+	// arena memory is released all at once, only the fallback allocations are freed
+	if (!m_arena->owns(pointer))
+	{
+		m_upstream->deallocate(pointer, bytes, alignment);
+	}
+}
+
+b8 core::memory::ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+void core::memory::init(const Config& config)
+{
+	g_memory.config = config;
+	g_memory.current_frame_arena = 0;
+	g_memory.frame_index = 0;
+
+	for (LinearArena& arena : g_memory.frame_arenas)
+	{
+		arena.reserve(config.frame_arena_size, config.use_huge_pages);
+	}
+
+	SPDLOG_INFO(
+	    "Frame arenas: {} x {} KiB{}.", FRAME_ARENA_COUNT,
+	    g_memory.frame_arenas[0].get_capacity() / 1024,
+	    g_memory.frame_arenas[0].is_using_huge_pages() ? " (huge pages)" : "");
+}
+
+void core::memory::shutdown()
+{
+	for (LinearArena& arena : g_memory.frame_arenas)
+	{
+		arena.release();
+	}
+
+	// the scratch arenas of the other threads are released when they exit
+	t_scratch_arena.release();
+}
+
+void core::memory::begin_frame(u64 frame_index)
+{
+	ZoneScopedN("Memory begin frame");
+
+	// the arenas of the frames still in flight stay untouched while their data is submitted
+	g_memory.current_frame_arena = static_cast<u32>(frame_index % FRAME_ARENA_COUNT);
+	g_memory.frame_arenas[g_memory.current_frame_arena].reset();
+
+#ifdef TRACK_ALLOCATIONS
+	const AllocationStats now{ g_allocation_count.load(std::memory_order_relaxed),
+		                       g_allocated_bytes.load(std::memory_order_relaxed) };
+	g_memory.last_frame_stats = { now.count - g_memory.frame_start_stats.count,
+		                          now.bytes - g_memory.frame_start_stats.bytes };
+	g_memory.frame_start_stats = now;
+#endif
+
+	g_memory.frame_index.fetch_add(1, std::memory_order_relaxed);
+}
+
+core::memory::LinearArena& core::memory::get_frame_arena()
+{
+	return g_memory.frame_arenas[g_memory.current_frame_arena];
+}
+
+std::pmr::memory_resource* core::memory::get_frame_resource()
+{
+	return &g_memory.frame_resources[g_memory.current_frame_arena];
+}
+
+core::memory::ScratchScope::ScratchScope()
+    : m_arena{ &t_scratch_arena }
+    , m_marker{ 0 }
+    , m_resource{ m_arena }
+{
+	if (!m_arena->is_reserved())
+	{
+		// first use on this thread, never on the hot path after the warmup
+		m_arena->reserve(g_memory.config.scratch_arena_size, g_memory.config.use_huge_pages);
+	}
+
+	m_marker = m_arena->get_marker();
+}
+
+core::memory::ScratchScope::~ScratchScope()
+{
+	m_arena->rewind(m_marker);
+}
+
+core::memory::AllocationStats core::memory::get_frame_allocation_stats()
+{
+	return g_memory.last_frame_stats;
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+core::memory::HotPathGuard::HotPathGuard(const char* name)
+    : m_name{ name }
+    , m_start_count{ t_allocation_count }
+{
+}
+
+core::memory::HotPathGuard::~HotPathGuard()
+{
+	if (g_memory.frame_index.load(std::memory_order_relaxed) <= g_memory.config.warmup_frames)
+	{
+		return;
+	}
+
+	const u64 allocations = t_allocation_count - m_start_count;
+	if (allocations > 0)
+	{
+		SPDLOG_ERROR("Hot path '{}' made {} heap allocations.", m_name, allocations);
+		CHECK_MSG(allocations == 0, "Heap allocation on a steady-state hot path.");
+	}
+}
+
+#else
+
+core::memory::HotPathGuard::HotPathGuard(M_UNUSED const char* name)
+{
+}
+
+core::memory::HotPathGuard::~HotPathGuard() = default;
+
+#endif
+
+void core::memory::prepare_dev_ui()
+{
+	ZoneScopedN("Memory prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		const LinearArena& arena = get_frame_arena();
+		ImGui::Text(
+		    "Frame arena: %zu / %zu KiB (peak %zu KiB)%s", arena.get_used() / 1024,
+		    arena.get_capacity() / 1024, arena.get_high_water() / 1024,
+		    arena.is_using_huge_pages() ? ", huge pages" : "");
+
+#ifdef TRACK_ALLOCATIONS
+		const AllocationStats stats = get_frame_allocation_stats();
+		ImGui::Text(
+		    "Heap allocations last frame: %llu (%llu bytes)",
+		    static_cast<unsigned long long>(stats.count),
+		    static_cast<unsigned long long>(stats.bytes));
+#else
+		ImGui::TextUnformatted("Heap allocation tracking disabled (TRACK_ALLOCATIONS).");
+#endif
+	}
+}
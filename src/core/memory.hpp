@@ -0,0 +1,226 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * Allocators for transient data, the hot paths should not touch the heap.
+ *
+ * - Frame arenas: FRAME_ARENA_COUNT linear arenas picked by the index of the frame
+ *   handed to the render thread, data allocated during frame N stays valid until the
+ *   beginning of frame N + FRAME_ARENA_COUNT, after the render thread drew it. A
+ *   frame that is not drawn leaves the index as is and reuses its arena.
+ * - Scratch arenas: one per thread, scoped with `ScratchScope` which rewinds the
+ *   arena when leaving the scope.
+ * - `ArenaResource` exposes an arena as a `std::pmr::memory_resource` to be used
+ *   with the pmr containers.
+ *
+ * With TRACK_ALLOCATIONS (dev builds) the global operator new counts every heap
+ * allocation, the counts of the last frame are shown in the dev UI and a
+ * `HotPathGuard` asserts when its scope allocates once the warmup frames passed.
+ */
+namespace core::memory
+{
+	// the frame being built and the frames still drawn, one per snapshot slot of the render thread
+	static constexpr u32 FRAME_ARENA_COUNT = 4;
+
+	struct Config
+	{
+		// size of each frame arena
+		std::size_t frame_arena_size = 16 * 1024 * 1024;
+		// size of the scratch arena of each thread, reserved on first use
+		std::size_t scratch_arena_size = 4 * 1024 * 1024;
+		// Linux only, backs the arenas with huge pages when the system allows it
+		b8 use_huge_pages = true;
+		// TRACK_ALLOCATIONS only, frames allowed to allocate before the steady state
+		u32 warmup_frames = 120;
+	};
+
+	/** Bump allocator over a single reserved block, freed all at once. */
+	class LinearArena
+	{
+	public:
+		LinearArena() = default;
+		~LinearArena();
+
+		LinearArena(const LinearArena& other) = delete;
+		LinearArena& operator=(const LinearArena& other) = delete;
+		LinearArena(LinearArena&& other) noexcept = delete;
+		LinearArena& operator=(LinearArena&& other) noexcept = delete;
+
+		void reserve(std::size_t capacity, b8 use_huge_pages);
+		void release();
+
+		/** Returns nullptr when the arena is full. */
+		[[nodiscard]] void* allocate(
+		    std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		[[nodiscard]] T* allocate_array(std::size_t count)
+		{
+			return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		void reset()
+		{
+			m_offset = 0;
+		}
+
+		/** Position to rewind to, everything allocated after it is freed. */
+		[[nodiscard]] std::size_t get_marker() const
+		{
+			return m_offset;
+		}
+
+		void rewind(std::size_t marker)
+		{
+			m_offset = marker;
+		}
+
+		[[nodiscard]] b8 owns(const void* pointer) const
+		{
+			const auto* byte_pointer = static_cast<const std::byte*>(pointer);
+			return byte_pointer >= m_memory && byte_pointer < m_memory + m_capacity;
+		}
+
+		[[nodiscard]] b8 is_reserved() const
+		{
+			return m_memory != nullptr;
+		}
+
+		[[nodiscard]] std::size_t get_used() const
+		{
+			return m_offset;
+		}
+
+		[[nodiscard]] std::size_t get_capacity() const
+		{
+			return m_capacity;
+		}
+
+		[[nodiscard]] std::size_t get_high_water() const
+		{
+			return m_high_water;
+		}
+
+		/**
+		 * Explicit huge pages, or transparent ones enabled for the range: the kernel still
+		 * falls back to small pages where no huge page is free.
+		 */
+		[[nodiscard]] b8 is_using_huge_pages() const
+		{
+			return m_is_using_huge_pages;
+		}
+
+	private:
+		std::byte*  m_memory = nullptr;
+		std::size_t m_capacity = 0;
+		std::size_t m_offset = 0;
+		std::size_t m_high_water = 0;
+		b8          m_is_using_huge_pages = false;
+	};
+
+	/**
+	 * Memory resource allocating from an arena, deallocations are no-ops. Falls back
+	 * to the upstream resource (with a warning) when the arena is full.
+	 */
+	class ArenaResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit ArenaResource(
+		    LinearArena*               arena,
+		    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+		    : m_arena{ arena }
+		    , m_upstream{ upstream }
+		{
+		}
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void  do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+		b8    do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		LinearArena*               m_arena;
+		std::pmr::memory_resource* m_upstream;
+	};
+
+	void init(const Config& config);
+	void shutdown();
+
+	/**
+	 * Resets the arena of `frame_index`, the index of the frame handed to the render thread
+	 * next, also closes the allocation statistics of the previous frame. Called once at the
+	 * frame start.
+	 */
+	void begin_frame(u64 frame_index);
+
+	/** Arena of the current frame, main thread only. */
+	[[nodiscard]] LinearArena&               get_frame_arena();
+	[[nodiscard]] std::pmr::memory_resource* get_frame_resource();
+
+	/**
+	 * Scratch allocations of the calling thread, released when the scope ends. Scopes
+	 * nest, but must not stay open across a job wait (fibers may change thread).
+	 */
+	class ScratchScope
+	{
+	public:
+		ScratchScope();
+		~ScratchScope();
+
+		ScratchScope(const ScratchScope& other) = delete;
+		ScratchScope& operator=(const ScratchScope& other) = delete;
+		ScratchScope(ScratchScope&& other) noexcept = delete;
+		ScratchScope& operator=(ScratchScope&& other) noexcept = delete;
+
+		[[nodiscard]] LinearArena& get_arena()
+		{
+			return *m_arena;
+		}
+
+		[[nodiscard]] std::pmr::memory_resource* get_resource()
+		{
+			return &m_resource;
+		}
+
+	private:
+		LinearArena*  m_arena;
+		std::size_t   m_marker;
+		ArenaResource m_resource;
+	};
+
+	struct AllocationStats
+	{
+		u64 count = 0;
+		u64 bytes = 0;
+	};
+
+	/** Heap allocations of the last full frame, always empty without TRACK_ALLOCATIONS. */
+	[[nodiscard]] AllocationStats get_frame_allocation_stats();
+
+	/**
+	 * Asserts that the calling thread did not allocate from the heap inside the scope,
+	 * after the warmup frames. Does nothing without TRACK_ALLOCATIONS.
+	 */
+	class HotPathGuard
+	{
+	public:
+		explicit HotPathGuard(const char* name);
+		~HotPathGuard();
+
+		HotPathGuard(const HotPathGuard& other) = delete;
+		HotPathGuard& operator=(const HotPathGuard& other) = delete;
+		HotPathGuard(HotPathGuard&& other) noexcept = delete;
+		HotPathGuard& operator=(HotPathGuard&& other) noexcept = delete;
+
+	private:
+#ifdef TRACK_ALLOCATIONS
+		const char* m_name;
+		u64         m_start_count;
+#endif
+	};
+
+	void prepare_dev_ui();
+}  // namespace core::memory
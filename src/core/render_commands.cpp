@@ -0,0 +1,169 @@
+#include "core/render_commands.hpp"
+
+#include "core/jobs.hpp"
+
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <bit>
+
+u64 core::make_sort_key(Handle<Material> material, Handle<Mesh> mesh, f32 view_depth)
+{
+	// positive floats compare like their bits, behind the camera counts as the nearest
+	const u32 depth_bits = std::bit_cast<u32>(std::max(view_depth, 0.0f));
+
+	return (static_cast<u64>(material.index & 0xffff) << 48) |
+	       (static_cast<u64>(mesh.index & 0xffff) << 32) | depth_bits;
+}
+
+void core::CommandList::init(u32 capacity)
+{
+	m_arena.reserve(static_cast<std::size_t>(capacity) * sizeof(DrawItem), false);
+	reset();
+}
+
+void core::CommandList::reset()
+{
+	m_arena.reset();
+	m_commands = nullptr;
+	m_count = 0;
+	m_dropped_count = 0;
+}
+
+core::CommandRecorder::CommandRecorder(const Config& config)
+{
+	const u32 list_count = std::max(jobs::get_thread_count(), 1u);
+
+	m_lists_storage = std::make_unique<CommandList[]>(list_count);
+	m_lists = { m_lists_storage.get(), list_count };
+	for (CommandList& list : m_lists)
+	{
+		list.init(config.max_commands_per_thread);
+	}
+
+	m_run_offsets.reserve(list_count + 1);
+	m_last_counts.resize(list_count, 0);
+}
+
+void core::CommandRecorder::begin_frame()
+{
+	for (CommandList& list : m_lists)
+	{
+		list.reset();
+	}
+}
+
+core::CommandList& core::CommandRecorder::get_list()
+{
+	// threads outside of the job system share the main thread's list, keep them out
+	const i32 thread_index = jobs::get_thread_index();
+	return m_lists[thread_index > 0 ? static_cast<u32>(thread_index) % m_lists.size() : 0];
+}
+
+void core::CommandRecorder::merge(std::vector<DrawItem>* commands)
+{
+	ZoneScopedN("Merge command lists");
+
+	auto by_key = [](const DrawItem& lhs, const DrawItem& rhs)
+	{
+		return lhs.sort_key < rhs.sort_key;
+	};
+
+	const auto list_count = static_cast<u32>(m_lists.size());
+
+	jobs::parallel_for(
+	    list_count,
+	    [this, &by_key](u32 begin, u32 end)
+	    {
+		    ZoneScopedN("Sort command list");
+		    for (u32 i = begin; i < end; ++i)
+		    {
+			    std::span<DrawItem> list = m_lists[i].get_commands();
+			    std::sort(list.begin(), list.end(), by_key);
+		    }
+	    },
+	    1);
+
+	// the sorted lists side by side are the first runs, merged pairwise until one is left
+	u32 total_count = 0;
+	u32 dropped_count = 0;
+	m_run_offsets.clear();
+	for (u32 i = 0; i < list_count; ++i)
+	{
+		m_last_counts[i] = static_cast<u32>(m_lists[i].get_commands().size());
+		dropped_count += m_lists[i].get_dropped_count();
+
+		if (m_last_counts[i] > 0)
+		{
+			m_run_offsets.push_back(total_count);
+			total_count += m_last_counts[i];
+		}
+	}
+	m_run_offsets.push_back(total_count);
+
+	if (dropped_count > 0 && m_last_dropped_count == 0)
+	{
+		SPDLOG_WARN("Command lists full, {} draw commands dropped.", dropped_count);
+	}
+	m_last_dropped_count = dropped_count;
+
+	commands->resize(total_count);
+	m_merge_buffer.resize(total_count);
+
+	u32 offset = 0;
+	for (CommandList& list : m_lists)
+	{
+		std::span<DrawItem> list_commands = list.get_commands();
+		std::copy(list_commands.begin(), list_commands.end(), commands->begin() + offset);
+		offset += static_cast<u32>(list_commands.size());
+	}
+
+	std::vector<DrawItem>* source = commands;
+	std::vector<DrawItem>* destination = &m_merge_buffer;
+
+	while (m_run_offsets.size() > 2)
+	{
+		const auto run_count = static_cast<u32>(m_run_offsets.size() - 1);
+		const u32  pair_count = (run_count + 1) / 2;
+
+		jobs::parallel_for(
+		    pair_count,
+		    [this, source, destination, run_count, &by_key](u32 begin, u32 end)
+		    {
+			    ZoneScopedN("Merge command runs");
+			    for (u32 pair = begin; pair < end; ++pair)
+			    {
+				    const u32 first = m_run_offsets[pair * 2];
+				    const u32 middle = m_run_offsets[std::min(pair * 2 + 1, run_count)];
+				    const u32 last = m_run_offsets[std::min(pair * 2 + 2, run_count)];
+
+				    // the odd run out is copied as is
+				    std::merge(
+				        source->begin() + first, source->begin() + middle,
+				        source->begin() + middle, source->begin() + last,
+				        destination->begin() + first, by_key);
+			    }
+		    },
+		    1);
+
+		// the merged runs start at every other offset
+		u32 kept = 0;
+		for (u32 i = 0; i < m_run_offsets.size(); i += 2)
+		{
+			m_run_offsets[kept++] = m_run_offsets[i];
+		}
+		if (m_run_offsets[kept - 1] != total_count)
+		{
+			m_run_offsets[kept++] = total_count;
+		}
+		m_run_offsets.resize(kept);
+
+		std::swap(source, destination);
+	}
+
+	if (source != commands)
+	{
+		commands->swap(m_merge_buffer);
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/handle_pool.hpp"
+#include "core/memory.hpp"
+#include "core/types.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ * Draw commands recorded in parallel: every job system thread appends to its own
+ * command list (no locks, no shared cache lines), each list bump-allocates from
+ * its own arena which is rewound every frame. Once recorded, the lists are sorted
+ * in parallel and merged by key into the single stream the render thread replays.
+ */
+namespace core
+{
+	class Mesh;
+	struct Material;
+
+	struct DrawItem
+	{
+		glm::mat4        model{ 1.0f };
+		u64              sort_key = 0;
+		Handle<Mesh>     mesh;
+		Handle<Material> material;
+	};
+
+	/**
+	 * Material, then mesh (fewest state changes), then front to back (early depth
+	 * rejection). Handle indices above 16 bits share their key bits.
+	 */
+	[[nodiscard]] u64 make_sort_key(Handle<Material> material, Handle<Mesh> mesh, f32 view_depth);
+
+	class alignas(64) CommandList
+	{
+	public:
+		CommandList() = default;
+
+		CommandList(const CommandList& other) = delete;
+		CommandList& operator=(const CommandList& other) = delete;
+		CommandList(CommandList&& other) noexcept = delete;
+		CommandList& operator=(CommandList&& other) noexcept = delete;
+
+		void init(u32 capacity);
+
+		/** Forgets the commands, the memory is kept. */
+		void reset();
+
+		void push(const DrawItem& item)
+		{
+			// the arena hands out consecutive items, they form one array
+			auto* command = m_arena.allocate_array<DrawItem>(1);
+			if (command == nullptr)
+			{
+				++m_dropped_count;
+				return;
+			}
+
+			*command = item;
+			m_commands = m_commands == nullptr ? command : m_commands;
+			++m_count;
+		}
+
+		[[nodiscard]] std::span<DrawItem> get_commands()
+		{
+			return { m_commands, m_count };
+		}
+
+		[[nodiscard]] u32 get_dropped_count() const
+		{
+			return m_dropped_count;
+		}
+
+	private:
+		memory::LinearArena m_arena;
+		DrawItem*           m_commands = nullptr;
+		u32                 m_count = 0;
+		u32                 m_dropped_count = 0;
+	};
+
+	class CommandRecorder
+	{
+	public:
+		struct Config
+		{
+			u32 max_commands_per_thread = 64 * 1024;
+		};
+
+		/** One list per thread of the job system, which must be initialized. */
+		explicit CommandRecorder(const Config& config);
+
+		CommandRecorder(const CommandRecorder& other) = delete;
+		CommandRecorder& operator=(const CommandRecorder& other) = delete;
+		CommandRecorder(CommandRecorder&& other) noexcept = delete;
+		CommandRecorder& operator=(CommandRecorder&& other) noexcept = delete;
+
+		void begin_frame();
+
+		/** The list of the calling job system thread. */
+		[[nodiscard]] CommandList& get_list();
+
+		/** Sorts every list and merges them by key into `commands`. */
+		void merge(std::vector<DrawItem>* commands);
+
+		[[nodiscard]] u32 get_list_count() const
+		{
+			return static_cast<u32>(m_lists.size());
+		}
+
+		/** Commands recorded in the last frame, by the list of each thread. */
+		[[nodiscard]] u32 get_command_count(u32 list_index) const
+		{
+			return m_last_counts[list_index];
+		}
+
+		[[nodiscard]] u32 get_dropped_count() const
+		{
+			return m_last_dropped_count;
+		}
+
+	private:
+		std::unique_ptr<CommandList[]> m_lists_storage;
+		std::span<CommandList>         m_lists;
+		std::vector<DrawItem>          m_merge_buffer;
+		std::vector<u32>               m_run_offsets;
+		std::vector<u32>               m_last_counts;
+		u32                            m_last_dropped_count = 0;
+	};
+}  // namespace core
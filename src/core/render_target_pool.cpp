@@ -0,0 +1,366 @@
+#include "core/render_target_pool.hpp"
+
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+	using namespace core;
+
+	struct FormatInfo
+	{
+		GLenum      internal_format;
+		GLenum      format;
+		GLenum      type;
+		u32         bytes_per_pixel;
+		GLenum      attachment;  // GL_COLOR_ATTACHMENT0 for the colour formats
+		const char* name;
+	};
+
+	static constexpr std::array<FormatInfo, static_cast<u32>(TargetFormat::COUNT)> FORMATS = { {
+		{ GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4, GL_COLOR_ATTACHMENT0, "RGBA8" },
+		{ GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8, GL_COLOR_ATTACHMENT0, "RGBA16F" },
+		{ GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, 4, GL_COLOR_ATTACHMENT0,
+		  "R11F_G11F_B10F" },
+		{ GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, 4,
+		  GL_DEPTH_STENCIL_ATTACHMENT, "DEPTH24_STENCIL8" },
+		{ GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, 4, GL_DEPTH_ATTACHMENT,
+		  "DEPTH32F" },
+	} };
+
+	static const FormatInfo& get_format_info(TargetFormat format)
+	{
+		return FORMATS[static_cast<u32>(format)];
+	}
+
+	static f64 to_mib(std::size_t bytes)
+	{
+		return static_cast<f64>(bytes) / (1024.0 * 1024.0);
+	}
+}  // namespace
+
+const char* core::get_format_name(TargetFormat format)
+{
+	return get_format_info(format).name;
+}
+
+b8 core::is_depth_format(TargetFormat format)
+{
+	return get_format_info(format).attachment != GL_COLOR_ATTACHMENT0;
+}
+
+std::size_t core::get_target_byte_size(glm::ivec2 size, TargetFormat format, u32 samples)
+{
+	return static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y) *
+	       get_format_info(format).bytes_per_pixel * samples;
+}
+
+core::RenderTarget::RenderTarget(i32 width, i32 height, TargetFormat format, u32 samples)
+    : width{ width }
+    , height{ height }
+    , format{ format }
+    , samples{ samples }
+{
+	ZoneScopedN("Create render target");
+
+	const FormatInfo& info = get_format_info(format);
+
+	glGenTextures(1, &texture);
+	if (samples > 1)
+	{
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+		glTexImage2DMultisample(
+		    GL_TEXTURE_2D_MULTISAMPLE, static_cast<i32>(samples), info.internal_format, width,
+		    height, GL_TRUE);
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(
+		    GL_TEXTURE_2D, 0, static_cast<i32>(info.internal_format), width, height, 0,
+		    info.format, info.type, nullptr);
+		// sampled by the passes after, often at another resolution
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+}
+
+core::RenderTarget::~RenderTarget()
+{
+	glDeleteTextures(1, &texture);
+}
+
+core::RenderTarget::RenderTarget(RenderTarget&& other) noexcept
+    : texture{ std::exchange(other.texture, 0) }
+    , width{ other.width }
+    , height{ other.height }
+    , format{ other.format }
+    , samples{ other.samples }
+    , last_used_frame{ other.last_used_frame }
+    , is_in_use{ other.is_in_use }
+{
+}
+
+core::RenderTarget& core::RenderTarget::operator=(RenderTarget&& other) noexcept
+{
+	std::swap(texture, other.texture);
+	width = other.width;
+	height = other.height;
+	format = other.format;
+	samples = other.samples;
+	last_used_frame = other.last_used_frame;
+	is_in_use = other.is_in_use;
+	return *this;
+}
+
+std::size_t core::RenderTarget::get_byte_size() const
+{
+	return get_target_byte_size({ width, height }, format, samples);
+}
+
+core::RenderTargetPool::RenderTargetPool(const Config& config)
+    : m_targets{ config.capacity }
+    , m_max_unused_frames{ config.max_unused_frames }
+{
+	m_framebuffers.reserve(config.capacity);
+}
+
+core::RenderTargetPool::~RenderTargetPool()
+{
+	for (const Framebuffer& framebuffer : m_framebuffers)
+	{
+		glDeleteFramebuffers(1, &framebuffer.id);
+	}
+}
+
+void core::RenderTargetPool::begin_frame(
+    i32 viewport_width, i32 viewport_height, f32 resolution_scale)
+{
+	ZoneScopedN("Begin render targets");
+
+	++m_frame;
+	m_viewport_width = std::max(viewport_width, 1);
+	m_viewport_height = std::max(viewport_height, 1);
+	m_resolution_scale = std::clamp(resolution_scale, MIN_RESOLUTION_SCALE, MAX_RESOLUTION_SCALE);
+
+	// backwards, a destroyed target is replaced by the last one
+	std::size_t allocated_bytes = 0;
+	for (u32 i = m_targets.get_size(); i-- > 0;)
+	{
+		RenderTarget& target = *(m_targets.begin() + i);
+		if (target.is_in_use)
+		{
+			SPDLOG_WARN(
+			    "Render target {}x{} {} never released, released now.", target.width,
+			    target.height, get_format_name(target.format));
+			target.is_in_use = false;
+		}
+
+		if (m_frame - target.last_used_frame > m_max_unused_frames)
+		{
+			destroy(i);
+			continue;
+		}
+		allocated_bytes += target.get_byte_size();
+	}
+
+	m_stat_target_count.store(m_targets.get_size(), std::memory_order_relaxed);
+	m_stat_framebuffer_count.store(
+	    static_cast<u32>(m_framebuffers.size()), std::memory_order_relaxed);
+	m_stat_acquisitions.store(m_frame_acquisitions, std::memory_order_relaxed);
+	m_stat_allocated_bytes.store(allocated_bytes, std::memory_order_relaxed);
+	m_stat_requested_bytes.store(m_frame_requested_bytes, std::memory_order_relaxed);
+	m_stat_resolution_scale.store(m_resolution_scale, std::memory_order_relaxed);
+
+	m_frame_acquisitions = 0;
+	m_frame_requested_bytes = 0;
+}
+
+core::Handle<core::RenderTarget> core::RenderTargetPool::acquire(const TargetDesc& desc)
+{
+	const glm::ivec2 size = get_size(desc);
+	const u32        samples = std::max(desc.samples, 1u);
+
+	Handle<RenderTarget> handle;
+	for (u32 i = 0; i < m_targets.get_size(); ++i)
+	{
+		const RenderTarget& target = *(m_targets.begin() + i);
+		if (!target.is_in_use && target.width == size.x && target.height == size.y &&
+		    target.format == desc.format && target.samples == samples)
+		{
+			handle = m_targets.get_handle_at(i);
+			break;
+		}
+	}
+
+	if (handle.is_null())
+	{
+		handle = m_targets.create(size.x, size.y, desc.format, samples);
+	}
+
+	RenderTarget* target = m_targets.get(handle);
+	if (target == nullptr)
+	{
+		return {};
+	}
+
+	target->is_in_use = true;
+	target->last_used_frame = m_frame;
+
+	++m_frame_acquisitions;
+	m_frame_requested_bytes += target->get_byte_size();
+
+	return handle;
+}
+
+void core::RenderTargetPool::release(Handle<RenderTarget> handle)
+{
+	if (RenderTarget* target = m_targets.get(handle))
+	{
+		target->is_in_use = false;
+	}
+}
+
+const core::RenderTarget* core::RenderTargetPool::get(Handle<RenderTarget> handle) const
+{
+	return m_targets.get(handle);
+}
+
+glm::ivec2 core::RenderTargetPool::get_size(const TargetDesc& desc) const
+{
+	if (desc.width > 0 && desc.height > 0)
+	{
+		return { desc.width, desc.height };
+	}
+
+	const f32 scale = desc.scale * (desc.is_scaled ? m_resolution_scale : 1.0f);
+	const auto scaled = [scale](i32 size)
+	{
+		return std::max(static_cast<i32>(std::lround(static_cast<f32>(size) * scale)), 1);
+	};
+	return { scaled(m_viewport_width), scaled(m_viewport_height) };
+}
+
+u32 core::RenderTargetPool::get_framebuffer(
+    std::span<const Handle<RenderTarget>> colors, Handle<RenderTarget> depth)
+{
+	if (colors.size() > MAX_COLOR_ATTACHMENTS)
+	{
+		SPDLOG_ERROR(
+		    "{} colour attachments, at most {} are supported.", colors.size(),
+		    MAX_COLOR_ATTACHMENTS);
+		return 0;
+	}
+
+	Framebuffer key;
+	for (u32 i = 0; i < colors.size(); ++i)
+	{
+		const RenderTarget* target = m_targets.get(colors[i]);
+		key.colors[i] = target != nullptr ? target->texture : 0;
+	}
+	const RenderTarget* depth_target = m_targets.get(depth);
+	key.depth = depth_target != nullptr ? depth_target->texture : 0;
+
+	for (const Framebuffer& framebuffer : m_framebuffers)
+	{
+		if (framebuffer.colors == key.colors && framebuffer.depth == key.depth)
+		{
+			return framebuffer.id;
+		}
+	}
+
+	ZoneScopedN("Create framebuffer");
+
+	glGenFramebuffers(1, &key.id);
+	glBindFramebuffer(GL_FRAMEBUFFER, key.id);
+
+	std::array<GLenum, MAX_COLOR_ATTACHMENTS> draw_buffers{};
+	for (u32 i = 0; i < colors.size(); ++i)
+	{
+		const RenderTarget* target = m_targets.get(colors[i]);
+		const GLenum texture_target =
+		    target != nullptr && target->samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+		glFramebufferTexture2D(
+		    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, texture_target, key.colors[i], 0);
+		draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+	}
+	glDrawBuffers(static_cast<i32>(colors.size()), draw_buffers.data());
+
+	if (depth_target != nullptr)
+	{
+		const GLenum texture_target =
+		    depth_target->samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+		glFramebufferTexture2D(
+		    GL_FRAMEBUFFER, get_format_info(depth_target->format).attachment, texture_target,
+		    key.depth, 0);
+	}
+
+	const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		SPDLOG_ERROR("Incomplete framebuffer (status 0x{:x}).", status);
+		glDeleteFramebuffers(1, &key.id);
+		return 0;
+	}
+
+	m_framebuffers.push_back(key);
+	return key.id;
+}
+
+void core::RenderTargetPool::prepare_dev_ui() const
+{
+	ZoneScopedN("Render targets prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Render targets"))
+	{
+		const std::size_t allocated_bytes = m_stat_allocated_bytes.load(std::memory_order_relaxed);
+		const std::size_t requested_bytes = m_stat_requested_bytes.load(std::memory_order_relaxed);
+
+		ImGui::Text(
+		    "Resolution scale: %.0f%%",
+		    m_stat_resolution_scale.load(std::memory_order_relaxed) * 100.0f);
+		ImGui::Text("Targets: %u", m_stat_target_count.load(std::memory_order_relaxed));
+		ImGui::Text("Framebuffers: %u", m_stat_framebuffer_count.load(std::memory_order_relaxed));
+		ImGui::Text(
+		    "Acquisitions per frame: %u", m_stat_acquisitions.load(std::memory_order_relaxed));
+		ImGui::Text("VRAM: %.2f MiB", to_mib(allocated_bytes));
+		// what the passes would take with a target each
+		ImGui::Text("VRAM without sharing: %.2f MiB", to_mib(requested_bytes));
+	}
+}
+
+void core::RenderTargetPool::destroy(u32 item_index)
+{
+	const Handle<RenderTarget> handle = m_targets.get_handle_at(item_index);
+	const u32                  texture = m_targets.get(handle)->texture;
+
+	// GL reuses the names, a framebuffer must not outlive its attachments
+	std::erase_if(
+	    m_framebuffers,
+	    [texture](const Framebuffer& framebuffer)
+	    {
+		    const b8 is_attached =
+		        framebuffer.depth == texture ||
+		        std::find(framebuffer.colors.begin(), framebuffer.colors.end(), texture) !=
+		            framebuffer.colors.end();
+		    if (is_attached)
+		    {
+			    glDeleteFramebuffers(1, &framebuffer.id);
+		    }
+		    return is_attached;
+	    });
+
+	m_targets.destroy(handle);
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "core/handle_pool.hpp"
+#include "core/types.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Transient colour and depth attachments for the offscreen passes, owned by the
+ * render thread. A pass acquires a target by description and releases it once
+ * the passes after it no longer read it: a released target serves the next
+ * acquisition with the same size, format and samples in the same frame (the
+ * targets of passes whose lifetimes do not overlap share their memory) and the
+ * frames after. Targets unused for `max_unused_frames` frames are deleted, a
+ * resize simply stops requesting the old size.
+ *
+ * Sizes are relative to the viewport and, unless opted out, scaled by the
+ * resolution scale: the passes never deal with the window size themselves.
+ */
+namespace core
+{
+	enum class TargetFormat : u8
+	{
+		RGBA8,
+		RGBA16F,
+		R11F_G11F_B10F,
+		DEPTH24_STENCIL8,
+		DEPTH32F,
+		COUNT
+	};
+
+	struct TargetDesc
+	{
+		TargetFormat format = TargetFormat::RGBA8;
+		u32          samples = 1;
+		f32          scale = 1.0f;  // of the viewport, ignored with a fixed size
+		i32          width = 0;  // fixed size in pixels when not 0
+		i32          height = 0;
+		b8           is_scaled = true;  // follows the resolution scale
+	};
+
+	[[nodiscard]] const char* get_format_name(TargetFormat format);
+	[[nodiscard]] b8          is_depth_format(TargetFormat format);
+	[[nodiscard]] std::size_t get_target_byte_size(
+	    glm::ivec2 size, TargetFormat format, u32 samples);
+
+	/** A pooled attachment, the texture is deleted with it. */
+	class RenderTarget
+	{
+	public:
+		RenderTarget(i32 width, i32 height, TargetFormat format, u32 samples);
+		~RenderTarget();
+
+		RenderTarget(const RenderTarget& other) = delete;
+		RenderTarget& operator=(const RenderTarget& other) = delete;
+		RenderTarget(RenderTarget&& other) noexcept;
+		RenderTarget& operator=(RenderTarget&& other) noexcept;
+
+		[[nodiscard]] std::size_t get_byte_size() const;
+
+		u32          texture = 0;
+		i32          width = 0;
+		i32          height = 0;
+		TargetFormat format = TargetFormat::RGBA8;
+		u32          samples = 1;
+		u64          last_used_frame = 0;
+		b8           is_in_use = false;
+	};
+
+	class RenderTargetPool
+	{
+	public:
+		struct Config
+		{
+			u32 capacity = 64;
+			u32 max_unused_frames = 3;
+		};
+
+		static constexpr u32 MAX_COLOR_ATTACHMENTS = 4;
+		static constexpr f32 MIN_RESOLUTION_SCALE = 0.25f;
+		static constexpr f32 MAX_RESOLUTION_SCALE = 2.0f;
+
+		explicit RenderTargetPool(const Config& config);
+		~RenderTargetPool();
+
+		RenderTargetPool(const RenderTargetPool& other) = delete;
+		RenderTargetPool& operator=(const RenderTargetPool& other) = delete;
+		RenderTargetPool(RenderTargetPool&& other) noexcept = delete;
+		RenderTargetPool& operator=(RenderTargetPool&& other) noexcept = delete;
+
+		/**
+		 * Render thread, before the first pass: deletes the targets unused for too long and
+		 * publishes the statistics of the previous frame.
+		 */
+		void begin_frame(i32 viewport_width, i32 viewport_height, f32 resolution_scale);
+
+		/** Returns a null handle when the pool is full. */
+		[[nodiscard]] Handle<RenderTarget> acquire(const TargetDesc& desc);
+
+		/** The next acquisitions may return the same target, in this frame already. */
+		void release(Handle<RenderTarget> handle);
+
+		[[nodiscard]] const RenderTarget* get(Handle<RenderTarget> handle) const;
+
+		/** The size an acquisition with this description gets, at least 1x1. */
+		[[nodiscard]] glm::ivec2 get_size(const TargetDesc& desc) const;
+
+		/**
+		 * A framebuffer with the targets attached, cached until one of them is deleted.
+		 * Returns 0 (the default framebuffer) for an incomplete one.
+		 */
+		[[nodiscard]] u32 get_framebuffer(
+		    std::span<const Handle<RenderTarget>> colors, Handle<RenderTarget> depth);
+
+		/** Main thread, the statistics are those of the last frame. */
+		void prepare_dev_ui() const;
+
+	private:
+		struct Framebuffer
+		{
+			std::array<u32, MAX_COLOR_ATTACHMENTS> colors{};
+			u32                                    depth = 0;
+			u32                                    id = 0;
+		};
+
+		void destroy(u32 item_index);
+
+		HandlePool<RenderTarget> m_targets;
+		std::vector<Framebuffer> m_framebuffers;
+		u32                      m_max_unused_frames;
+		u64                      m_frame = 0;
+		i32                      m_viewport_width = 1;
+		i32                      m_viewport_height = 1;
+		f32                      m_resolution_scale = 1.0f;
+
+		// render thread, published at the start of the next frame
+		u32         m_frame_acquisitions = 0;
+		std::size_t m_frame_requested_bytes = 0;  // without sharing
+
+		// read by the dev UI
+		std::atomic<u32>         m_stat_target_count = 0;
+		std::atomic<u32>         m_stat_framebuffer_count = 0;
+		std::atomic<u32>         m_stat_acquisitions = 0;
+		std::atomic<std::size_t> m_stat_allocated_bytes = 0;
+		std::atomic<std::size_t> m_stat_requested_bytes = 0;
+		std::atomic<f32>         m_stat_resolution_scale = 1.0f;
+	};
+}  // namespace core
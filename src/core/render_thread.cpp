@@ -0,0 +1,270 @@
+#include "core/render_thread.hpp"
+
+#include "core/async.hpp"
+#include "core/frame_pacing.hpp"
+#include "core/gl_calls.hpp"
+#include "core/gpu_profiler.hpp"
+#include "core/memory.hpp"
+#include "core/renderer.hpp"
+#include "core/timing.hpp"
+#include "core/window.h"
+
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+#include <tracy/TracyOpenGL.hpp>
+
+#include <algorithm>
+
+// a snapshot may point into the frame arena it was built in, up to SLOT_COUNT snapshots are
+// still drawn when the next frame starts
+static_assert(
+    core::RenderThread::SLOT_COUNT < core::memory::FRAME_ARENA_COUNT,
+    "The frame being built and every snapshot slot need their own frame arena.");
+
+core::RenderThread::RenderThread(
+    const Window& window, Renderer& renderer, FramePacer& frame_pacer, const Config& config)
+    : m_window{ &window }
+    , m_renderer{ &renderer }
+    , m_frame_pacer{ &frame_pacer }
+    , m_max_frames_in_flight{ std::min(config.max_frames_in_flight, MAX_FRAMES_IN_FLIGHT) }
+{
+	for (auto& snapshot : m_snapshots)
+	{
+		snapshot = std::make_unique<FrameSnapshot>();
+	}
+
+	// a context is current on one thread at a time
+	if (!SDL_GL_MakeCurrent(m_window->get_window_handle(), nullptr))
+	{
+		SPDLOG_ERROR("Could not release the OpenGL context: {}", SDL_GetError());
+	}
+
+	m_thread = std::thread(&RenderThread::thread_loop, this);
+}
+
+core::RenderThread::~RenderThread()
+{
+	stop();
+}
+
+core::FrameSnapshot* core::RenderThread::begin_frame()
+{
+	ZoneScopedN("Wait for render thread");
+
+	std::unique_lock lock{ m_mutex };
+	m_work_done.wait(
+	    lock,
+	    [this]
+	    {
+		    return m_submitted_count - m_completed_count <= m_max_frames_in_flight;
+	    });
+
+	// the frames still in flight use the slots before this one
+	FrameSnapshot* snapshot = m_snapshots[m_submitted_count % SLOT_COUNT].get();
+	snapshot->frame_index = m_submitted_count;
+	return snapshot;
+}
+
+u64 core::RenderThread::get_next_frame_index() const
+{
+	// only the main thread writes it
+	return m_submitted_count;
+}
+
+void core::RenderThread::submit_frame()
+{
+	{
+		std::lock_guard lock{ m_mutex };
+		++m_submitted_count;
+	}
+	m_work_ready.notify_one();
+}
+
+void core::RenderThread::run_blocking(void (*function)(void* data), void* data)
+{
+	ZoneScopedN("Run on render thread");
+
+	if (!m_thread.joinable())
+	{
+		function(data);
+		return;
+	}
+
+	std::unique_lock lock{ m_mutex };
+	m_work_done.wait(
+	    lock,
+	    [this]
+	    {
+		    return m_completed_count == m_submitted_count;
+	    });
+
+	m_task = function;
+	m_task_data = data;
+	m_work_ready.notify_one();
+
+	m_work_done.wait(
+	    lock,
+	    [this]
+	    {
+		    return m_task == nullptr;
+	    });
+}
+
+void core::RenderThread::stop()
+{
+	if (!m_thread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock{ m_mutex };
+		m_should_stop = true;
+	}
+	m_work_ready.notify_one();
+	m_thread.join();
+
+	if (!SDL_GL_MakeCurrent(m_window->get_window_handle(), m_window->get_gl_context()))
+	{
+		SPDLOG_ERROR("Could not take the OpenGL context back: {}", SDL_GetError());
+	}
+}
+
+void core::RenderThread::set_max_frames_in_flight(u32 max_frames_in_flight)
+{
+	{
+		std::lock_guard lock{ m_mutex };
+		m_max_frames_in_flight = std::min(max_frames_in_flight, MAX_FRAMES_IN_FLIGHT);
+	}
+	// more room, the main thread may be waiting for it
+	m_work_done.notify_all();
+}
+
+void core::RenderThread::prepare_dev_ui()
+{
+	ZoneScopedN("Render thread prepare DevUI");
+
+	if (ImGui::CollapsingHeader("Render thread"))
+	{
+		u64 frames_in_flight = 0;
+		i32 max_frames_in_flight = 0;
+		{
+			std::lock_guard lock{ m_mutex };
+			frames_in_flight = m_submitted_count - m_completed_count;
+			max_frames_in_flight = static_cast<i32>(m_max_frames_in_flight);
+		}
+
+		if (ImGui::SliderInt(
+		        "Max frames in flight", &max_frames_in_flight, 0,
+		        static_cast<i32>(MAX_FRAMES_IN_FLIGHT)))
+		{
+			set_max_frames_in_flight(static_cast<u32>(max_frames_in_flight));
+		}
+
+		ImGui::Text("Frames in flight: %llu", static_cast<unsigned long long>(frames_in_flight));
+	}
+}
+
+void core::RenderThread::thread_loop()
+{
+	tracy::SetThreadName("Render");
+
+	if (!SDL_GL_MakeCurrent(m_window->get_window_handle(), m_window->get_gl_context()))
+	{
+		SPDLOG_CRITICAL("The render thread could not take the OpenGL context: {}", SDL_GetError());
+	}
+
+	while (true)
+	{
+		FrameSnapshot* snapshot = nullptr;
+		void (*task)(void* data) = nullptr;
+		void* task_data = nullptr;
+		{
+			std::unique_lock lock{ m_mutex };
+			m_work_ready.wait(
+			    lock,
+			    [this]
+			    {
+				    return m_completed_count < m_submitted_count || m_task != nullptr ||
+				           m_should_stop;
+			    });
+
+			// the submitted frames are drawn before stopping
+			if (m_completed_count < m_submitted_count)
+			{
+				snapshot = m_snapshots[m_completed_count % SLOT_COUNT].get();
+			}
+			else if (m_task != nullptr)
+			{
+				task = m_task;
+				task_data = m_task_data;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if (snapshot != nullptr)
+		{
+			draw_frame(snapshot);
+		}
+		else
+		{
+			task(task_data);
+		}
+
+		{
+			std::lock_guard lock{ m_mutex };
+			if (snapshot != nullptr)
+			{
+				++m_completed_count;
+			}
+			else
+			{
+				m_task = nullptr;
+			}
+		}
+		m_work_done.notify_all();
+	}
+
+	m_frame_pacer->release_gpu_frames();
+	SDL_GL_MakeCurrent(m_window->get_window_handle(), nullptr);
+}
+
+void core::RenderThread::draw_frame(FrameSnapshot* snapshot)
+{
+	ZoneScopedN("Draw frame");
+
+	async::pump_gl_thread();
+	m_frame_pacer->begin_gpu_frame();
+
+	GpuProfiler& gpu_profiler = m_renderer->get_gpu_profiler();
+	gpu_profiler.begin_frame();
+
+	{
+		timing::PhaseScope   phase{ timing::Phase::RENDER };
+		memory::HotPathGuard hot_path{ "Render" };
+		m_renderer->render(*snapshot);
+	}
+
+	{
+		timing::PhaseScope phase{ timing::Phase::RENDER };
+		const GpuScope     gpu_scope{ gpu_profiler, "Dev UI" };
+		dev_ui::render_draw_data(&snapshot->ui);
+	}
+	gpu_profiler.end_frame();
+
+	{
+		timing::PhaseScope phase{ timing::Phase::SWAP };
+		m_window->gl_swap();
+	}
+	m_frame_pacer->end_gpu_frame();
+	gl_calls::end_frame();
+
+	FrameMarkNamed("Render");
+	TracyGpuCollect;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "core/render_commands.hpp"
+#include "core/types.hpp"
+#include "dev_ui/dev_ui.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * The OpenGL context lives on a dedicated render thread. The main thread runs
+ * the input, the simulation and the UI then fills an immutable snapshot of the
+ * frame (camera, draw items, UI draw data) and hands it over, the render thread
+ * submits it to GL and swaps while the main thread already works on the next
+ * frame. Blocking in SDL_GL_SwapWindow (vsync, a full driver queue) no longer
+ * stalls the simulation.
+ *
+ * Snapshots rotate through MAX_FRAMES_IN_FLIGHT + 1 slots: with one frame in
+ * flight the main thread fills frame N + 1 while frame N is drawn (double
+ * buffering), with two it may also queue a finished frame (triple buffering),
+ * with zero it waits for every frame to be drawn before starting the next one.
+ * More frames in flight absorb spikes on either side at the cost of latency.
+ */
+namespace core
+{
+	class FramePacer;
+	class Renderer;
+	class Window;
+
+	/** Everything the render thread reads for a frame, written by the main thread only. */
+	struct FrameSnapshot
+	{
+		u64                      frame_index = 0;
+		glm::mat4                view{ 1.0f };
+		glm::mat4                projection{ 1.0f };
+		std::vector<DrawItem>    draw_items;  // sorted by key, the capacity is kept
+		i32                      viewport_width = 0;  // 0 keeps the current viewport
+		i32                      viewport_height = 0;
+		f32                      resolution_scale = 1.0f;  // of the offscreen scene targets
+		b8                       is_wireframe_active = false;
+		b8                       is_reset_requested = false;
+		dev_ui::DrawDataSnapshot ui;
+	};
+
+	class RenderThread
+	{
+	public:
+		static constexpr u32 MAX_FRAMES_IN_FLIGHT = 2;
+		static constexpr u32 SLOT_COUNT = MAX_FRAMES_IN_FLIGHT + 1;
+
+		struct Config
+		{
+			u32 max_frames_in_flight = 1;
+		};
+
+		/** Takes the OpenGL context from the calling thread. */
+		RenderThread(
+		    const Window& window, Renderer& renderer, FramePacer& frame_pacer, const Config& config);
+		~RenderThread();
+
+		RenderThread(const RenderThread& other) = delete;
+		RenderThread& operator=(const RenderThread& other) = delete;
+		RenderThread(RenderThread&& other) noexcept = delete;
+		RenderThread& operator=(RenderThread&& other) noexcept = delete;
+
+		/**
+		 * Waits for a free slot, at most `max_frames_in_flight` frames are queued or being
+		 * drawn when it returns. The snapshot keeps the content of an older frame.
+		 */
+		[[nodiscard]] FrameSnapshot* begin_frame();
+
+		/** Main thread, index of the snapshot the next begin_frame returns. */
+		[[nodiscard]] u64 get_next_frame_index() const;
+
+		/** Hands the snapshot returned by begin_frame over to the render thread. */
+		void submit_frame();
+
+		/**
+		 * Runs the function on the render thread once the submitted frames are drawn and
+		 * waits for it, for the rare GL work the main thread depends on.
+		 */
+		void run_blocking(void (*function)(void* data), void* data);
+
+		/** Draws the submitted frames then gives the OpenGL context back to the caller. */
+		void stop();
+
+		void set_max_frames_in_flight(u32 max_frames_in_flight);
+
+		void prepare_dev_ui();
+
+	private:
+		void thread_loop();
+		void draw_frame(FrameSnapshot* snapshot);
+
+		const Window* m_window;
+		Renderer*     m_renderer;
+		FramePacer*   m_frame_pacer;
+
+		std::array<std::unique_ptr<FrameSnapshot>, SLOT_COUNT> m_snapshots;
+
+		// guarded by m_mutex
+		std::mutex              m_mutex;
+		std::condition_variable m_work_ready;  // render thread side
+		std::condition_variable m_work_done;  // main thread side
+		u64                     m_submitted_count = 0;
+		u64                     m_completed_count = 0;
+		u32                     m_max_frames_in_flight;
+		void (*m_task)(void* data) = nullptr;
+		void*                   m_task_data = nullptr;
+		b8                      m_should_stop = false;
+
+		std::thread m_thread;
+	};
+}  // namespace core
@@ -3,12 +3,11 @@
 #include "core/camera.hpp"
 #include "core/event_handler.hpp"
 #include "core/filesystem.hpp"
-#include "core/timing.hpp"
+#include "core/render_thread.hpp"
+#include "core/scene.hpp"
 #include "core/window.h"
-#include "glm/ext/matrix_clip_space.hpp"
 #include "glm/ext/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
-#include "utils/texture_utils.hpp"
 
 #include <glad/gl.h>
 #include <imgui/imgui.h>
@@ -19,6 +18,7 @@
 
 #include <glm/glm.hpp>
 #include <span>
+#include <utility>
 
 namespace
 {
@@ -85,6 +85,9 @@ namespace
 		// clang-format on
 	}
 
+	// clip space, the corners beyond the screen are clipped
+	static constexpr std::array FULLSCREEN_TRIANGLE = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+
 	static constexpr std::array CUBE_POSITIONS = {
 		glm::vec3(0.0f, 0.0f, 0.0f),    glm::vec3(2.0f, 5.0f, -15.0f),
 		glm::vec3(-1.5f, -2.2f, -2.5f), glm::vec3(-3.8f, -2.0f, -12.3f),
@@ -92,140 +95,320 @@ namespace
 		glm::vec3(1.3f, -2.0f, -2.5f),  glm::vec3(1.5f, 2.0f, -2.5f),
 		glm::vec3(1.5f, 0.2f, -1.5f),   glm::vec3(-1.3f, 1.0f, -1.5f)
 	};
-
-	static f32 g_aspect_ratio = 16.0f / 9.0f;
 }  // namespace
 
-core::Renderer::Renderer(const core::Window& window, const core::Camera& camera)
-    : m_shader{ CoreShaderFile("vertex_shader.vert"), CoreShaderFile("fragment_shader.frag") }
+core::Renderer::Renderer(
+    const core::Window& window, core::Camera& camera, scene::Scene& scene)
+    : m_resources{ {} }
     , m_window{ &window }
     , m_camera{ &camera }
+    , m_scene{ &scene }
 {
-	glGenVertexArrays(1, &m_vao);
-	glGenBuffers(1, &m_vbo);
-	glGenBuffers(1, &m_ebo);
-	glGenTextures(1, &m_texture);
-	glGenTextures(1, &m_texture2);
+	m_shader = m_resources.load_shader("vertex_shader.vert", "fragment_shader.frag");
+	m_upscale_shader = m_resources.load_shader("upscale.vert", "upscale.frag");
 
-	g_aspect_ratio = m_window->get_aspect_ratio();
+	m_camera->set_aspect_ratio(m_window->get_aspect_ratio());
 }
 
-core::Renderer::~Renderer()
-{
-	glDeleteVertexArrays(1, &m_vao);
-	glDeleteBuffers(1, &m_vbo);
-	glDeleteBuffers(1, &m_ebo);
-	glDeleteTextures(1, &m_texture);
-	glDeleteTextures(1, &m_texture2);
-}
+// the resource manager deletes the GL objects
+core::Renderer::~Renderer() = default;
 
 void core::Renderer::setup_rendering()
 {
 	static constexpr auto VERTICES = cube();
+	// position, texture coordinates
+	static constexpr std::array LAYOUT = { VertexAttribute{ 3 }, VertexAttribute{ 2 } };
 
-	// not used
-	// static constexpr std::array INDICES = {
-	// 	0, 1, 3,  // first triangle
-	// 	1, 2, 3  // second triangle
-	// };
+	// resources are created once, calling this again reuses them
+	if (m_cube_mesh.is_null())
+	{
+		m_cube_mesh = m_resources.create_mesh(VERTICES, LAYOUT);
+	}
 
-	glBindVertexArray(m_vao);
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(VERTICES), VERTICES.data(), GL_STATIC_DRAW);
+	if (m_fullscreen_triangle.is_null())
+	{
+		static constexpr std::array POSITION_LAYOUT = { VertexAttribute{ 2 } };
+		m_fullscreen_triangle = m_resources.create_mesh(FULLSCREEN_TRIANGLE, POSITION_LAYOUT);
+	}
 
-	// glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-	// glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(INDICES), INDICES.data(), GL_STATIC_DRAW);
+	if (m_material.is_null())
+	{
+		Material material;
+		material.shader = m_shader;
+		material.textures[0] = m_resources.load_texture("container.jpg");
+		material.textures[1] = m_resources.load_texture("awesomeface.png");
+		material.texture_count = 2;
+		m_material = m_resources.create_material(material);
+		spawn_cubes();
+	}
 
-	// position attribute
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(f32), nullptr);
-	glEnableVertexAttribArray(0);
+	bind_sampler_units();
 
-	// texture coordinates attribute
-	glVertexAttribPointer( // NOLINTNEXTLINE(*-no-int-to-ptr)
-	    1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(f32), (const void*)(3 * sizeof(f32)));
-	glEnableVertexAttribArray(1);
+	// the resize events only report the changes, the render targets need the initial size
+	i32 width = 0;
+	i32 height = 0;
+	if (SDL_GetWindowSizeInPixels(m_window->get_window_handle(), &width, &height) && width > 0 &&
+	    height > 0)
+	{
+		m_viewport_width = width;
+		m_viewport_height = height;
+		glViewport(0, 0, width, height);
+	}
 
-	// note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex
-	// attribute's bound vertex buffer object so afterward we can safely unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glEnable(GL_DEPTH_TEST);
 
-	// remember: do NOT unbind the EBO while a VAO is active as the bound element buffer object
-	// IS stored in the VAO; keep the EBO bound. glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+}
 
-	// You can unbind the VAO afterward so other VAO calls won't accidentally modify this VAO,
-	// but this rarely happens. Modifying other VAOs requires a call to glBindVertexArray anyway
-	// so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-	glBindVertexArray(0);
+void core::Renderer::spawn_cubes()
+{
+	const glm::vec3 rotation_axis = glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f));
+	const scene::MeshInstance instance{ m_cube_mesh, m_material };
 
-	load_texture("container.jpg", m_texture);
-	load_texture("awesomeface.png", m_texture2);
+	ecs::World&         world = m_scene->world;
+	TransformHierarchy& transforms = m_scene->transforms;
 
-	m_shader.use();  // activate before setting uniforms
-	// inform OpenGL to which texture unit each shader sampler belongs to
-	m_shader.set_int32("texture1", 0);
-	m_shader.set_int32("texture2", 1);
+	for (u32 i = 0; i < CUBE_POSITIONS.size(); ++i)
+	{
+		Transform transform{ .position = CUBE_POSITIONS[i] };
 
-	glEnable(GL_DEPTH_TEST);
+		// every third cube spins, the others never change
+		if (i % 3 == 0)
+		{
+			const scene::TransformNode node{ transforms.create(transform) };
+			const scene::Velocity velocity{ .angular = rotation_axis * glm::radians(25.0f) };
+			world.create_entity(node, velocity, instance);
 
-	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+			// a smaller cube attached to the first one orbits around it
+			if (i == 0)
+			{
+				const Transform child{ .position = { 1.2f, 0.0f, 0.0f }, .scale = glm::vec3{ 0.3f } };
+				world.create_entity(
+				    scene::TransformNode{ transforms.create(child, node.handle) }, instance);
+			}
+		}
+		else
+		{
+			transform.rotation =
+			    glm::angleAxis(glm::radians(20.0f * static_cast<f32>(i)), rotation_axis);
+			world.create_entity(scene::TransformNode{ transforms.create(transform) }, instance);
+		}
+	}
 }
 
-void core::Renderer::render() const
+void core::Renderer::bind_sampler_units()
 {
-	ZoneScopedN("Render");
+	if (const Shader* shader = m_resources.get_shaders().get(m_shader))
+	{
+		shader->use();  // activate before setting uniforms
+		// inform OpenGL to which texture unit each shader sampler belongs to
+		shader->set_int32("texture1", 0);
+		shader->set_int32("texture2", 1);
+	}
 
+	if (const Shader* shader = m_resources.get_shaders().get(m_upscale_shader))
 	{
-		ZoneNamedN(RenderSetup, "RenderSetup", true);
-		// wireframe on/off
-		glPolygonMode(GL_FRONT_AND_BACK, m_is_wireframe_active ? GL_LINE : GL_FILL);
+		shader->use();
+		shader->set_int32("source", 0);
+	}
+}
 
-		// clear the screen if not drawing in full to avoid flickering
-		// clear the depth buffer from the previous frame
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void core::Renderer::prepare_frame(f32 interpolation, FrameSnapshot* snapshot)
+{
+	ZoneScopedN("Prepare frame");
+
+	snapshot->view = m_camera->get_view_matrix();
+	snapshot->projection = m_camera->get_projection_matrix();
+	snapshot->viewport_width = std::exchange(m_requested_viewport_width, 0);
+	snapshot->viewport_height = std::exchange(m_requested_viewport_height, 0);
+	snapshot->is_wireframe_active = m_is_wireframe_active;
+	snapshot->resolution_scale = m_resolution_scale;
+	snapshot->is_reset_requested = std::exchange(m_is_reset_requested, false);
+
+	const TransformHierarchy& transforms = m_scene->transforms;
+	const glm::mat4&          view = snapshot->view;
+	CommandRecorder&          recorder = m_command_recorder;
+
+	// every ECS chunk is recorded by a job, into the list of the thread running it
+	recorder.begin_frame();
+	m_scene->world.query<const scene::TransformNode, const scene::MeshInstance>().parallel_each(
+	    [&transforms, &view, &recorder, interpolation](
+	        const scene::TransformNode& node, const scene::MeshInstance& instance)
+	    {
+		    DrawItem item{ .mesh = instance.mesh, .material = instance.material };
+		    if (!transforms.get_interpolated_world_matrix(node.handle, interpolation, &item.model))
+		    {
+			    return;
+		    }
+
+		    // the camera looks down -z, the distance grows with -z
+		    const f32 view_depth = -(view * item.model[3]).z;
+		    item.sort_key = make_sort_key(instance.material, instance.mesh, view_depth);
+		    recorder.get_list().push(item);
+	    });
+
+	recorder.merge(&snapshot->draw_items);
+}
 
-		{
-			TracyGpuZone("Shader Setup");
-			m_shader.use();
+void core::Renderer::render(const FrameSnapshot& snapshot)
+{
+	ZoneScopedN("Render");
 
-			glm::mat4 view = m_camera->get_view_matrix();
+	if (snapshot.is_reset_requested)
+	{
+		if (reset())
+		{  // NOLINT(*-branch-clone)
+			SPDLOG_INFO("All Shaders reloaded OK.");
+		}
+		else
+		{
+			SPDLOG_ERROR("Error reloading shaders.");
+		}
+	}
 
-			glm::mat4 projection =
-			    glm::perspective(glm::radians(m_camera->get_zoom()), g_aspect_ratio, 0.1f, 100.0f);
+	if (snapshot.viewport_width > 0 && snapshot.viewport_height > 0)
+	{
+		m_viewport_width = snapshot.viewport_width;
+		m_viewport_height = snapshot.viewport_height;
+	}
 
-			m_shader.set_mat4("view", view);
-			m_shader.set_mat4("projection", projection);
-		}
+	// the scene renders offscreen at the scaled resolution, then is upscaled to the window
+	const f32 resolution_scale =
+	    m_dynamic_resolution.update(snapshot.resolution_scale, m_gpu_profiler);
+	m_render_targets.begin_frame(m_viewport_width, m_viewport_height, resolution_scale);
 
-		glActiveTexture(GL_TEXTURE0);  // activate the texture unit first before binding texture
-		glBindTexture(GL_TEXTURE_2D, m_texture);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, m_texture2);
+	m_frame_graph.reset();
+	const u32 backbuffer =
+	    m_frame_graph.import_backbuffer("Backbuffer", m_viewport_width, m_viewport_height);
+	const u32 scene_color =
+	    m_frame_graph.create_texture("Scene color", { .format = TargetFormat::RGBA8 });
+	const u32 scene_depth =
+	    m_frame_graph.create_texture("Scene depth", { .format = TargetFormat::DEPTH24_STENCIL8 });
 
-		glBindVertexArray(m_vao);
-		// since we aren't using indices...
-		// glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+	struct ScenePass
+	{
+		Renderer*            renderer;
+		const FrameSnapshot* snapshot;
+	};
+	ScenePass scene_pass{ this, &snapshot };
+	const u32 scene = m_frame_graph.add_pass(
+	    "Scene",
+	    [](const PassContext& /*context*/, void* data)
+	    {
+		    const auto& pass = *static_cast<ScenePass*>(data);
+		    {
+			    ZoneNamedN(RenderSetup, "RenderSetup", true);
+
+			    // wireframe on/off
+			    glPolygonMode(
+			        GL_FRONT_AND_BACK, pass.snapshot->is_wireframe_active ? GL_LINE : GL_FILL);
+
+			    // clear the screen if not drawing in full to avoid flickering
+			    // clear the depth buffer from the previous frame
+			    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		    }
+		    pass.renderer->draw_scene(*pass.snapshot);
+	    },
+	    &scene_pass);
+	m_frame_graph.write(scene, scene_color);
+	m_frame_graph.write(scene, scene_depth);
+
+	struct UpscalePass
+	{
+		const RenderTargetPool* render_targets;
+		const Shader*           shader;
+		const Mesh*             triangle;
+		u32                     scene_color;
+		f32                     sharpness;
+	};
+	UpscalePass upscale_pass{
+		&m_render_targets,
+		m_resources.get_shaders().get(m_upscale_shader),
+		m_resources.get_meshes().get(m_fullscreen_triangle),
+		scene_color,
+		m_dynamic_resolution.get_sharpness(),
+	};
+	const u32 upscale = m_frame_graph.add_pass(
+	    "Upscale",
+	    [](const PassContext& context, void* data)
+	    {
+		    const auto&         pass = *static_cast<UpscalePass*>(data);
+		    const RenderTarget* color =
+		        pass.render_targets->get(context.get_target(pass.scene_color));
+		    if (pass.shader == nullptr || pass.triangle == nullptr || color == nullptr)
+		    {
+			    return;
+		    }
+
+		    // at the native resolution there is nothing to reconstruct
+		    const b8 is_scaled = context.get_size(pass.scene_color) != context.size;
+
+		    glDisable(GL_DEPTH_TEST);
+		    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		    pass.shader->use();
+		    pass.shader->set_float("sharpness", is_scaled ? pass.sharpness : 0.0f);
+		    glActiveTexture(GL_TEXTURE0);
+		    glBindTexture(GL_TEXTURE_2D, color->texture);
+		    glBindVertexArray(pass.triangle->vao);
+		    glDrawArrays(GL_TRIANGLES, 0, static_cast<i32>(pass.triangle->vertex_count));
+		    glEnable(GL_DEPTH_TEST);
+	    },
+	    &upscale_pass);
+	m_frame_graph.read(upscale, scene_color);
+	m_frame_graph.write(upscale, backbuffer);
+
+	m_frame_graph.compile();
+	{
+		const GpuScope gpu_scope{ m_gpu_profiler, "Frame graph" };
+		m_frame_graph.execute();
 	}
+	glViewport(0, 0, m_viewport_width, m_viewport_height);
+}
+
+void core::Renderer::draw_scene(const FrameSnapshot& snapshot)
+{
+	ZoneNamedN(Draw, "Draw", true);
 
+	// state changes only when the material or the mesh differs from the previous draw
+	const Shader*    shader = nullptr;
+	Handle<Material> bound_material;
+	Handle<Mesh>     bound_mesh;
+	u32              vertex_count = 0;
+
+	for (const DrawItem& item : snapshot.draw_items)
 	{
-		ZoneNamedN(Draw, "Draw", true);
-		for (unsigned int i = 0; i < 10; i++)
+		if (shader == nullptr || item.material != bound_material)
 		{
-			glm::mat4 model = { 1.0f };
-			model = glm::translate(model, CUBE_POSITIONS[i]);
-			f32 angle = 20.0f * (f32)i;
-
-			if (i % 3 == 0)
+			TracyGpuZone("Shader Setup");
+			shader = m_resources.bind_material(item.material);
+			bound_material = item.material;
+			if (shader == nullptr)
 			{
-				angle = timing::get_elapsed_seconds() * 25.0f;
+				continue;
 			}
 
-			model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-			m_shader.set_mat4("model", model);
+			shader->set_mat4("view", snapshot.view);
+			shader->set_mat4("projection", snapshot.projection);
+		}
 
+		if (item.mesh != bound_mesh)
+		{
+			const Mesh* mesh = m_resources.get_meshes().get(item.mesh);
+			if (mesh == nullptr)
 			{
-				TracyGpuZone("Draw");
-				glDrawArrays(GL_TRIANGLES, 0, 36);
+				continue;
 			}
+
+			glBindVertexArray(mesh->vao);
+			bound_mesh = item.mesh;
+			vertex_count = mesh->vertex_count;
+		}
+
+		shader->set_mat4("model", item.model);
+
+		{
+			TracyGpuZone("Draw");
+			glDrawArrays(GL_TRIANGLES, 0, static_cast<i32>(vertex_count));
 		}
 	}
 }
@@ -236,51 +419,75 @@ void core::Renderer::prepare_dev_ui()
 
 	if (ImGui::CollapsingHeader("Rendering"))
 	{
-		ImGui::SliderFloat("Aspect Ratio", &g_aspect_ratio, 0.1f, 2.0f);
+		f32 aspect_ratio = m_camera->get_aspect_ratio();
+		if (ImGui::SliderFloat("Aspect Ratio", &aspect_ratio, 0.1f, 2.0f))
+		{
+			m_camera->set_aspect_ratio(aspect_ratio);
+		}
+
+		// the offscreen scene targets while the dynamic resolution is off, the dev UI stays at
+		// the native resolution
+		ImGui::SliderFloat(
+		    "Resolution scale", &m_resolution_scale, RenderTargetPool::MIN_RESOLUTION_SCALE, 1.0f,
+		    "%.2f");
+
+		// recorded on the main thread and the workers, in parallel
+		for (u32 i = 0; i < m_command_recorder.get_list_count(); ++i)
+		{
+			ImGui::Text("Commands of thread %u: %u", i, m_command_recorder.get_command_count(i));
+		}
+		ImGui::Text("Dropped commands: %u", m_command_recorder.get_dropped_count());
 
+		// the render thread reloads them with the next frame and logs the result
 		if (ImGui::Button("Reload shaders"))
 		{
-			if (!m_is_shader_reloading)
-			{
-				if (reset())
-				{  // NOLINT(*-branch-clone)
-					SPDLOG_INFO("All Shaders reloaded OK.");
-				}
-				else
-				{
-					SPDLOG_ERROR("Error reloading shaders.");
-				}
-			}
-			else
-			{
-				SPDLOG_INFO("Compiling shaders, please wait...");
-			}
+			request_reset();
 		}
 	}
+
+	m_gpu_profiler.prepare_dev_ui();
+	m_dynamic_resolution.prepare_dev_ui();
+	m_render_targets.prepare_dev_ui();
+	m_frame_graph.prepare_dev_ui();
 }
 
 void core::Renderer::handle_input(EventHandler& event_handler)
 {
-	if (event_handler.is_key_just_pressed(SDLK_U))
+	if (event_handler.is_action_just_pressed(input::Action::TOGGLE_WIREFRAME))
 	{
 		m_is_wireframe_active = !m_is_wireframe_active;
 	}
 
-	if (event_handler.is_key_just_pressed(SDLK_I))
+	if (event_handler.is_action_just_pressed(input::Action::TOGGLE_MOUSE_CAPTURE))
 	{
 		event_handler.toggle_mouse_capture();
 	}
 }
 
-b8 core::Renderer::reset()
+void core::Renderer::request_reset()
 {
-	m_is_shader_reloading = true;
-	m_shader = { CoreShaderFile("vertex_shader.vert"), CoreShaderFile("fragment_shader.frag") };
-	m_is_shader_reloading = false;
+	m_is_reset_requested = true;
+}
+
+void core::Renderer::on_window_resized(i32 width, i32 height)
+{
+	// minimized, the previous size is kept for the restore
+	if (width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	m_requested_viewport_width = width;
+	m_requested_viewport_height = height;
+	m_camera->set_aspect_ratio(static_cast<f32>(width) / static_cast<f32>(height));
+}
 
-	setup_rendering();
+b8 core::Renderer::reset()
+{
+	const b8 are_shaders_valid = m_resources.reload_shaders();
 
-	g_aspect_ratio = m_window->get_aspect_ratio();
+	// meshes and textures are kept, only the new programs need their samplers
+	bind_sampler_units();
 
-	return m_shader.is_valid();
+	return are_shaders_valid;
 }
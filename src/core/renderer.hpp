@@ -1,6 +1,11 @@
 #pragma once
 
-#include "core/shader.hpp"
+#include "core/dynamic_resolution.hpp"
+#include "core/frame_graph.hpp"
+#include "core/gpu_profiler.hpp"
+#include "core/render_commands.hpp"
+#include "core/render_target_pool.hpp"
+#include "core/resources.hpp"
 #include "core/types.hpp"
 
 namespace core
@@ -9,11 +14,18 @@ namespace core
 	class Camera;
 	class EventHandler;
 	class Filesystem;
+	struct FrameSnapshot;
+
+	namespace scene
+	{
+		struct Scene;
+	}
 
 	class Renderer
 	{
 	public:
-		explicit Renderer(const core::Window& window, const core::Camera& camera);
+		explicit Renderer(
+		    const core::Window& window, core::Camera& camera, scene::Scene& scene);
 		~Renderer();
 
 		Renderer(const Renderer& other) = delete;
@@ -21,24 +33,68 @@ namespace core
 		Renderer(Renderer&& other) noexcept = default;
 		Renderer& operator=(Renderer&& other) noexcept = default;
 
+		/** Before the render thread takes the OpenGL context. */
 		void setup_rendering();
-		void render() const;
+
+		/**
+		 * Main thread, fills the snapshot with the scene between its last two simulation
+		 * ticks (see FixedTimestep) and the requests of the frame.
+		 */
+		void prepare_frame(f32 interpolation, FrameSnapshot* snapshot);
+
+		/** Render thread. */
+		void render(const FrameSnapshot& snapshot);
+
+		/** Render thread for the frames and scopes, any thread for the statistics. */
+		[[nodiscard]] GpuProfiler& get_gpu_profiler()
+		{
+			return m_gpu_profiler;
+		}
+
 		void handle_input(EventHandler& event_handler);
 		void prepare_dev_ui();
-		b8   reset();
+
+		/** Reloads the shaders with the next frame. */
+		void request_reset();
+
+		/**
+		 * In pixels, once per frame with the last size: fits the camera, the viewport follows
+		 * with the next frame. Nothing is reloaded, a drag keeps the frame rate.
+		 */
+		void on_window_resized(i32 width, i32 height);
 
 	private:
-		Shader              m_shader;
-		u32                 m_vao{};
-		u32                 m_vao2{};
-		u32                 m_vbo{};
-		u32                 m_vbo2{};
-		u32                 m_ebo{};
-		u32                 m_texture{};
-		u32                 m_texture2{};
-		b8                  m_is_shader_reloading{};
+		/** Render thread. */
+		b8   reset();
+		void draw_scene(const FrameSnapshot& snapshot);
+		void bind_sampler_units();
+		void spawn_cubes();
+
+		// render thread, once started
+		ResourceManager  m_resources;
+		RenderTargetPool m_render_targets{ {} };
+		GpuProfiler      m_gpu_profiler;
+		FrameGraph       m_frame_graph{ m_render_targets, m_gpu_profiler };
+		i32              m_viewport_width = 1;
+		i32              m_viewport_height = 1;
+
+		// configured by the main thread, controlled by the render thread
+		DynamicResolution m_dynamic_resolution{ {} };
+
+		// main thread
+		CommandRecorder     m_command_recorder{ {} };
+		Handle<Shader>      m_shader;
+		Handle<Shader>      m_upscale_shader;
+		Handle<Mesh>        m_cube_mesh;
+		Handle<Mesh>        m_fullscreen_triangle;
+		Handle<Material>    m_material;
+		b8                  m_is_reset_requested{};
 		b8                  m_is_wireframe_active{};
+		f32                 m_resolution_scale = 1.0f;
+		i32                 m_requested_viewport_width = 0;
+		i32                 m_requested_viewport_height = 0;
 		const core::Window* m_window;
-		const core::Camera* m_camera;
+		core::Camera*       m_camera;
+		scene::Scene*       m_scene;
 	};
 }  // namespace core
@@ -0,0 +1,215 @@
+#include "core/resources.hpp"
+
+#include "utils/texture_utils.hpp"
+
+#include <glad/gl.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <utility>
+
+core::Mesh::Mesh()
+{
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+}
+
+core::Mesh::~Mesh()
+{
+	// deleting the name 0 is silently ignored, moved-from meshes are fine
+	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(1, &vbo);
+}
+
+core::Mesh::Mesh(Mesh&& other) noexcept
+    : vao{ std::exchange(other.vao, 0) }
+    , vbo{ std::exchange(other.vbo, 0) }
+    , vertex_count{ other.vertex_count }
+{
+}
+
+core::Mesh& core::Mesh::operator=(Mesh&& other) noexcept
+{
+	std::swap(vao, other.vao);
+	std::swap(vbo, other.vbo);
+	std::swap(vertex_count, other.vertex_count);
+	return *this;
+}
+
+core::Texture::Texture()
+{
+	glGenTextures(1, &id);
+}
+
+core::Texture::~Texture()
+{
+	glDeleteTextures(1, &id);
+}
+
+core::Texture::Texture(Texture&& other) noexcept
+    : id{ std::exchange(other.id, 0) }
+{
+}
+
+core::Texture& core::Texture::operator=(Texture&& other) noexcept
+{
+	std::swap(id, other.id);
+	return *this;
+}
+
+core::ResourceManager::ResourceManager(const ResourceCapacities& capacities)
+    : m_meshes{ capacities.meshes }
+    , m_textures{ capacities.textures }
+    , m_shaders{ capacities.shaders }
+    , m_materials{ capacities.materials }
+{
+	m_texture_by_name.reserve(capacities.textures);
+	m_shader_sources.reserve(capacities.shaders);
+}
+
+core::Handle<core::Mesh> core::ResourceManager::create_mesh(
+    std::span<const f32> vertices, std::span<const VertexAttribute> layout)
+{
+	ZoneScopedN("Create mesh");
+
+	u32 floats_per_vertex = 0;
+	for (const VertexAttribute& attribute : layout)
+	{
+		floats_per_vertex += attribute.component_count;
+	}
+
+	if (floats_per_vertex == 0 || vertices.size() % floats_per_vertex != 0)
+	{
+		SPDLOG_ERROR("Mesh vertices don't match the layout.");
+		return {};
+	}
+
+	const Handle<Mesh> handle = m_meshes.create();
+	Mesh*              mesh = m_meshes.get(handle);
+	if (mesh == nullptr)
+	{
+		return {};
+	}
+
+	mesh->vertex_count = static_cast<u32>(vertices.size() / floats_per_vertex);
+
+	glBindVertexArray(mesh->vao);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+	glBufferData(
+	    GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size_bytes()), vertices.data(),
+	    GL_STATIC_DRAW);
+
+	const i32 stride = static_cast<i32>(floats_per_vertex * sizeof(f32));
+	u32       offset = 0;
+
+	for (u32 i = 0; i < layout.size(); ++i)
+	{
+		glVertexAttribPointer( // NOLINTNEXTLINE(*-no-int-to-ptr)
+		    i, static_cast<i32>(layout[i].component_count), GL_FLOAT, GL_FALSE, stride,
+		    (const void*)(offset * sizeof(f32)));
+		glEnableVertexAttribArray(i);
+		offset += layout[i].component_count;
+	}
+
+	// the VAO keeps the attribute bindings, both can be unbound
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return handle;
+}
+
+core::Handle<core::Texture> core::ResourceManager::load_texture(std::string_view file_name)
+{
+	const std::string name{ file_name };
+
+	if (auto it = m_texture_by_name.find(name);
+	    it != m_texture_by_name.end() && m_textures.is_valid(it->second))
+	{
+		return it->second;
+	}
+
+	const Handle<Texture> handle = m_textures.create();
+	if (m_textures.is_valid(handle))
+	{
+		// textures show up once they are decoded and uploaded (a few frames later)
+		spawn(load_texture_async(name, &m_textures, handle));
+		m_texture_by_name[name] = handle;
+	}
+
+	return handle;
+}
+
+core::Handle<core::Shader> core::ResourceManager::load_shader(
+    std::string_view vertex_file_name, std::string_view fragment_file_name)
+{
+	for (const ShaderSource& source : m_shader_sources)
+	{
+		if (source.vertex_file_name == vertex_file_name &&
+		    source.fragment_file_name == fragment_file_name && m_shaders.is_valid(source.handle))
+		{
+			return source.handle;
+		}
+	}
+
+	const Handle<Shader> handle =
+	    m_shaders.create(CoreShaderFile(vertex_file_name), CoreShaderFile(fragment_file_name));
+
+	if (!handle.is_null())
+	{
+		m_shader_sources.push_back(
+		    { std::string{ vertex_file_name }, std::string{ fragment_file_name }, handle });
+	}
+
+	return handle;
+}
+
+core::Handle<core::Material> core::ResourceManager::create_material(const Material& material)
+{
+	return m_materials.create(material);
+}
+
+b8 core::ResourceManager::reload_shaders()
+{
+	ZoneScopedN("Reload shaders");
+
+	b8 are_all_valid = true;
+
+	for (const ShaderSource& source : m_shader_sources)
+	{
+		if (Shader* shader = m_shaders.get(source.handle))
+		{
+			*shader = Shader{ CoreShaderFile(source.vertex_file_name),
+				              CoreShaderFile(source.fragment_file_name) };
+			are_all_valid = are_all_valid && shader->is_valid();
+		}
+	}
+
+	return are_all_valid;
+}
+
+const core::Shader* core::ResourceManager::bind_material(Handle<Material> handle) const
+{
+	const Material* material = m_materials.get(handle);
+	if (material == nullptr)
+	{
+		return nullptr;
+	}
+
+	const Shader* shader = m_shaders.get(material->shader);
+	if (shader == nullptr)
+	{
+		return nullptr;
+	}
+
+	shader->use();
+
+	for (u32 i = 0; i < material->texture_count; ++i)
+	{
+		const Texture* texture = m_textures.get(material->textures[i]);
+
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, texture != nullptr ? texture->id : 0);
+	}
+
+	return shader;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "core/handle_pool.hpp"
+#include "core/shader.hpp"
+#include "core/types.hpp"
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace core
+{
+	/** Vertex array with its buffers, the GL objects are deleted with the mesh. */
+	class Mesh
+	{
+	public:
+		Mesh();
+		~Mesh();
+
+		Mesh(const Mesh& other) = delete;
+		Mesh& operator=(const Mesh& other) = delete;
+		Mesh(Mesh&& other) noexcept;
+		Mesh& operator=(Mesh&& other) noexcept;
+
+		u32 vao = 0;
+		u32 vbo = 0;
+		u32 vertex_count = 0;
+	};
+
+	/** GL texture object, deleted with the texture. */
+	class Texture
+	{
+	public:
+		Texture();
+		~Texture();
+
+		Texture(const Texture& other) = delete;
+		Texture& operator=(const Texture& other) = delete;
+		Texture(Texture&& other) noexcept;
+		Texture& operator=(Texture&& other) noexcept;
+
+		u32 id = 0;
+	};
+
+	struct Material
+	{
+		static constexpr u32 MAX_TEXTURES = 4;
+
+		Handle<Shader>                            shader;
+		std::array<Handle<Texture>, MAX_TEXTURES> textures{};  // bound to units 0..N-1
+		u32                                       texture_count = 0;
+	};
+
+	/** Float attributes, tightly interleaved in declaration order. */
+	struct VertexAttribute
+	{
+		u32 component_count;
+	};
+
+	struct ResourceCapacities
+	{
+		u32 meshes = 64;
+		u32 textures = 256;
+		u32 shaders = 32;
+		u32 materials = 256;
+	};
+
+	/**
+	 * Owns the GPU resources, textures and shaders are deduplicated by file name:
+	 * loading the same file twice returns the same handle.
+	 */
+	class ResourceManager
+	{
+	public:
+		explicit ResourceManager(const ResourceCapacities& capacities);
+
+		ResourceManager(const ResourceManager& other) = delete;
+		ResourceManager& operator=(const ResourceManager& other) = delete;
+		ResourceManager(ResourceManager&& other) noexcept = default;
+		ResourceManager& operator=(ResourceManager&& other) noexcept = default;
+
+		[[nodiscard]] Handle<Mesh> create_mesh(
+		    std::span<const f32> vertices, std::span<const VertexAttribute> layout);
+
+		/** The texture is decoded asynchronously, it stays empty for a few frames. */
+		[[nodiscard]] Handle<Texture> load_texture(std::string_view file_name);
+
+		[[nodiscard]] Handle<Shader> load_shader(
+		    std::string_view vertex_file_name, std::string_view fragment_file_name);
+
+		[[nodiscard]] Handle<Material> create_material(const Material& material);
+
+		/** Recompiles every shader in place, handles stay valid. */
+		b8 reload_shaders();
+
+		[[nodiscard]] HandlePool<Mesh>& get_meshes()
+		{
+			return m_meshes;
+		}
+
+		[[nodiscard]] const HandlePool<Mesh>& get_meshes() const
+		{
+			return m_meshes;
+		}
+
+		[[nodiscard]] HandlePool<Texture>& get_textures()
+		{
+			return m_textures;
+		}
+
+		[[nodiscard]] HandlePool<Shader>& get_shaders()
+		{
+			return m_shaders;
+		}
+
+		[[nodiscard]] HandlePool<Material>& get_materials()
+		{
+			return m_materials;
+		}
+
+		/** Uses the material shader and binds its textures, returns the shader. */
+		const Shader* bind_material(Handle<Material> handle) const;
+
+	private:
+		struct ShaderSource
+		{
+			std::string    vertex_file_name;
+			std::string    fragment_file_name;
+			Handle<Shader> handle;
+		};
+
+		HandlePool<Mesh>     m_meshes;
+		HandlePool<Texture>  m_textures;
+		HandlePool<Shader>   m_shaders;
+		HandlePool<Material> m_materials;
+
+		std::unordered_map<std::string, Handle<Texture>> m_texture_by_name;
+		std::vector<ShaderSource>                        m_shader_sources;
+	};
+}  // namespace core
@@ -0,0 +1,59 @@
+#include "core/scene.hpp"
+
+#include <tracy/Tracy.hpp>
+
+namespace
+{
+	using namespace core;
+
+	static void integrate_velocities(
+	    const ecs::SystemContext& context, TransformHierarchy* transforms)
+	{
+		ZoneScopedN("Integrate velocities");
+
+		const f32 delta_time = context.delta_time;
+
+		// every node is written by one entity only, set_local can run in parallel
+		context.world.query<const scene::TransformNode, const scene::Velocity>().parallel_each(
+		    [transforms, delta_time](const scene::TransformNode& node, const scene::Velocity& velocity)
+		    {
+			    const Transform* current = transforms->get_local(node.handle);
+			    if (current == nullptr)
+			    {
+				    return;
+			    }
+
+			    Transform transform = *current;
+			    transform.position += velocity.linear * delta_time;
+
+			    const f32 angular_speed = glm::length(velocity.angular);
+			    if (angular_speed > 0.0f)
+			    {
+				    const glm::quat step =
+				        glm::angleAxis(angular_speed * delta_time, velocity.angular / angular_speed);
+				    transform.rotation = glm::normalize(step * transform.rotation);
+			    }
+
+			    transforms->set_local(node.handle, transform);
+		    });
+	}
+}  // namespace
+
+void core::scene::register_systems(Scene* scene)
+{
+	TransformHierarchy* transforms = &scene->transforms;
+
+	// the locals live in the hierarchy, writing TransformNode keeps other writers out of the batch
+	scene->schedule.add_system<TransformNode, const Velocity>(
+	    "Integrate velocities",
+	    [transforms](const ecs::SystemContext& context)
+	    {
+		    integrate_velocities(context, transforms);
+	    });
+}
+
+void core::scene::update(Scene* scene, f32 delta_time)
+{
+	scene->schedule.run(scene->world, delta_time);
+	scene->transforms.update();
+}
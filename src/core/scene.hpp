@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/ecs.hpp"
+#include "core/handle_pool.hpp"
+#include "core/resources.hpp"
+#include "core/transform_hierarchy.hpp"
+
+#include <glm/glm.hpp>
+
+/** Components of the rendered scene and the systems updating them. */
+namespace core::scene
+{
+	static constexpr u32 TRANSFORM_CAPACITY = 4096;
+
+	/** The entity's node in the scene's transform hierarchy. */
+	struct TransformNode
+	{
+		Handle<Transform> handle;
+	};
+
+	struct Velocity
+	{
+		glm::vec3 linear{ 0.0f };
+		// rotation axis scaled by the speed in radians per second
+		glm::vec3 angular{ 0.0f };
+	};
+
+	struct MeshInstance
+	{
+		Handle<Mesh>     mesh;
+		Handle<Material> material;
+	};
+
+	struct Scene
+	{
+		ecs::World         world;
+		ecs::Schedule      schedule;
+		TransformHierarchy transforms{ TRANSFORM_CAPACITY };
+	};
+
+	void register_systems(Scene* scene);
+
+	/** Runs the systems then recomputes the world matrices that changed. */
+	void update(Scene* scene, f32 delta_time);
+}  // namespace core::scene
@@ -1,5 +1,7 @@
 #include "shader.hpp"
 
+#include "core/memory.hpp"
+
 #include <glad/gl.h>
 #include <spdlog/spdlog.h>
 
@@ -8,15 +10,17 @@
 
 namespace
 {
-	static u32 create_shader(const std::string& code, u32 type, M_UNUSED std::string_view name)
+	static u32 create_shader(std::string_view code, u32 type, M_UNUSED std::string_view name)
 	{
 		using namespace core;
 
 		i32 success = 0;
 		u32 shader_id = glCreateShader(type);
 
-		const char* source_ptr = code.c_str();
-		glShaderSource(shader_id, 1, &source_ptr, nullptr);
+		// the source is not null-terminated when it comes from a scratch buffer
+		const char* source_ptr = code.data();
+		const i32   source_length = static_cast<i32>(code.size());
+		glShaderSource(shader_id, 1, &source_ptr, &source_length);
 		glCompileShader(shader_id);
 
 		glGetShaderiv(shader_id, GL_COMPILE_STATUS, &success);
@@ -35,7 +39,7 @@ namespace
 	}
 
 	static b8 compile_from_glsl_code(
-	    const std::string& vertex_code, const std::string& fragment_code, u32* out_program_id)
+	    std::string_view vertex_code, std::string_view fragment_code, u32* out_program_id)
 	{
 		using namespace core;
 
@@ -82,8 +86,12 @@ namespace
 core::Shader::Shader(
     const CoreShaderFile& vertex_file_name, const CoreShaderFile& fragment_file_name)
 {
-	auto vertex_source = fs::instance().read_file<std::string>(vertex_file_name);
-	auto fragment_source = fs::instance().read_file<std::string>(fragment_file_name);
+	// the sources are only needed until the program is linked
+	memory::ScratchScope scratch;
+	std::pmr::string     vertex_source{ scratch.get_resource() };
+	std::pmr::string     fragment_source{ scratch.get_resource() };
+	fs::instance().read_file(vertex_file_name, &vertex_source);
+	fs::instance().read_file(fragment_file_name, &fragment_source);
 
 	m_is_valid = compile_from_glsl_code(vertex_source, fragment_source, &m_program_id);
 }
@@ -111,66 +119,66 @@ void core::Shader::use() const
 	}
 }
 
-void core::Shader::set_bool(const std::string& name, const b8 value) const
+void core::Shader::set_bool(const char* name, const b8 value) const
 {
-	glUniform1i(glGetUniformLocation(m_program_id, name.c_str()), static_cast<i32>(value));
+	glUniform1i(glGetUniformLocation(m_program_id, name), static_cast<i32>(value));
 }
 
-void core::Shader::set_int32(const std::string& name, const i32 value) const
+void core::Shader::set_int32(const char* name, const i32 value) const
 {
-	glUniform1i(glGetUniformLocation(m_program_id, name.c_str()), value);
+	glUniform1i(glGetUniformLocation(m_program_id, name), value);
 }
 
-void core::Shader::set_float(const std::string& name, const f32 value) const
+void core::Shader::set_float(const char* name, const f32 value) const
 {
-	glUniform1f(glGetUniformLocation(m_program_id, name.c_str()), value);
+	glUniform1f(glGetUniformLocation(m_program_id, name), value);
 }
 
-void core::Shader::set_vec2(const std::string& name, const glm::vec2& value) const
+void core::Shader::set_vec2(const char* name, const glm::vec2& value) const
 {
-	glUniform2fv(glGetUniformLocation(m_program_id, name.c_str()), 1, glm::value_ptr(value));
+	glUniform2fv(glGetUniformLocation(m_program_id, name), 1, glm::value_ptr(value));
 }
 
-void core::Shader::set_vec2(const std::string& name, const f32 x, const f32 y) const
+void core::Shader::set_vec2(const char* name, const f32 x, const f32 y) const
 {
-	glUniform2f(glGetUniformLocation(m_program_id, name.c_str()), x, y);
+	glUniform2f(glGetUniformLocation(m_program_id, name), x, y);
 }
 
-void core::Shader::set_vec3(const std::string& name, const glm::vec3& value) const
+void core::Shader::set_vec3(const char* name, const glm::vec3& value) const
 {
-	glUniform3fv(glGetUniformLocation(m_program_id, name.c_str()), 1, glm::value_ptr(value));
+	glUniform3fv(glGetUniformLocation(m_program_id, name), 1, glm::value_ptr(value));
 }
 
-void core::Shader::set_vec3(const std::string& name, const f32 x, const f32 y, const f32 z) const
+void core::Shader::set_vec3(const char* name, const f32 x, const f32 y, const f32 z) const
 {
-	glUniform3f(glGetUniformLocation(m_program_id, name.c_str()), x, y, z);
+	glUniform3f(glGetUniformLocation(m_program_id, name), x, y, z);
 }
 
-void core::Shader::set_vec4(const std::string& name, const glm::vec4& value) const
+void core::Shader::set_vec4(const char* name, const glm::vec4& value) const
 {
-	glUniform4fv(glGetUniformLocation(m_program_id, name.c_str()), 1, glm::value_ptr(value));
+	glUniform4fv(glGetUniformLocation(m_program_id, name), 1, glm::value_ptr(value));
 }
 
 void core::Shader::set_vec4(
-    const std::string& name, const f32 x, const f32 y, const f32 z, const f32 w) const
+    const char* name, const f32 x, const f32 y, const f32 z, const f32 w) const
 {
-	glUniform4f(glGetUniformLocation(m_program_id, name.c_str()), x, y, z, w);
+	glUniform4f(glGetUniformLocation(m_program_id, name), x, y, z, w);
 }
 
-void core::Shader::set_mat2(const std::string& name, const glm::mat2& value) const
+void core::Shader::set_mat2(const char* name, const glm::mat2& value) const
 {
 	glUniformMatrix2fv(
-	    glGetUniformLocation(m_program_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	    glGetUniformLocation(m_program_id, name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void core::Shader::set_mat3(const std::string& name, const glm::mat3& value) const
+void core::Shader::set_mat3(const char* name, const glm::mat3& value) const
 {
 	glUniformMatrix3fv(
-	    glGetUniformLocation(m_program_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	    glGetUniformLocation(m_program_id, name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void core::Shader::set_mat4(const std::string& name, const glm::mat4& value) const
+void core::Shader::set_mat4(const char* name, const glm::mat4& value) const
 {
 	glUniformMatrix4fv(
-	    glGetUniformLocation(m_program_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+	    glGetUniformLocation(m_program_id, name), 1, GL_FALSE, glm::value_ptr(value));
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <glm/fwd.hpp>
 
+#include <utility>
+
 namespace core
 {
 	class Shader
@@ -28,12 +30,11 @@ namespace core
 			{
 				return *this;
 			}
-			m_program_id = other.m_program_id;
-			m_is_valid = other.m_is_valid;
-
-			// when moved, reset "other" program ID so that its destructor
-			// don't destroy the program
-			other.m_program_id = 0;
+			// swapped, "other" destroys the previous program of this shader (when
+			// replaced in place by a reload for instance)
+			std::swap(m_program_id, other.m_program_id);
+			std::swap(m_is_valid, other.m_is_valid);
+			m_warned = false;
 
 			return *this;
 		}
@@ -44,18 +45,18 @@ namespace core
 		};
 
 		void use() const;
-		void set_bool(const std::string& name, b8 value) const;
-		void set_int32(const std::string& name, i32 value) const;
-		void set_float(const std::string& name, f32 value) const;
-		void set_vec2(const std::string& name, const glm::vec2& value) const;
-		void set_vec2(const std::string& name, f32 x, f32 y) const;
-		void set_vec3(const std::string& name, const glm::vec3& value) const;
-		void set_vec3(const std::string& name, f32 x, f32 y, f32 z) const;
-		void set_vec4(const std::string& name, const glm::vec4& value) const;
-		void set_vec4(const std::string& name, f32 x, f32 y, f32 z, f32 w) const;
-		void set_mat2(const std::string& name, const glm::mat2& value) const;
-		void set_mat3(const std::string& name, const glm::mat3& value) const;
-		void set_mat4(const std::string& name, const glm::mat4& value) const;
+		void set_bool(const char* name, b8 value) const;
+		void set_int32(const char* name, i32 value) const;
+		void set_float(const char* name, f32 value) const;
+		void set_vec2(const char* name, const glm::vec2& value) const;
+		void set_vec2(const char* name, f32 x, f32 y) const;
+		void set_vec3(const char* name, const glm::vec3& value) const;
+		void set_vec3(const char* name, f32 x, f32 y, f32 z) const;
+		void set_vec4(const char* name, const glm::vec4& value) const;
+		void set_vec4(const char* name, f32 x, f32 y, f32 z, f32 w) const;
+		void set_mat2(const char* name, const glm::mat2& value) const;
+		void set_mat3(const char* name, const glm::mat3& value) const;
+		void set_mat4(const char* name, const glm::mat4& value) const;
 
 	private:
 		u32        m_program_id = 0;
@@ -0,0 +1,599 @@
+#include "core/simd.hpp"
+
+#include "utils/assertions.hpp"
+#include "utils/helper_macros.hpp"
+
+#include <spdlog/spdlog.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define SIMD_X86
+#	include <immintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+namespace
+{
+	using namespace core;
+	using simd::mat4x8;
+	using simd::quatx8;
+	using simd::vec3x8;
+
+	using ComposeFn = void (*)(const vec3x8*, const quatx8*, const vec3x8*, mat4x8*, u32);
+	using MultiplyFn = void (*)(const glm::mat4&, const mat4x8*, mat4x8*, u32);
+
+	struct Kernels
+	{
+		simd::Isa  isa = simd::Isa::SCALAR;
+		ComposeFn  compose_trs = nullptr;
+		MultiplyFn multiply = nullptr;
+	};
+
+	// scalar reference, the same operations as glm::mat4_cast
+
+	static void compose_trs_scalar(
+	    const vec3x8* positions, const quatx8* rotations, const vec3x8* scales, mat4x8* out,
+	    u32 block_count)
+	{
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			const vec3x8& p = positions[block];
+			const quatx8& q = rotations[block];
+			const vec3x8& s = scales[block];
+			auto&         m = out[block].elements;
+
+			for (u32 i = 0; i < simd::LANES; ++i)
+			{
+				const f32 xx = q.x[i] * q.x[i];
+				const f32 yy = q.y[i] * q.y[i];
+				const f32 zz = q.z[i] * q.z[i];
+				const f32 xy = q.x[i] * q.y[i];
+				const f32 xz = q.x[i] * q.z[i];
+				const f32 yz = q.y[i] * q.z[i];
+				const f32 wx = q.w[i] * q.x[i];
+				const f32 wy = q.w[i] * q.y[i];
+				const f32 wz = q.w[i] * q.z[i];
+
+				m[0][i] = (1.0f - 2.0f * (yy + zz)) * s.x[i];
+				m[1][i] = 2.0f * (xy + wz) * s.x[i];
+				m[2][i] = 2.0f * (xz - wy) * s.x[i];
+				m[3][i] = 0.0f;
+				m[4][i] = 2.0f * (xy - wz) * s.y[i];
+				m[5][i] = (1.0f - 2.0f * (xx + zz)) * s.y[i];
+				m[6][i] = 2.0f * (yz + wx) * s.y[i];
+				m[7][i] = 0.0f;
+				m[8][i] = 2.0f * (xz + wy) * s.z[i];
+				m[9][i] = 2.0f * (yz - wx) * s.z[i];
+				m[10][i] = (1.0f - 2.0f * (xx + yy)) * s.z[i];
+				m[11][i] = 0.0f;
+				m[12][i] = p.x[i];
+				m[13][i] = p.y[i];
+				m[14][i] = p.z[i];
+				m[15][i] = 1.0f;
+			}
+		}
+	}
+
+	static void multiply_scalar(
+	    const glm::mat4& lhs, const mat4x8* rhs, mat4x8* out, u32 block_count)
+	{
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			const auto& b = rhs[block].elements;
+			auto&       m = out[block].elements;
+
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+				{
+					for (u32 i = 0; i < simd::LANES; ++i)
+					{
+						m[column * 4 + row][i] = lhs[0][row] * b[column * 4 + 0][i] +
+						                         lhs[1][row] * b[column * 4 + 1][i] +
+						                         lhs[2][row] * b[column * 4 + 2][i] +
+						                         lhs[3][row] * b[column * 4 + 3][i];
+					}
+				}
+			}
+		}
+	}
+
+#ifdef SIMD_X86
+
+	// SSE4.2, a block is two groups of 4 lanes
+
+	M_TARGET("sse4.2")
+	static void compose_trs_sse(
+	    const vec3x8* positions, const quatx8* rotations, const vec3x8* scales, mat4x8* out,
+	    u32 block_count)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			for (u32 i = 0; i < simd::LANES; i += 4)
+			{
+				const __m128 x = _mm_load_ps(rotations[block].x + i);
+				const __m128 y = _mm_load_ps(rotations[block].y + i);
+				const __m128 z = _mm_load_ps(rotations[block].z + i);
+				const __m128 w = _mm_load_ps(rotations[block].w + i);
+				const __m128 sx = _mm_load_ps(scales[block].x + i);
+				const __m128 sy = _mm_load_ps(scales[block].y + i);
+				const __m128 sz = _mm_load_ps(scales[block].z + i);
+
+				const __m128 xx = _mm_mul_ps(x, x);
+				const __m128 yy = _mm_mul_ps(y, y);
+				const __m128 zz = _mm_mul_ps(z, z);
+				const __m128 xy = _mm_mul_ps(x, y);
+				const __m128 xz = _mm_mul_ps(x, z);
+				const __m128 yz = _mm_mul_ps(y, z);
+				const __m128 wx = _mm_mul_ps(w, x);
+				const __m128 wy = _mm_mul_ps(w, y);
+				const __m128 wz = _mm_mul_ps(w, z);
+
+				auto& m = out[block].elements;
+				// clang-format off
+				_mm_store_ps(m[0] + i,  _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx));
+				_mm_store_ps(m[1] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx));
+				_mm_store_ps(m[2] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx));
+				_mm_store_ps(m[3] + i,  zero);
+				_mm_store_ps(m[4] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy));
+				_mm_store_ps(m[5] + i,  _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy));
+				_mm_store_ps(m[6] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy));
+				_mm_store_ps(m[7] + i,  zero);
+				_mm_store_ps(m[8] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz));
+				_mm_store_ps(m[9] + i,  _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz));
+				_mm_store_ps(m[10] + i, _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz));
+				_mm_store_ps(m[11] + i, zero);
+				_mm_store_ps(m[12] + i, _mm_load_ps(positions[block].x + i));
+				_mm_store_ps(m[13] + i, _mm_load_ps(positions[block].y + i));
+				_mm_store_ps(m[14] + i, _mm_load_ps(positions[block].z + i));
+				_mm_store_ps(m[15] + i, one);
+				// clang-format on
+			}
+		}
+	}
+
+	M_TARGET("sse4.2")
+	static void multiply_sse(const glm::mat4& lhs, const mat4x8* rhs, mat4x8* out, u32 block_count)
+	{
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			const auto& b = rhs[block].elements;
+			auto&       m = out[block].elements;
+
+			for (u32 i = 0; i < simd::LANES; i += 4)
+			{
+				for (u32 column = 0; column < 4; ++column)
+				{
+					const __m128 b0 = _mm_load_ps(b[column * 4 + 0] + i);
+					const __m128 b1 = _mm_load_ps(b[column * 4 + 1] + i);
+					const __m128 b2 = _mm_load_ps(b[column * 4 + 2] + i);
+					const __m128 b3 = _mm_load_ps(b[column * 4 + 3] + i);
+
+					for (u32 row = 0; row < 4; ++row)
+					{
+						__m128 sum = _mm_mul_ps(_mm_set1_ps(lhs[0][row]), b0);
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[1][row]), b1));
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[2][row]), b2));
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(lhs[3][row]), b3));
+						_mm_store_ps(m[column * 4 + row] + i, sum);
+					}
+				}
+			}
+		}
+	}
+
+	// AVX2, a block per instruction
+
+	M_TARGET("avx2,fma")
+	static void compose_trs_avx2(
+	    const vec3x8* positions, const quatx8* rotations, const vec3x8* scales, mat4x8* out,
+	    u32 block_count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 minus_two = _mm256_set1_ps(-2.0f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 zero = _mm256_setzero_ps();
+
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			const __m256 x = _mm256_load_ps(rotations[block].x);
+			const __m256 y = _mm256_load_ps(rotations[block].y);
+			const __m256 z = _mm256_load_ps(rotations[block].z);
+			const __m256 w = _mm256_load_ps(rotations[block].w);
+			const __m256 sx = _mm256_load_ps(scales[block].x);
+			const __m256 sy = _mm256_load_ps(scales[block].y);
+			const __m256 sz = _mm256_load_ps(scales[block].z);
+
+			const __m256 xx = _mm256_mul_ps(x, x);
+			const __m256 yy = _mm256_mul_ps(y, y);
+			const __m256 zz = _mm256_mul_ps(z, z);
+			const __m256 xy = _mm256_mul_ps(x, y);
+			const __m256 xz = _mm256_mul_ps(x, z);
+			const __m256 yz = _mm256_mul_ps(y, z);
+			const __m256 wx = _mm256_mul_ps(w, x);
+			const __m256 wy = _mm256_mul_ps(w, y);
+			const __m256 wz = _mm256_mul_ps(w, z);
+
+			auto& m = out[block].elements;
+			// clang-format off
+			_mm256_store_ps(m[0],  _mm256_mul_ps(_mm256_fmadd_ps(minus_two, _mm256_add_ps(yy, zz), one), sx));
+			_mm256_store_ps(m[1],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx));
+			_mm256_store_ps(m[2],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx));
+			_mm256_store_ps(m[3],  zero);
+			_mm256_store_ps(m[4],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy));
+			_mm256_store_ps(m[5],  _mm256_mul_ps(_mm256_fmadd_ps(minus_two, _mm256_add_ps(xx, zz), one), sy));
+			_mm256_store_ps(m[6],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy));
+			_mm256_store_ps(m[7],  zero);
+			_mm256_store_ps(m[8],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz));
+			_mm256_store_ps(m[9],  _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz));
+			_mm256_store_ps(m[10], _mm256_mul_ps(_mm256_fmadd_ps(minus_two, _mm256_add_ps(xx, yy), one), sz));
+			_mm256_store_ps(m[11], zero);
+			_mm256_store_ps(m[12], _mm256_load_ps(positions[block].x));
+			_mm256_store_ps(m[13], _mm256_load_ps(positions[block].y));
+			_mm256_store_ps(m[14], _mm256_load_ps(positions[block].z));
+			_mm256_store_ps(m[15], one);
+			// clang-format on
+		}
+	}
+
+	M_TARGET("avx2,fma")
+	static void multiply_avx2(const glm::mat4& lhs, const mat4x8* rhs, mat4x8* out, u32 block_count)
+	{
+		for (u32 block = 0; block < block_count; ++block)
+		{
+			const auto& b = rhs[block].elements;
+			auto&       m = out[block].elements;
+
+			for (u32 column = 0; column < 4; ++column)
+			{
+				const __m256 b0 = _mm256_load_ps(b[column * 4 + 0]);
+				const __m256 b1 = _mm256_load_ps(b[column * 4 + 1]);
+				const __m256 b2 = _mm256_load_ps(b[column * 4 + 2]);
+				const __m256 b3 = _mm256_load_ps(b[column * 4 + 3]);
+
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m256 sum = _mm256_mul_ps(_mm256_set1_ps(lhs[0][row]), b0);
+					sum = _mm256_fmadd_ps(_mm256_set1_ps(lhs[1][row]), b1, sum);
+					sum = _mm256_fmadd_ps(_mm256_set1_ps(lhs[2][row]), b2, sum);
+					sum = _mm256_fmadd_ps(_mm256_set1_ps(lhs[3][row]), b3, sum);
+					_mm256_store_ps(m[column * 4 + row], sum);
+				}
+			}
+		}
+	}
+
+	// AVX-512, two blocks per instruction, an odd last block goes through AVX2
+
+#	if defined(__GNUC__) && !defined(__clang__)
+	// GCC's own cast/insert intrinsics leave the upper half undefined on purpose
+#		pragma GCC diagnostic push
+#		pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#	endif
+
+	M_TARGET("avx512f,avx2,fma")
+	static __m512 load_pair(const f32* low, const f32* high)
+	{
+		const __m512d pair = _mm512_insertf64x4(
+		    _mm512_castpd256_pd512(_mm256_castps_pd(_mm256_load_ps(low))),
+		    _mm256_castps_pd(_mm256_load_ps(high)), 1);
+		return _mm512_castpd_ps(pair);
+	}
+
+	M_TARGET("avx512f,avx2,fma")
+	static void store_pair(f32* low, f32* high, __m512 value)
+	{
+		_mm256_store_ps(low, _mm512_castps512_ps256(value));
+		_mm256_store_ps(high, _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(value), 1)));
+	}
+
+	M_TARGET("avx512f,avx2,fma")
+	static void compose_trs_avx512(
+	    const vec3x8* positions, const quatx8* rotations, const vec3x8* scales, mat4x8* out,
+	    u32 block_count)
+	{
+		const __m512 one = _mm512_set1_ps(1.0f);
+		const __m512 minus_two = _mm512_set1_ps(-2.0f);
+		const __m512 two = _mm512_set1_ps(2.0f);
+		const __m512 zero = _mm512_setzero_ps();
+
+		u32 block = 0;
+		for (; block + 1 < block_count; block += 2)
+		{
+			const quatx8& q0 = rotations[block];
+			const quatx8& q1 = rotations[block + 1];
+
+			const __m512 x = load_pair(q0.x, q1.x);
+			const __m512 y = load_pair(q0.y, q1.y);
+			const __m512 z = load_pair(q0.z, q1.z);
+			const __m512 w = load_pair(q0.w, q1.w);
+			const __m512 sx = load_pair(scales[block].x, scales[block + 1].x);
+			const __m512 sy = load_pair(scales[block].y, scales[block + 1].y);
+			const __m512 sz = load_pair(scales[block].z, scales[block + 1].z);
+
+			const __m512 xx = _mm512_mul_ps(x, x);
+			const __m512 yy = _mm512_mul_ps(y, y);
+			const __m512 zz = _mm512_mul_ps(z, z);
+			const __m512 xy = _mm512_mul_ps(x, y);
+			const __m512 xz = _mm512_mul_ps(x, z);
+			const __m512 yz = _mm512_mul_ps(y, z);
+			const __m512 wx = _mm512_mul_ps(w, x);
+			const __m512 wy = _mm512_mul_ps(w, y);
+			const __m512 wz = _mm512_mul_ps(w, z);
+
+			auto& m0 = out[block].elements;
+			auto& m1 = out[block + 1].elements;
+			// clang-format off
+			store_pair(m0[0],  m1[0],  _mm512_mul_ps(_mm512_fmadd_ps(minus_two, _mm512_add_ps(yy, zz), one), sx));
+			store_pair(m0[1],  m1[1],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xy, wz)), sx));
+			store_pair(m0[2],  m1[2],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xz, wy)), sx));
+			store_pair(m0[3],  m1[3],  zero);
+			store_pair(m0[4],  m1[4],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xy, wz)), sy));
+			store_pair(m0[5],  m1[5],  _mm512_mul_ps(_mm512_fmadd_ps(minus_two, _mm512_add_ps(xx, zz), one), sy));
+			store_pair(m0[6],  m1[6],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(yz, wx)), sy));
+			store_pair(m0[7],  m1[7],  zero);
+			store_pair(m0[8],  m1[8],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xz, wy)), sz));
+			store_pair(m0[9],  m1[9],  _mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(yz, wx)), sz));
+			store_pair(m0[10], m1[10], _mm512_mul_ps(_mm512_fmadd_ps(minus_two, _mm512_add_ps(xx, yy), one), sz));
+			store_pair(m0[11], m1[11], zero);
+			store_pair(m0[12], m1[12], load_pair(positions[block].x, positions[block + 1].x));
+			store_pair(m0[13], m1[13], load_pair(positions[block].y, positions[block + 1].y));
+			store_pair(m0[14], m1[14], load_pair(positions[block].z, positions[block + 1].z));
+			store_pair(m0[15], m1[15], one);
+			// clang-format on
+		}
+
+		if (block < block_count)
+		{
+			compose_trs_avx2(positions + block, rotations + block, scales + block, out + block, 1);
+		}
+	}
+
+	M_TARGET("avx512f,avx2,fma")
+	static void multiply_avx512(
+	    const glm::mat4& lhs, const mat4x8* rhs, mat4x8* out, u32 block_count)
+	{
+		u32 block = 0;
+		for (; block + 1 < block_count; block += 2)
+		{
+			const auto& b0 = rhs[block].elements;
+			const auto& b1 = rhs[block + 1].elements;
+			auto&       m0 = out[block].elements;
+			auto&       m1 = out[block + 1].elements;
+
+			for (u32 column = 0; column < 4; ++column)
+			{
+				const __m512 c0 = load_pair(b0[column * 4 + 0], b1[column * 4 + 0]);
+				const __m512 c1 = load_pair(b0[column * 4 + 1], b1[column * 4 + 1]);
+				const __m512 c2 = load_pair(b0[column * 4 + 2], b1[column * 4 + 2]);
+				const __m512 c3 = load_pair(b0[column * 4 + 3], b1[column * 4 + 3]);
+
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m512 sum = _mm512_mul_ps(_mm512_set1_ps(lhs[0][row]), c0);
+					sum = _mm512_fmadd_ps(_mm512_set1_ps(lhs[1][row]), c1, sum);
+					sum = _mm512_fmadd_ps(_mm512_set1_ps(lhs[2][row]), c2, sum);
+					sum = _mm512_fmadd_ps(_mm512_set1_ps(lhs[3][row]), c3, sum);
+					store_pair(m0[column * 4 + row], m1[column * 4 + row], sum);
+				}
+			}
+		}
+
+		if (block < block_count)
+		{
+			multiply_avx2(lhs, rhs + block, out + block, 1);
+		}
+	}
+
+#	if defined(__GNUC__) && !defined(__clang__)
+#		pragma GCC diagnostic pop
+#	endif
+
+	static void cpuid(u32 leaf, u32 subleaf, u32 registers[4])
+	{
+#	ifdef _MSC_VER
+		i32 values[4];
+		__cpuidex(values, static_cast<i32>(leaf), static_cast<i32>(subleaf));
+		for (u32 i = 0; i < 4; ++i)
+		{
+			registers[i] = static_cast<u32>(values[i]);
+		}
+#	else
+		unsigned int a = 0;
+		unsigned int b = 0;
+		unsigned int c = 0;
+		unsigned int d = 0;
+		__cpuid_count(leaf, subleaf, a, b, c, d);
+		registers[0] = a;
+		registers[1] = b;
+		registers[2] = c;
+		registers[3] = d;
+#	endif
+	}
+
+	// the registers the OS saves on context switches
+	static u64 get_xcr0()
+	{
+#	ifdef _MSC_VER
+		return _xgetbv(0);
+#	else
+		u32 low = 0;
+		u32 high = 0;
+		__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+		return (static_cast<u64>(high) << 32) | low;
+#	endif
+	}
+
+#endif  // SIMD_X86
+
+	static simd::Isa detect_isa()
+	{
+#ifdef SIMD_X86
+		u32 registers[4];
+		cpuid(0, 0, registers);
+		const u32 max_leaf = registers[0];
+
+		cpuid(1, 0, registers);
+		const u32 ecx = registers[2];
+
+		const b8 has_sse4_2 = (ecx & (1u << 20)) != 0;
+		const b8 has_os_xsave = (ecx & (1u << 27)) != 0;
+		const b8 has_avx = (ecx & (1u << 28)) != 0;
+		const b8 has_fma = (ecx & (1u << 12)) != 0;
+
+		if (!has_sse4_2)
+		{
+			return simd::Isa::SCALAR;
+		}
+
+		if (!has_os_xsave || !has_avx || max_leaf < 7)
+		{
+			return simd::Isa::SSE4_2;
+		}
+
+		const u64 xcr0 = get_xcr0();
+		const b8  has_ymm_state = (xcr0 & 0x6) == 0x6;
+		const b8  has_zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+		cpuid(7, 0, registers);
+		const u32 ebx = registers[1];
+
+		const b8 has_avx2 = (ebx & (1u << 5)) != 0 && has_fma && has_ymm_state;
+		const b8 has_avx512 = (ebx & (1u << 16)) != 0 && has_avx2 && has_zmm_state;
+
+		if (has_avx512)
+		{
+			return simd::Isa::AVX512;
+		}
+		return has_avx2 ? simd::Isa::AVX2 : simd::Isa::SSE4_2;
+#else
+		return simd::Isa::SCALAR;
+#endif
+	}
+
+	static Kernels get_kernels(simd::Isa isa)
+	{
+		switch (isa)
+		{
+#ifdef SIMD_X86
+		case simd::Isa::AVX512:
+			return { isa, &compose_trs_avx512, &multiply_avx512 };
+		case simd::Isa::AVX2:
+			return { isa, &compose_trs_avx2, &multiply_avx2 };
+		case simd::Isa::SSE4_2:
+			return { isa, &compose_trs_sse, &multiply_sse };
+#endif
+		default:
+			return { simd::Isa::SCALAR, &compose_trs_scalar, &multiply_scalar };
+		}
+	}
+
+	static const simd::Isa g_supported_isa = detect_isa();
+	static Kernels         g_kernels = get_kernels(g_supported_isa);
+}  // namespace
+
+core::simd::Isa core::simd::get_supported_isa()
+{
+	return g_supported_isa;
+}
+
+core::simd::Isa core::simd::get_isa()
+{
+	return g_kernels.isa;
+}
+
+void core::simd::set_isa(Isa isa)
+{
+	if (isa > g_supported_isa)
+	{
+		SPDLOG_WARN(
+		    "{} isn't supported by this CPU, using {}.", get_isa_name(isa),
+		    get_isa_name(g_supported_isa));
+		isa = g_supported_isa;
+	}
+
+	g_kernels = get_kernels(isa);
+}
+
+const char* core::simd::get_isa_name(Isa isa)
+{
+	switch (isa)
+	{
+	case Isa::SCALAR:
+		return "Scalar";
+	case Isa::SSE4_2:
+		return "SSE4.2";
+	case Isa::AVX2:
+		return "AVX2";
+	case Isa::AVX512:
+		return "AVX-512";
+	}
+	return "Unknown";
+}
+
+void core::simd::compose_trs(
+    std::span<const vec3x8> positions, std::span<const quatx8> rotations,
+    std::span<const vec3x8> scales, std::span<mat4x8> out)
+{
+	CHECK_MSG(
+	    positions.size() == out.size() && rotations.size() == out.size() &&
+	        scales.size() == out.size(),
+	    "Batches of different sizes.");
+
+	g_kernels.compose_trs(
+	    positions.data(), rotations.data(), scales.data(), out.data(),
+	    static_cast<u32>(out.size()));
+}
+
+void core::simd::multiply(const glm::mat4& lhs, std::span<const mat4x8> rhs, std::span<mat4x8> out)
+{
+	CHECK_MSG(rhs.size() == out.size(), "Batches of different sizes.");
+
+	g_kernels.multiply(lhs, rhs.data(), out.data(), static_cast<u32>(out.size()));
+}
+
+void core::simd::set_lane(vec3x8* vectors, u32 lane, const glm::vec3& value)
+{
+	vectors->x[lane] = value.x;
+	vectors->y[lane] = value.y;
+	vectors->z[lane] = value.z;
+}
+
+void core::simd::set_lane(quatx8* quaternions, u32 lane, const glm::quat& value)
+{
+	quaternions->x[lane] = value.x;
+	quaternions->y[lane] = value.y;
+	quaternions->z[lane] = value.z;
+	quaternions->w[lane] = value.w;
+}
+
+void core::simd::set_lane(mat4x8* matrices, u32 lane, const glm::mat4& value)
+{
+	for (u32 column = 0; column < 4; ++column)
+	{
+		for (u32 row = 0; row < 4; ++row)
+		{
+			matrices->elements[column * 4 + row][lane] = value[column][row];
+		}
+	}
+}
+
+glm::mat4 core::simd::get_lane(const mat4x8& matrices, u32 lane)
+{
+	glm::mat4 value;
+	for (u32 column = 0; column < 4; ++column)
+	{
+		for (u32 row = 0; row < 4; ++row)
+		{
+			value[column][row] = matrices.elements[column * 4 + row][lane];
+		}
+	}
+	return value;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <span>
+
+/**
+ * Batched transform math on blocks of 8 objects stored as SoA. The kernels run
+ * 4 (SSE4.2), 8 (AVX2) or 16 (AVX-512, two blocks) objects per instruction,
+ * the widest instruction set the CPU supports is selected at startup. The scalar
+ * kernels are the reference and the fallback on other architectures.
+ */
+namespace core::simd
+{
+	static constexpr u32 LANES = 8;
+
+	// ReSharper disable CppInconsistentNaming
+	struct alignas(32) vec3x8
+	{
+		f32 x[LANES];
+		f32 y[LANES];
+		f32 z[LANES];
+	};
+
+	struct alignas(32) quatx8
+	{
+		f32 x[LANES];
+		f32 y[LANES];
+		f32 z[LANES];
+		f32 w[LANES];
+	};
+
+	/** Column-major like glm, `elements[column * 4 + row][lane]`. */
+	struct alignas(32) mat4x8
+	{
+		f32 elements[16][LANES];
+	};
+	// ReSharper restore CppInconsistentNaming
+
+	enum class Isa : u8
+	{
+		SCALAR,
+		SSE4_2,
+		AVX2,
+		AVX512,
+	};
+
+	[[nodiscard]] Isa get_supported_isa();
+
+	[[nodiscard]] Isa get_isa();
+
+	/** Selects the kernels, an instruction set the CPU doesn't support falls back to the best one
+	 *  supported. Not thread safe, meant for startup and benchmarks. */
+	void set_isa(Isa isa);
+
+	[[nodiscard]] const char* get_isa_name(Isa isa);
+
+	/** `translate(position) * mat4_cast(rotation) * scale(scale)` for every lane, all spans have
+	 *  the same number of blocks. */
+	void compose_trs(
+	    std::span<const vec3x8> positions, std::span<const quatx8> rotations,
+	    std::span<const vec3x8> scales, std::span<mat4x8> out);
+
+	/** `lhs * rhs` for every lane, e.g. the view-projection times the model matrices. */
+	void multiply(const glm::mat4& lhs, std::span<const mat4x8> rhs, std::span<mat4x8> out);
+
+	void set_lane(vec3x8* vectors, u32 lane, const glm::vec3& value);
+	void set_lane(quatx8* quaternions, u32 lane, const glm::quat& value);
+	void set_lane(mat4x8* matrices, u32 lane, const glm::mat4& value);
+
+	[[nodiscard]] glm::mat4 get_lane(const mat4x8& matrices, u32 lane);
+}  // namespace core::simd
@@ -0,0 +1,95 @@
+#include "core/task.hpp"
+
+#include <array>
+#include <mutex>
+#include <new>
+
+namespace
+{
+	static constexpr std::size_t SIZE_CLASSES[] = { 128, 256, 512, 1024, 2048, 4096 };
+	static constexpr std::size_t SIZE_CLASS_COUNT = std::size(SIZE_CLASSES);
+	static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	struct SizeClass
+	{
+		std::mutex mutex;
+		FreeBlock* free_list = nullptr;
+	};
+
+	static std::array<SizeClass, SIZE_CLASS_COUNT> g_size_classes;
+
+	static std::size_t find_size_class(std::size_t size)
+	{
+		for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+		{
+			if (size <= SIZE_CLASSES[i])
+			{
+				return i;
+			}
+		}
+		return SIZE_CLASS_COUNT;
+	}
+
+	// carves a new chunk into blocks, the chunks are never released (they are
+	// reused by the pool for the whole lifetime of the program)
+	static FreeBlock* grow(std::size_t block_size)
+	{
+		auto* chunk = static_cast<std::byte*>(::operator new(CHUNK_SIZE));
+
+		FreeBlock* head = nullptr;
+		for (std::size_t offset = 0; offset + block_size <= CHUNK_SIZE; offset += block_size)
+		{
+			auto* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+			block->next = head;
+			head = block;
+		}
+
+		return head;
+	}
+}  // namespace
+
+void* core::coroutine_frame_pool::allocate(std::size_t size)
+{
+	const std::size_t class_index = find_size_class(size);
+
+	if (class_index == SIZE_CLASS_COUNT)
+	{
+		return ::operator new(size);
+	}
+
+	SizeClass&      size_class = g_size_classes[class_index];
+	std::lock_guard lock{ size_class.mutex };
+
+	if (size_class.free_list == nullptr)
+	{
+		size_class.free_list = grow(SIZE_CLASSES[class_index]);
+	}
+
+	FreeBlock* block = size_class.free_list;
+	size_class.free_list = block->next;
+
+	return block;
+}
+
+void core::coroutine_frame_pool::deallocate(void* ptr, std::size_t size) noexcept
+{
+	const std::size_t class_index = find_size_class(size);
+
+	if (class_index == SIZE_CLASS_COUNT)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	SizeClass&      size_class = g_size_classes[class_index];
+	std::lock_guard lock{ size_class.mutex };
+
+	auto* block = static_cast<FreeBlock*>(ptr);
+	block->next = size_class.free_list;
+	size_class.free_list = block;
+}
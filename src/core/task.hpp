@@ -0,0 +1,249 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace core
+{
+	/**
+	 * Fixed size-class pool for coroutine frames. Blocks are carved from big chunks
+	 * and recycled through per-class free lists, so once the pool warmed up starting
+	 * a coroutine does not touch the heap. Frames bigger than the biggest class fall
+	 * back to the global operator new. Thread safe, frames are usually created on
+	 * the main thread and destroyed wherever the coroutine finishes.
+	 */
+	namespace coroutine_frame_pool
+	{
+		[[nodiscard]] void* allocate(std::size_t size);
+		void                deallocate(void* ptr, std::size_t size) noexcept;
+	}  // namespace coroutine_frame_pool
+
+	template<typename T>
+	class Task;
+
+	namespace detail
+	{
+		class TaskPromiseBase
+		{
+			struct FinalAwaiter
+			{
+				b8 await_ready() const noexcept
+				{
+					return false;
+				}
+
+				template<typename TPromise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+				{
+					TaskPromiseBase& promise = handle.promise();
+
+					if (promise.m_continuation)
+					{
+						// symmetric transfer, resumes the awaiter without growing the stack
+						return promise.m_continuation;
+					}
+
+					if (promise.m_detached)
+					{
+						// nobody owns a detached task, it cleans after itself
+						handle.destroy();
+					}
+
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept
+				{
+				}
+			};
+
+		public:
+			static void* operator new(std::size_t size)
+			{
+				return coroutine_frame_pool::allocate(size);
+			}
+
+			static void operator delete(void* ptr, std::size_t size) noexcept
+			{
+				coroutine_frame_pool::deallocate(ptr, size);
+			}
+
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			FinalAwaiter final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void unhandled_exception() const noexcept
+			{
+				// exceptions are not used in the engine
+				std::terminate();
+			}
+
+			void set_continuation(std::coroutine_handle<> continuation)
+			{
+				m_continuation = continuation;
+			}
+
+			void set_detached()
+			{
+				m_detached = true;
+			}
+
+		private:
+			std::coroutine_handle<> m_continuation;
+			b8                      m_detached = false;
+		};
+
+		template<typename T>
+		class TaskPromise final : public TaskPromiseBase
+		{
+		public:
+			Task<T> get_return_object() noexcept;
+
+			template<typename TValue>
+			void return_value(TValue&& value)
+			{
+				m_value.emplace(std::forward<TValue>(value));
+			}
+
+			T take_result()
+			{
+				return std::move(*m_value);
+			}
+
+		private:
+			std::optional<T> m_value;
+		};
+
+		template<>
+		class TaskPromise<void> final : public TaskPromiseBase
+		{
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() const noexcept
+			{
+			}
+
+			void take_result() const noexcept
+			{
+			}
+		};
+	}  // namespace detail
+
+	/**
+	 * Lazy coroutine returning a T. It does not start until awaited (or spawned
+	 * with `spawn`), awaiting it resumes the awaiter once it finishes.
+	 */
+	template<typename T = void>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = detail::TaskPromise<T>;
+		using handle_t = std::coroutine_handle<promise_type>;
+
+		Task() = default;
+
+		explicit Task(handle_t handle) noexcept
+		    : m_handle{ handle }
+		{
+		}
+
+		~Task()
+		{
+			if (m_handle)
+			{
+				m_handle.destroy();
+			}
+		}
+
+		Task(const Task& other) = delete;
+		Task& operator=(const Task& other) = delete;
+
+		Task(Task&& other) noexcept
+		    : m_handle{ std::exchange(other.m_handle, nullptr) }
+		{
+		}
+
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (m_handle)
+				{
+					m_handle.destroy();
+				}
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+			return *this;
+		}
+
+		b8 is_done() const
+		{
+			return !m_handle || m_handle.done();
+		}
+
+		auto operator co_await() && noexcept
+		{
+			struct Awaiter
+			{
+				handle_t handle;
+
+				b8 await_ready() const noexcept
+				{
+					return !handle || handle.done();
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+				{
+					handle.promise().set_continuation(awaiter);
+					return handle;
+				}
+
+				T await_resume()
+				{
+					return handle.promise().take_result();
+				}
+			};
+
+			return Awaiter{ m_handle };
+		}
+
+	private:
+		handle_t m_handle = nullptr;
+
+		friend void spawn(Task<void>&& task);
+	};
+
+	/**
+	 * Starts a task without waiting for it (fire and forget), the coroutine frame
+	 * is released when it completes.
+	 */
+	inline void spawn(Task<void>&& task)
+	{
+		auto handle = std::exchange(task.m_handle, nullptr);
+		handle.promise().set_detached();
+		handle.resume();
+	}
+
+	template<typename T>
+	Task<T> detail::TaskPromise<T>::get_return_object() noexcept
+	{
+		return Task<T>{ std::coroutine_handle<TaskPromise>::from_promise(*this) };
+	}
+
+	inline Task<void> detail::TaskPromise<void>::get_return_object() noexcept
+	{
+		return Task<void>{ std::coroutine_handle<TaskPromise>::from_promise(*this) };
+	}
+}  // namespace core
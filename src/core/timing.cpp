@@ -1,16 +1,136 @@
 #include "timing.hpp"
 
 #include <SDL3/SDL.h>
+#include <imgui/imgui.h>
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
 
 namespace
 {
+	using namespace core;
+
+	struct FrameRecord
+	{
+		u64                                  frame_ns = 0;
+		std::array<u64, timing::PHASE_COUNT> phase_ns{};
+	};
+
+	// a seqlock per slot: odd while written, readers retry or skip torn slots
+	struct Slot
+	{
+		std::atomic<u64> sequence = 0;
+		FrameRecord      record;
+	};
+
+	static_assert((timing::HISTORY_SIZE & (timing::HISTORY_SIZE - 1)) == 0);
+
+	static constexpr std::array<const char*, timing::PHASE_COUNT> PHASE_NAMES = {
+		"Input", "Update", "UI", "Prepare", "Wait", "Pace", "GPU wait", "Render", "Swap",
+	};
+
 	static f32 g_delta_time = 0.0f;
-	static f32 g_last_frame_time = 0.0f;
+	static u64 g_last_frame_ns = 0;
+
+	static std::array<std::atomic<u64>, timing::PHASE_COUNT> g_current_phase_ns{};
+
+	// single writer (the frame start), any number of readers
+	static std::array<Slot, timing::HISTORY_SIZE> g_history;
+	static std::atomic<u64>                       g_frame_count = 0;
+
+	static void publish_frame(const FrameRecord& record)
+	{
+		const u64 frame = g_frame_count.load(std::memory_order_relaxed);
+		Slot&     slot = g_history[frame % timing::HISTORY_SIZE];
+
+		const u64 sequence = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.record = record;
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+
+		g_frame_count.store(frame + 1, std::memory_order_release);
+	}
+
+	static b8 read_frame(u64 frame, FrameRecord* record)
+	{
+		const Slot& slot = g_history[frame % timing::HISTORY_SIZE];
+
+		const u64 sequence = slot.sequence.load(std::memory_order_acquire);
+		if ((sequence & 1) != 0)
+		{
+			return false;
+		}
+
+		*record = slot.record;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	// nearest rank, the values are sorted
+	static timing::Stats compute_series_stats(std::span<u64> values)
+	{
+		timing::Stats stats;
+		if (values.empty())
+		{
+			return stats;
+		}
+
+		std::ranges::sort(values);
+
+		auto to_ms = [](u64 ns)
+		{
+			return static_cast<f64>(ns) / 1e6;
+		};
+
+		auto percentile = [&values, &to_ms](f64 p)
+		{
+			const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<f64>(values.size())));
+			return to_ms(values[std::clamp<std::size_t>(rank, 1, values.size()) - 1]);
+		};
+
+		u64 total = 0;
+		for (const u64 value : values)
+		{
+			total += value;
+		}
+
+		stats.min_ms = to_ms(values.front());
+		stats.average_ms = to_ms(total) / static_cast<f64>(values.size());
+		stats.p50_ms = percentile(0.50);
+		stats.p95_ms = percentile(0.95);
+		stats.p99_ms = percentile(0.99);
+		stats.max_ms = to_ms(values.back());
+		return stats;
+	}
+
+	static void show_stats_row(const char* name, const timing::Stats& stats)
+	{
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(name);
+
+		for (const f64 value : { stats.min_ms, stats.average_ms, stats.p50_ms, stats.p95_ms,
+		                         stats.p99_ms, stats.max_ms })
+		{
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", value);
+		}
+	}
 }  // namespace
 
-f32 core::timing::get_elapsed_seconds()
+u64 core::timing::get_ticks_ns()
 {
-	return (f32)SDL_GetTicks() / 1000.f;
+	return SDL_GetTicksNS();
+}
+
+f64 core::timing::get_elapsed_seconds()
+{
+	return static_cast<f64>(get_ticks_ns()) / 1e9;
 }
 
 f32 core::timing::get_delta_time()
@@ -20,7 +140,131 @@ f32 core::timing::get_delta_time()
 
 void core::timing::update_delta_time()
 {
-	f32 current_frame_time = get_elapsed_seconds();
-	g_delta_time = current_frame_time - g_last_frame_time;
-	g_last_frame_time = current_frame_time;
+	const u64 now_ns = get_ticks_ns();
+
+	if (g_last_frame_ns != 0)
+	{
+		FrameRecord record;
+		record.frame_ns = now_ns - g_last_frame_ns;
+		for (u32 phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			record.phase_ns[phase] = g_current_phase_ns[phase].exchange(0, std::memory_order_relaxed);
+		}
+		publish_frame(record);
+
+		// in double, the difference of two large float values loses the sub-millisecond part
+		g_delta_time = static_cast<f32>(static_cast<f64>(record.frame_ns) / 1e9);
+	}
+
+	g_last_frame_ns = now_ns;
+}
+
+void core::timing::set_delta_time(f32 delta_time)
+{
+	g_delta_time = delta_time;
+}
+
+const char* core::timing::get_phase_name(Phase phase)
+{
+	return phase < Phase::COUNT ? PHASE_NAMES[static_cast<u32>(phase)] : "Unknown";
+}
+
+void core::timing::add_phase_time(Phase phase, u64 duration_ns)
+{
+	g_current_phase_ns[static_cast<u32>(phase)].fetch_add(duration_ns, std::memory_order_relaxed);
+}
+
+core::timing::FrameStats core::timing::compute_stats(u32 window)
+{
+	ZoneScopedN("Compute frame stats");
+
+	// the oldest slot may be overwritten while reading, it is left out
+	const u64 frame_count = g_frame_count.load(std::memory_order_acquire);
+	const u64 count = std::min<u64>({ window, frame_count, HISTORY_SIZE - 1 });
+
+	std::array<u64, HISTORY_SIZE>                          frame_values;
+	std::array<std::array<u64, HISTORY_SIZE>, PHASE_COUNT> phase_values;
+	u32                                                    valid_count = 0;
+
+	for (u64 frame = frame_count - count; frame < frame_count; ++frame)
+	{
+		FrameRecord record;
+		if (!read_frame(frame, &record))
+		{
+			continue;
+		}
+
+		frame_values[valid_count] = record.frame_ns;
+		for (u32 phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			phase_values[phase][valid_count] = record.phase_ns[phase];
+		}
+		++valid_count;
+	}
+
+	FrameStats stats;
+	stats.frame_count = valid_count;
+	stats.frame = compute_series_stats({ frame_values.data(), valid_count });
+	for (u32 phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		stats.phases[phase] = compute_series_stats({ phase_values[phase].data(), valid_count });
+	}
+
+	return stats;
+}
+
+void core::timing::log_stats(u32 window)
+{
+	const FrameStats stats = compute_stats(window);
+
+	SPDLOG_INFO(
+	    "Frame times over {} frames (ms): {:>7} {:>7} {:>7} {:>7} {:>7} {:>7}", stats.frame_count,
+	    "min", "avg", "p50", "p95", "p99", "max");
+
+	auto log_row = [](const char* name, const Stats& row)
+	{
+		SPDLOG_INFO(
+		    "{:>10} {:7.3f} {:7.3f} {:7.3f} {:7.3f} {:7.3f} {:7.3f}", name, row.min_ms,
+		    row.average_ms, row.p50_ms, row.p95_ms, row.p99_ms, row.max_ms);
+	};
+
+	log_row("Frame", stats.frame);
+	for (u32 phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		log_row(get_phase_name(static_cast<Phase>(phase)), stats.phases[phase]);
+	}
+}
+
+void core::timing::prepare_dev_ui()
+{
+	ZoneScopedN("Timing prepare DevUI");
+
+	static constexpr std::array WINDOWS = { 60, 300, 1000 };
+	static i32                  s_window_index = 1;
+
+	if (!ImGui::CollapsingHeader("Frame timing"))
+	{
+		return;
+	}
+
+	ImGui::Combo("Window", &s_window_index, "60 frames\0 300 frames\0 1000 frames\0");
+
+	const FrameStats stats = compute_stats(WINDOWS[s_window_index]);
+
+	if (ImGui::BeginTable("Frame stats", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		for (const char* header : { "ms", "min", "avg", "p50", "p95", "p99", "max" })
+		{
+			ImGui::TableSetupColumn(header);
+		}
+		ImGui::TableHeadersRow();
+
+		show_stats_row("Frame", stats.frame);
+		for (u32 phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			show_stats_row(get_phase_name(static_cast<Phase>(phase)), stats.phases[phase]);
+		}
+
+		ImGui::EndTable();
+	}
 }
@@ -2,9 +2,99 @@
 
 #include "core/types.hpp"
 
+#include <array>
+
 namespace core::timing
 {
-	[[nodiscard]] f32 get_elapsed_seconds();
+	/**
+	 * Parts of a frame, timed separately. GPU_WAIT, RENDER and SWAP run on the render
+	 * thread and overlap the next frame of the main thread, WAIT is the main thread
+	 * blocked on it and PACE the main thread held back by the frame rate limiter.
+	 */
+	enum class Phase : u8
+	{
+		INPUT,
+		UPDATE,
+		UI,
+		PREPARE,
+		WAIT,
+		PACE,
+		GPU_WAIT,
+		RENDER,
+		SWAP,
+		COUNT
+	};
+
+	static constexpr u32 PHASE_COUNT = static_cast<u32>(Phase::COUNT);
+
+	/** Frames kept for the statistics, the largest window. */
+	static constexpr u32 HISTORY_SIZE = 1024;
+
+	struct Stats
+	{
+		f64 min_ms = 0.0;
+		f64 average_ms = 0.0;
+		f64 p50_ms = 0.0;
+		f64 p95_ms = 0.0;
+		f64 p99_ms = 0.0;
+		f64 max_ms = 0.0;
+	};
+
+	struct FrameStats
+	{
+		u32                            frame_count = 0;
+		Stats                          frame;
+		std::array<Stats, PHASE_COUNT> phases;
+	};
+
+	/** Nanoseconds since SDL started. */
+	[[nodiscard]] u64 get_ticks_ns();
+
+	[[nodiscard]] f64 get_elapsed_seconds();
+
+	/** Of the last frame, in seconds. */
 	[[nodiscard]] f32 get_delta_time();
-	void              update_delta_time();
+
+	/** Starts a frame: measures the delta time and publishes the timings of the previous frame. */
+	void update_delta_time();
+
+	/** Replaces the measured delta time of the frame, e.g. with a recorded one. */
+	void set_delta_time(f32 delta_time);
+
+	[[nodiscard]] const char* get_phase_name(Phase phase);
+
+	/** Adds to the time of the phase in the current frame, from any thread. */
+	void add_phase_time(Phase phase, u64 duration_ns);
+
+	/** Times its scope as part of a phase. */
+	class PhaseScope
+	{
+	public:
+		explicit PhaseScope(Phase phase)
+		    : m_phase{ phase }
+		    , m_start_ns{ get_ticks_ns() }
+		{
+		}
+
+		~PhaseScope()
+		{
+			add_phase_time(m_phase, get_ticks_ns() - m_start_ns);
+		}
+
+		PhaseScope(const PhaseScope& other) = delete;
+		PhaseScope& operator=(const PhaseScope& other) = delete;
+		PhaseScope(PhaseScope&& other) noexcept = delete;
+		PhaseScope& operator=(PhaseScope&& other) noexcept = delete;
+
+	private:
+		Phase m_phase;
+		u64   m_start_ns;
+	};
+
+	/** Over the last `window` frames at most (up to HISTORY_SIZE - 1), readable from any thread. */
+	[[nodiscard]] FrameStats compute_stats(u32 window);
+
+	void log_stats(u32 window);
+
+	void prepare_dev_ui();
 }  // namespace core::timing
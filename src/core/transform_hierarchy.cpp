@@ -0,0 +1,459 @@
+#include "core/transform_hierarchy.hpp"
+
+#include "core/jobs.hpp"
+#include "utils/assertions.hpp"
+
+#include <spdlog/spdlog.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	using namespace core;
+
+	// below this a level is updated on the calling thread
+	static constexpr u32 MIN_NODES_PER_JOB = 1024;
+
+	template<typename T>
+	static void apply_order(std::vector<T>* values, const std::vector<u32>& order)
+	{
+		std::vector<T> ordered;
+		ordered.reserve(values->capacity());
+		for (const u32 index : order)
+		{
+			ordered.push_back((*values)[index]);
+		}
+		values->swap(ordered);
+	}
+}  // namespace
+
+glm::mat4 core::compute_local_matrix(const Transform& transform)
+{
+	// translate * rotate * scale without the two matrix products
+	glm::mat4 local = glm::mat4_cast(transform.rotation);
+	local[0] *= transform.scale.x;
+	local[1] *= transform.scale.y;
+	local[2] *= transform.scale.z;
+	local[3] = glm::vec4{ transform.position, 1.0f };
+	return local;
+}
+
+core::TransformHierarchy::TransformHierarchy(u32 capacity)
+    : m_capacity{ capacity }
+{
+	m_locals.reserve(capacity);
+	m_worlds.reserve(capacity);
+	m_previous_worlds.reserve(capacity);
+	m_parents.reserve(capacity);
+	m_depths.reserve(capacity);
+	m_slot_of_node.reserve(capacity);
+	m_dirty_flags.reserve(capacity);
+	m_has_changed.reserve(capacity);
+	m_slots.reserve(capacity);
+}
+
+core::Handle<core::Transform> core::TransformHierarchy::create(
+    const Transform& local, Handle<Transform> parent)
+{
+	u32 parent_node = NO_PARENT;
+	u32 depth = 0;
+
+	if (!parent.is_null())
+	{
+		parent_node = get_node(parent);
+		if (parent_node == NO_PARENT)
+		{
+			SPDLOG_ERROR("Creating a transform with an invalid parent.");
+			return {};
+		}
+
+		depth = compute_depth(parent_node) + 1;
+		if (depth >= MAX_DEPTH)
+		{
+			SPDLOG_ERROR("Transform hierarchy deeper than {} levels.", MAX_DEPTH);
+			return {};
+		}
+	}
+
+	u32 slot_index = m_first_free;
+	if (slot_index != NO_PARENT)
+	{
+		m_first_free = m_slots[slot_index].node_or_next_free;
+	}
+	else if (m_slots.size() < m_capacity)
+	{
+		slot_index = static_cast<u32>(m_slots.size());
+		m_slots.emplace_back();
+	}
+	else
+	{
+		SPDLOG_ERROR("Transform hierarchy full ({} nodes).", m_capacity);
+		return {};
+	}
+
+	const auto node = static_cast<u32>(m_locals.size());
+	Slot&      slot = m_slots[slot_index];
+	slot.node_or_next_free = node;
+	slot.is_alive = true;
+
+	m_locals.push_back(local);
+	m_worlds.emplace_back(1.0f);
+	m_previous_worlds.emplace_back(1.0f);
+	m_parents.push_back(parent_node);
+	m_depths.push_back(depth);
+	m_slot_of_node.push_back(slot_index);
+	m_dirty_flags.push_back(DIRTY_LOCAL | DIRTY_CREATED);
+	m_has_changed.push_back(0);
+
+	// appending to the deepest level (or a new one below it) keeps the order
+	if (!m_needs_sort && depth + 1 >= m_level_count)
+	{
+		if (depth == m_level_count)
+		{
+			++m_level_count;
+		}
+		m_level_starts[m_level_count] = node + 1;
+	}
+	else
+	{
+		m_needs_sort = true;
+	}
+
+	m_is_level_dirty[depth].store(true, std::memory_order_relaxed);
+
+	return { slot_index, slot.generation };
+}
+
+void core::TransformHierarchy::destroy(Handle<Transform> handle)
+{
+	if (!is_valid(handle))
+	{
+		return;
+	}
+
+	// descendants come after their ancestors once sorted
+	if (m_needs_sort)
+	{
+		sort_by_depth();
+	}
+
+	const u32 first = get_node(handle);
+
+	std::vector<u8> is_removed(m_locals.size(), 0);
+	is_removed[first] = 1;
+	for (u32 node = first + 1; node < m_locals.size(); ++node)
+	{
+		const u32 parent = m_parents[node];
+		is_removed[node] = parent != NO_PARENT && is_removed[parent];
+	}
+
+	std::vector<u32> order;
+	order.reserve(m_locals.size());
+	for (u32 node = 0; node < m_locals.size(); ++node)
+	{
+		if (is_removed[node])
+		{
+			Slot& slot = m_slots[m_slot_of_node[node]];
+			++slot.generation;
+			slot.is_alive = false;
+			slot.node_or_next_free = m_first_free;
+			m_first_free = m_slot_of_node[node];
+		}
+		else
+		{
+			order.push_back(node);
+		}
+	}
+
+	reorder(order);
+}
+
+void core::TransformHierarchy::set_parent(Handle<Transform> handle, Handle<Transform> parent)
+{
+	const u32 node = get_node(handle);
+	if (node == NO_PARENT)
+	{
+		SPDLOG_ERROR("Setting the parent of an invalid transform.");
+		return;
+	}
+
+	u32 parent_node = NO_PARENT;
+	if (!parent.is_null())
+	{
+		parent_node = get_node(parent);
+		if (parent_node == NO_PARENT)
+		{
+			SPDLOG_ERROR("Setting an invalid transform as parent.");
+			return;
+		}
+
+		for (u32 ancestor = parent_node; ancestor != NO_PARENT; ancestor = m_parents[ancestor])
+		{
+			if (ancestor == node)
+			{
+				SPDLOG_ERROR("A transform can't be parented to one of its descendants.");
+				return;
+			}
+		}
+
+		// the whole subtree moves down with the node
+		if (compute_depth(parent_node) + 1 + compute_subtree_height(node) >= MAX_DEPTH)
+		{
+			SPDLOG_ERROR("Transform hierarchy deeper than {} levels.", MAX_DEPTH);
+			return;
+		}
+	}
+
+	m_parents[node] = parent_node;
+	m_dirty_flags[node] |= DIRTY_LOCAL;
+	m_needs_sort = true;
+}
+
+void core::TransformHierarchy::set_local(Handle<Transform> handle, const Transform& local)
+{
+	const u32 node = get_node(handle);
+	if (node == NO_PARENT)
+	{
+		return;
+	}
+
+	m_locals[node] = local;
+	m_dirty_flags[node] |= DIRTY_LOCAL;
+	m_is_level_dirty[m_depths[node]].store(true, std::memory_order_relaxed);
+}
+
+const core::Transform* core::TransformHierarchy::get_local(Handle<Transform> handle) const
+{
+	const u32 node = get_node(handle);
+	return node != NO_PARENT ? &m_locals[node] : nullptr;
+}
+
+const glm::mat4* core::TransformHierarchy::get_world_matrix(Handle<Transform> handle) const
+{
+	const u32 node = get_node(handle);
+	return node != NO_PARENT ? &m_worlds[node] : nullptr;
+}
+
+b8 core::TransformHierarchy::get_interpolated_world_matrix(
+    Handle<Transform> handle, f32 interpolation, glm::mat4* world) const
+{
+	const u32 node = get_node(handle);
+	if (node == NO_PARENT)
+	{
+		return false;
+	}
+
+	const glm::mat4& previous = m_previous_worlds[node];
+	const glm::mat4& current = m_worlds[node];
+	for (i32 column = 0; column < 4; ++column)
+	{
+		(*world)[column] = glm::mix(previous[column], current[column], interpolation);
+	}
+	return true;
+}
+
+b8 core::TransformHierarchy::is_valid(Handle<Transform> handle) const
+{
+	return get_node(handle) != NO_PARENT;
+}
+
+void core::TransformHierarchy::update()
+{
+	ZoneScopedN("Update transforms");
+
+	if (m_needs_sort)
+	{
+		sort_by_depth();
+	}
+
+	u32 update_count = 0;
+	b8  is_parent_level_changed = false;
+
+	// the parents are final before their level is read, levels are processed in order
+	for (u32 level = 0; level < m_level_count; ++level)
+	{
+		const b8 is_level_dirty = m_is_level_dirty[level].exchange(false, std::memory_order_relaxed);
+		if (!is_level_dirty && !is_parent_level_changed && !m_was_level_changed[level])
+		{
+			continue;
+		}
+
+		const u32 level_update_count =
+		    update_level(m_level_starts[level], m_level_starts[level + 1], is_parent_level_changed);
+
+		is_parent_level_changed = level_update_count != 0;
+		m_was_level_changed[level] = level_update_count != 0;
+		update_count += level_update_count;
+	}
+
+	m_last_update_count = update_count;
+}
+
+u32 core::TransformHierarchy::get_node(Handle<Transform> handle) const
+{
+	if (handle.index >= m_slots.size())
+	{
+		return NO_PARENT;
+	}
+
+	const Slot& slot = m_slots[handle.index];
+	return slot.is_alive && slot.generation == handle.generation ? slot.node_or_next_free
+	                                                              : NO_PARENT;
+}
+
+u32 core::TransformHierarchy::compute_depth(u32 node) const
+{
+	u32 depth = 0;
+	for (u32 parent = m_parents[node]; parent != NO_PARENT; parent = m_parents[parent])
+	{
+		++depth;
+	}
+	return depth;
+}
+
+u32 core::TransformHierarchy::compute_subtree_height(u32 node) const
+{
+	u32 height = 0;
+	for (u32 descendant = 0; descendant < m_parents.size(); ++descendant)
+	{
+		u32 distance = 0;
+		for (u32 ancestor = descendant; ancestor != NO_PARENT; ancestor = m_parents[ancestor])
+		{
+			if (ancestor == node)
+			{
+				height = std::max(height, distance);
+				break;
+			}
+			++distance;
+		}
+	}
+	return height;
+}
+
+void core::TransformHierarchy::sort_by_depth()
+{
+	ZoneScopedN("Sort transforms");
+
+	const auto node_count = static_cast<u32>(m_locals.size());
+
+	// reparenting invalidates the depths of whole subtrees, the chains are short
+	std::array<u32, MAX_DEPTH + 1> level_sizes{};
+	for (u32 node = 0; node < node_count; ++node)
+	{
+		const u32 depth = compute_depth(node);
+		CHECK_MSG(depth < MAX_DEPTH, "Transform hierarchy too deep.");
+		m_depths[node] = depth;
+		++level_sizes[depth];
+	}
+
+	// stable counting sort, siblings keep their relative order
+	std::array<u32, MAX_DEPTH + 1> level_ends{};
+	u32                            offset = 0;
+	for (u32 level = 0; level < MAX_DEPTH; ++level)
+	{
+		level_ends[level] = offset;
+		offset += level_sizes[level];
+	}
+
+	std::vector<u32> order(node_count);
+	for (u32 node = 0; node < node_count; ++node)
+	{
+		order[level_ends[m_depths[node]]++] = node;
+	}
+
+	reorder(order);
+
+	// depths changed, every level gets checked once
+	for (u32 level = 0; level < m_level_count; ++level)
+	{
+		m_is_level_dirty[level].store(true, std::memory_order_relaxed);
+	}
+}
+
+void core::TransformHierarchy::reorder(const std::vector<u32>& order)
+{
+	std::vector<u32> new_index(m_locals.size(), NO_PARENT);
+	for (u32 i = 0; i < order.size(); ++i)
+	{
+		new_index[order[i]] = i;
+	}
+
+	apply_order(&m_locals, order);
+	apply_order(&m_worlds, order);
+	apply_order(&m_previous_worlds, order);
+	apply_order(&m_parents, order);
+	apply_order(&m_depths, order);
+	apply_order(&m_slot_of_node, order);
+	apply_order(&m_dirty_flags, order);
+	apply_order(&m_has_changed, order);
+
+	// the levels moved, every one is refreshed once
+	m_level_count = 0;
+	m_level_starts.fill(0);
+	m_was_level_changed.fill(true);
+
+	for (u32 node = 0; node < order.size(); ++node)
+	{
+		if (m_parents[node] != NO_PARENT)
+		{
+			m_parents[node] = new_index[m_parents[node]];
+		}
+
+		m_slots[m_slot_of_node[node]].node_or_next_free = node;
+
+		const u32 depth = m_depths[node];
+		if (depth == m_level_count)
+		{
+			m_level_starts[m_level_count++] = node;
+		}
+		m_level_starts[m_level_count] = node + 1;
+	}
+
+	m_needs_sort = false;
+}
+
+u32 core::TransformHierarchy::update_level(u32 begin, u32 end, b8 is_parent_level_changed)
+{
+	ZoneScopedN("Update transform level");
+
+	std::atomic<u32> update_count = 0;
+
+	jobs::parallel_for(
+	    end - begin,
+	    [this, begin, is_parent_level_changed, &update_count](u32 chunk_begin, u32 chunk_end)
+	    {
+		    u32 count = 0;
+
+		    for (u32 node = begin + chunk_begin; node < begin + chunk_end; ++node)
+		    {
+			    // the flags of a skipped level are stale, only read after an update
+			    const u32 parent = m_parents[node];
+			    const b8  is_parent_changed = is_parent_level_changed && m_has_changed[parent];
+
+			    // a node that stopped moving blends between two equal matrices from now on
+			    m_previous_worlds[node] = m_worlds[node];
+
+			    if (m_dirty_flags[node] == 0 && !is_parent_changed)
+			    {
+				    m_has_changed[node] = 0;
+				    continue;
+			    }
+
+			    const glm::mat4 local = compute_local_matrix(m_locals[node]);
+			    m_worlds[node] = parent == NO_PARENT ? local : m_worlds[parent] * local;
+			    if ((m_dirty_flags[node] & DIRTY_CREATED) != 0)
+			    {
+				    m_previous_worlds[node] = m_worlds[node];
+			    }
+			    m_dirty_flags[node] = 0;
+			    m_has_changed[node] = 1;
+			    ++count;
+		    }
+
+		    update_count.fetch_add(count, std::memory_order_relaxed);
+	    },
+	    MIN_NODES_PER_JOB);
+
+	return update_count.load(std::memory_order_relaxed);
+}
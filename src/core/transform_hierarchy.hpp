@@ -0,0 +1,148 @@
+#pragma once
+
+#include "core/handle_pool.hpp"
+#include "core/types.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace core
+{
+	/** Local translation, rotation and scale, relative to the parent. */
+	struct Transform
+	{
+		glm::vec3 position{ 0.0f };
+		glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+		glm::vec3 scale{ 1.0f };
+	};
+
+	[[nodiscard]] glm::mat4 compute_local_matrix(const Transform& transform);
+
+	/**
+	 * Parent/child transforms stored in SoA arrays sorted by depth: every parent
+	 * comes before its children and each level is a contiguous range. `update`
+	 * walks the levels in order and recomputes the world matrices of the dirty
+	 * nodes and of the children of changed nodes only, a level without any change
+	 * is skipped entirely (static objects cost nothing). Large levels are split
+	 * over the job system.
+	 *
+	 * `set_local` may be called concurrently for different nodes, structural
+	 * changes (create, destroy, set_parent) must not overlap with anything else and
+	 * re-sort the nodes on the next update.
+	 *
+	 * The world matrices of the update before are kept for rendering in between
+	 * two fixed simulation ticks.
+	 */
+	class TransformHierarchy
+	{
+	public:
+		static constexpr u32 MAX_DEPTH = 32;
+
+		explicit TransformHierarchy(u32 capacity);
+
+		TransformHierarchy(const TransformHierarchy& other) = delete;
+		TransformHierarchy& operator=(const TransformHierarchy& other) = delete;
+		TransformHierarchy(TransformHierarchy&& other) noexcept = delete;
+		TransformHierarchy& operator=(TransformHierarchy&& other) noexcept = delete;
+
+		/** A null parent makes a root node. */
+		[[nodiscard]] Handle<Transform> create(
+		    const Transform& local, Handle<Transform> parent = {});
+
+		/** The children are destroyed with their parent. */
+		void destroy(Handle<Transform> handle);
+
+		void set_parent(Handle<Transform> handle, Handle<Transform> parent);
+
+		void set_local(Handle<Transform> handle, const Transform& local);
+
+		[[nodiscard]] const Transform* get_local(Handle<Transform> handle) const;
+
+		/** As computed by the last update. */
+		[[nodiscard]] const glm::mat4* get_world_matrix(Handle<Transform> handle) const;
+
+		/**
+		 * Blends the world matrices of the last two updates, 0 is the previous one. The
+		 * matrices are blended per element: over the rotation of a tick this stays close to
+		 * the slerp result and costs a fraction of decomposing them. False if invalid.
+		 */
+		b8 get_interpolated_world_matrix(
+		    Handle<Transform> handle, f32 interpolation, glm::mat4* world) const;
+
+		[[nodiscard]] b8 is_valid(Handle<Transform> handle) const;
+
+		void update();
+
+		[[nodiscard]] u32 get_node_count() const
+		{
+			return static_cast<u32>(m_locals.size());
+		}
+
+		/** World matrices recomputed by the last update. */
+		[[nodiscard]] u32 get_last_update_count() const
+		{
+			return m_last_update_count;
+		}
+
+	private:
+		static constexpr u32 NO_PARENT = Handle<Transform>::INVALID_INDEX;
+
+		enum DirtyFlags : u8
+		{
+			DIRTY_LOCAL = 1 << 0,
+			// created since the last update, no previous world matrix to blend from
+			DIRTY_CREATED = 1 << 1,
+		};
+
+		struct Slot
+		{
+			u32 node_or_next_free = NO_PARENT;
+			u32 generation = 0;
+			b8  is_alive = false;
+		};
+
+		[[nodiscard]] u32 get_node(Handle<Transform> handle) const;
+
+		/** From the parent links, m_depths is stale after a reparenting until the next sort. */
+		[[nodiscard]] u32 compute_depth(u32 node) const;
+
+		/** Levels under `node`, 0 for a leaf. Walks every node, for structural changes only. */
+		[[nodiscard]] u32 compute_subtree_height(u32 node) const;
+
+		/** Recomputes the depths and restores the level order. */
+		void sort_by_depth();
+
+		/** Keeps the nodes of `order` (old indices) in that order, the others are freed. */
+		void reorder(const std::vector<u32>& order);
+
+		/** Returns the number of world matrices recomputed. */
+		u32 update_level(u32 begin, u32 end, b8 is_parent_level_changed);
+
+		// SoA, indexed by node (dense, depth sorted)
+		std::vector<Transform> m_locals;
+		std::vector<glm::mat4> m_worlds;
+		std::vector<glm::mat4> m_previous_worlds;
+		std::vector<u32>       m_parents;
+		std::vector<u32>       m_depths;
+		std::vector<u32>       m_slot_of_node;
+		std::vector<u8>        m_dirty_flags;
+		std::vector<u8>        m_has_changed;  // world matrix changed during the last update
+
+		std::vector<Slot> m_slots;
+		u32               m_first_free = NO_PARENT;
+		u32               m_capacity;
+
+		// level L is [m_level_starts[L], m_level_starts[L + 1]), valid when sorted
+		std::array<u32, MAX_DEPTH + 1>         m_level_starts{};
+		std::array<std::atomic<b8>, MAX_DEPTH> m_is_level_dirty{};
+		// the previous matrices of a level changed by the last update are refreshed once more
+		std::array<b8, MAX_DEPTH>              m_was_level_changed{};
+		u32                                    m_level_count = 0;
+		b8                                     m_needs_sort = false;
+		u32                                    m_last_update_count = 0;
+	};
+}  // namespace core
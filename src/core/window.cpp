@@ -1,6 +1,7 @@
 #include "core/window.h"
 
 #include "core/event_handler.hpp"
+#include "core/gl_calls.hpp"
 #include "dev_ui/dev_ui.hpp"
 #include "utils/assertions.hpp"
 
@@ -88,6 +89,7 @@ core::Window core::Window::initialize_with_context(const Config& config)
 	}
 
 	M_UNUSED const i32 glad_loaded_version = gladLoadGL(SDL_GL_GetProcAddress);
+	gl_calls::install();
 	SPDLOG_INFO(
 	    "Glad: Loaded OpenGL {}.{} Core Profile", GLAD_VERSION_MAJOR(glad_loaded_version),
 	    GLAD_VERSION_MINOR(glad_loaded_version));
@@ -126,11 +128,6 @@ void core::Window::gl_swap() const
 	SDL_GL_SwapWindow(m_window.get());
 }
 
-void core::Window::on_window_resizing(const i32 new_size_x, const i32 new_size_y)
-{
-	glViewport(0, 0, new_size_x, new_size_y);
-}
-
 void core::Window::on_window_quit_event()
 {
 	m_should_close = true;
@@ -147,7 +144,7 @@ void core::Window::handle_input(const EventHandler& event_handler)
 		SDL_SetWindowRelativeMouseMode(m_window.get(), true);
 	}
 
-	if (event_handler.is_key_pressed(SDLK_ESCAPE))
+	if (event_handler.is_action_down(input::Action::QUIT))
 	{
 		m_should_close = true;
 	}
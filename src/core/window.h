@@ -46,7 +46,6 @@ namespace core
 		};
 
 		static Window initialize_with_context(const Config& config);
-		static void   on_window_resizing(i32 new_size_x, i32 new_size_y);
 		b8            should_stay_open() const;
 		void          gl_swap() const;
 		void          on_window_quit_event();
@@ -7,6 +7,8 @@
 #include <imgui/backend/imgui_impl_sdl3.h>
 #include <tracy/Tracy.hpp>
 
+#include <cstring>
+
 static constexpr auto YELLOW = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
 
 #define CREATE_SHORTCUT(name, description) \
@@ -23,6 +25,8 @@ void dev_ui::init_for_window(SDL_Window* sdl_window, SDL_GLContext sdl_context)
 	// second parameter is not used
 	ImGui_ImplSDL3_InitForOpenGL(sdl_window, sdl_context);
 	ImGui_ImplOpenGL3_Init();
+	// created lazily by the first new frame otherwise, on a thread without the context
+	ImGui_ImplOpenGL3_CreateDeviceObjects();
 
 	ImGuiIO& io = ImGui::GetIO();
 
@@ -42,11 +46,99 @@ void dev_ui::create_frame()
 	ImGui::DockSpaceOverViewport(0, nullptr, ImGuiDockNodeFlags_PassthruCentralNode);
 }
 
-void dev_ui::render_frame()
+void dev_ui::end_frame()
 {
-	ZoneScopedN("DevUI render");
+	ZoneScopedN("DevUI end");
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
+bool dev_ui::has_texture_requests()
+{
+	for (const ImTextureData* texture : ImGui::GetPlatformIO().Textures)
+	{
+		if (texture->Status != ImTextureStatus_OK)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void dev_ui::update_textures()
+{
+	ZoneScopedN("DevUI textures");
+
+	for (ImTextureData* texture : ImGui::GetPlatformIO().Textures)
+	{
+		if (texture->Status != ImTextureStatus_OK)
+		{
+			ImGui_ImplOpenGL3_UpdateTexture(texture);
+		}
+	}
+}
+
+void dev_ui::render_draw_data(DrawDataSnapshot* snapshot)
+{
+	ZoneScopedN("DevUI render");
+	ImGui_ImplOpenGL3_RenderDrawData(snapshot->get_draw_data());
+}
+
+dev_ui::DrawDataSnapshot::~DrawDataSnapshot()
+{
+	for (ImDrawList* draw_list : m_draw_lists)
+	{
+		IM_DELETE(draw_list);
+	}
+}
+
+void dev_ui::DrawDataSnapshot::copy(const ImDrawData& draw_data)
+{
+	ZoneScopedN("DevUI copy draw data");
+
+	// ImVector's assignment frees and reallocates, resize keeps the capacity
+	auto copy_buffer = []<typename T>(ImVector<T>* destination, const ImVector<T>& source)
+	{
+		destination->resize(source.Size);
+		if (source.Size > 0)
+		{
+			std::memcpy(destination->Data, source.Data, source.size_in_bytes());
+		}
+	};
+
+	while (m_draw_lists.Size < draw_data.CmdListsCount)
+	{
+		m_draw_lists.push_back(IM_NEW(ImDrawList)(nullptr));
+	}
+
+	m_draw_data.Clear();
+	m_draw_data.Valid = draw_data.Valid;
+	m_draw_data.TotalIdxCount = draw_data.TotalIdxCount;
+	m_draw_data.TotalVtxCount = draw_data.TotalVtxCount;
+	m_draw_data.DisplayPos = draw_data.DisplayPos;
+	m_draw_data.DisplaySize = draw_data.DisplaySize;
+	m_draw_data.FramebufferScale = draw_data.FramebufferScale;
+	// the texture requests belong to the UI thread, see update_textures
+	m_draw_data.Textures = nullptr;
+
+	for (int i = 0; i < draw_data.CmdListsCount; ++i)
+	{
+		const ImDrawList* source = draw_data.CmdLists[i];
+		ImDrawList*       destination = m_draw_lists[i];
+
+		copy_buffer(&destination->CmdBuffer, source->CmdBuffer);
+		copy_buffer(&destination->IdxBuffer, source->IdxBuffer);
+		copy_buffer(&destination->VtxBuffer, source->VtxBuffer);
+		destination->Flags = source->Flags;
+
+		// the atlas texture data can be replaced while the snapshot waits, keep the GL id
+		for (ImDrawCmd& command : destination->CmdBuffer)
+		{
+			command.TexRef = ImTextureRef{ command.GetTexID() };
+		}
+
+		m_draw_data.CmdLists.push_back(destination);
+		++m_draw_data.CmdListsCount;
+	}
 }
 
 void dev_ui::shutdown()
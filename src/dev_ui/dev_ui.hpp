@@ -1,5 +1,7 @@
 #pragma once
 
+#include <imgui/imgui.h>
+
 // ReSharper disable CppInconsistentNaming
 union SDL_Event;
 struct SDL_Window;
@@ -9,9 +11,49 @@ struct SDL_GLContextState;
 namespace dev_ui
 {
 
+	/**
+	 * Copy of the draw data of a frame, rendered on the GL thread while the next frame
+	 * is built. The draw lists are kept and their buffers reused from frame to frame.
+	 */
+	class DrawDataSnapshot
+	{
+	public:
+		DrawDataSnapshot() = default;
+		~DrawDataSnapshot();
+
+		DrawDataSnapshot(const DrawDataSnapshot& other) = delete;
+		DrawDataSnapshot& operator=(const DrawDataSnapshot& other) = delete;
+		DrawDataSnapshot(DrawDataSnapshot&& other) noexcept = delete;
+		DrawDataSnapshot& operator=(DrawDataSnapshot&& other) noexcept = delete;
+
+		/** The texture requests must have been handled, the snapshot keeps texture ids only. */
+		void copy(const ImDrawData& draw_data);
+
+		[[nodiscard]] ImDrawData* get_draw_data()
+		{
+			return &m_draw_data;
+		}
+
+	private:
+		ImDrawData             m_draw_data;
+		ImVector<ImDrawList*> m_draw_lists;
+	};
+
+	/** Also creates the device objects, requires the OpenGL context to be current. */
 	void init_for_window(SDL_Window* sdl_window, SDL_GLContextState* sdl_context);
 	void create_frame();
-	void render_frame();
+
+	/** Finalizes the frame, its draw data is then ready to be copied. */
+	void end_frame();
+
+	/** Font atlas creations and updates are done on the GL thread while the UI waits. */
+	[[nodiscard]] bool has_texture_requests();
+	void               update_textures();
+
+	/** GL thread. */
+	void render_draw_data(DrawDataSnapshot* snapshot);
+
+	/** Requires the OpenGL context to be current. */
 	void shutdown();
 	void process_input(const SDL_Event& event);
 	void prepare_shortcuts_ui();
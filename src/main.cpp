@@ -1,11 +1,20 @@
+#include "core/async.hpp"
 #include "core/camera.hpp"
+#include "core/ecs.hpp"
 #include "core/event_handler.hpp"
 #include "core/filesystem.hpp"
+#include "core/fixed_timestep.hpp"
+#include "core/frame_pacing.hpp"
+#include "core/gl_calls.hpp"
+#include "core/input_log.hpp"
+#include "core/jobs.hpp"
+#include "core/memory.hpp"
+#include "core/render_thread.hpp"
 #include "core/renderer.hpp"
+#include "core/scene.hpp"
 #include "core/timing.hpp"
 #include "core/window.h"
 #include "dev_ui/dev_ui.hpp"
-#include "utils/helper_macros.hpp"
 
 #include <SDL3/SDL.h>
 #include <glad/gl.h>
@@ -13,9 +22,46 @@
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyOpenGL.hpp>
 
+#include <cstring>
+#include <optional>
+
 using namespace core;
 
-i32 main(M_UNUSED i32 argc, M_UNUSED char** argv)
+namespace
+{
+	struct CommandLine
+	{
+		const char* record_path = nullptr;  // --record <file>
+		const char* replay_path = nullptr;  // --replay <file>
+	};
+
+	static CommandLine parse_command_line(i32 argc, char** argv)
+	{
+		CommandLine command_line;
+
+		for (i32 i = 1; i < argc; ++i)
+		{
+			const b8 has_value = i + 1 < argc;
+
+			if (std::strcmp(argv[i], "--record") == 0 && has_value)
+			{
+				command_line.record_path = argv[++i];
+			}
+			else if (std::strcmp(argv[i], "--replay") == 0 && has_value)
+			{
+				command_line.replay_path = argv[++i];
+			}
+			else
+			{
+				SPDLOG_WARN("Unknown argument '{}'.", argv[i]);
+			}
+		}
+
+		return command_line;
+	}
+}  // namespace
+
+i32 main(i32 argc, char** argv)
 {
 	TracyNoop;
 
@@ -26,6 +72,8 @@ i32 main(M_UNUSED i32 argc, M_UNUSED char** argv)
 #endif
 
 	fs::create(argv);
+	memory::init({});
+	jobs::init({});
 
 	Window window = Window::initialize_with_context(
 	    {
@@ -39,14 +87,19 @@ i32 main(M_UNUSED i32 argc, M_UNUSED char** argv)
 
 	Camera camera{ { 0.0f, 0.0f, 3.0f } };
 
+	scene::Scene scene;
+	scene::register_systems(&scene);
+
+	FixedTimestep fixed_timestep{ {} };
+	FramePacer    frame_pacer{ {} };
+
 	// requires an initialized OpenGL context
-	Renderer renderer{ window, camera };
+	Renderer renderer{ window, camera, scene };
 	renderer.setup_rendering();
 
 	auto resizing_callback = [&renderer](i32 new_x, i32 new_y)
 	{
-		Window::on_window_resizing(new_x, new_y);
-		renderer.reset();
+		renderer.on_window_resized(new_x, new_y);
 	};
 
 	auto quit_callback = [&window]()
@@ -56,6 +109,24 @@ i32 main(M_UNUSED i32 argc, M_UNUSED char** argv)
 
 	EventHandler event_handler{ { .windows_resizing_callback = resizing_callback,
 		                          .windows_quit_callback = quit_callback } };
+	input::bind_default_actions(&event_handler.get_action_map());
+
+	// a replay can be recorded again, e.g. to convert it to a newer log version
+	const CommandLine                   command_line = parse_command_line(argc, argv);
+	std::optional<input::InputPlayer>   input_player;
+	std::optional<input::InputRecorder> input_recorder;
+
+	if (command_line.replay_path != nullptr &&
+	    input_player.emplace(command_line.replay_path).is_open())
+	{
+		event_handler.set_player(&*input_player);
+	}
+
+	if (command_line.record_path != nullptr &&
+	    input_recorder.emplace(command_line.record_path).is_open())
+	{
+		event_handler.set_recorder(&*input_recorder);
+	}
 
 	event_handler.register_keyboard_input_handler([&renderer, &window, &camera](EventHandler& handler)
 	{
@@ -79,30 +150,114 @@ i32 main(M_UNUSED i32 argc, M_UNUSED char** argv)
 		camera.on_mouse_wheel_scroll(mouse_wheel_direction);
 	});
 
+	// the GL context moves to the render thread, everything above ran with it current
+	RenderThread render_thread{ window, renderer, frame_pacer, {} };
+
+	// what the last drawn frame showed, for render on demand
+	u64 drawn_camera_version = 0;
+	b8  is_scene_animated = false;
+
 	while (window.should_stay_open())
 	{
-		core::timing::update_delta_time();
-		dev_ui::create_frame();
-		event_handler.collect_input();
-		event_handler.process_input();
-		renderer.render();
+		// hidden or idle, sleeps until an event arrives or the next background frame
+		event_handler.wait_for_events(frame_pacer.get_idle_wait_ns());
 
-		if (event_handler.is_mouse_captured())
+		timing::update_delta_time();
+		memory::begin_frame(render_thread.get_next_frame_index());
 		{
-			ImGui::Begin("Learning OpenGL");
-			dev_ui::prepare_shortcuts_ui();
-			renderer.prepare_dev_ui();
-			camera.prepare_dev_ui();
-			ImGui::End();
+			timing::PhaseScope phase{ timing::Phase::INPUT };
+			event_handler.collect_input();
+			event_handler.process_input();
+			frame_pacer.set_window_state(event_handler.get_window_state());
 		}
+		{
+			timing::PhaseScope phase{ timing::Phase::UPDATE };
 
-		dev_ui::render_frame();
+			const u32 tick_count = fixed_timestep.advance(timing::get_delta_time());
+			const f32 tick_seconds = fixed_timestep.get_tick_seconds();
+			for (u32 tick = 0; tick < tick_count; ++tick)
+			{
+				camera.fixed_update(tick_seconds);
+				scene::update(&scene, tick_seconds);
+			}
+			camera.interpolate(fixed_timestep.get_interpolation());
+
+			// the frames in between ticks interpolate, they are animated as well
+			if (tick_count > 0)
+			{
+				is_scene_animated = scene.transforms.get_last_update_count() > 0;
+			}
+		}
+
+		const b8 is_frame_dirty = event_handler.get_snapshot().event_count > 0 ||
+		                          event_handler.is_replaying() || is_scene_animated ||
+		                          camera.get_version() != drawn_camera_version;
+		if (!frame_pacer.should_draw_frame(is_frame_dirty))
+		{
+			FrameMark;
+			continue;
+		}
+		drawn_camera_version = camera.get_version();
+
+		{
+			timing::PhaseScope phase{ timing::Phase::UI };
+			dev_ui::create_frame();
+			if (event_handler.is_mouse_captured())
+			{
+				ImGui::Begin("Learning OpenGL");
+				dev_ui::prepare_shortcuts_ui();
+				renderer.prepare_dev_ui();
+				render_thread.prepare_dev_ui();
+				frame_pacer.prepare_dev_ui();
+				camera.prepare_dev_ui();
+				fixed_timestep.prepare_dev_ui();
+				timing::prepare_dev_ui();
+				memory::prepare_dev_ui();
+				gl_calls::prepare_dev_ui();
+				ImGui::End();
+			}
+
+			dev_ui::end_frame();
+		}
+
+		FrameSnapshot* snapshot = nullptr;
+		{
+			timing::PhaseScope phase{ timing::Phase::WAIT };
+			snapshot = render_thread.begin_frame();
+
+			// rare (font atlas creation and growth), the UI state must not change meanwhile
+			if (dev_ui::has_texture_requests())
+			{
+				render_thread.run_blocking(
+				    [](void* /* data */)
+				    {
+					    dev_ui::update_textures();
+				    },
+				    nullptr);
+			}
+		}
+		{
+			timing::PhaseScope   phase{ timing::Phase::PREPARE };
+			memory::HotPathGuard hot_path{ "Prepare frame" };
+			renderer.prepare_frame(fixed_timestep.get_interpolation(), snapshot);
+		}
+		snapshot->ui.copy(*ImGui::GetDrawData());
+		render_thread.submit_frame();
+
+		// before the input of the next frame is polled, it is as recent as can be
+		frame_pacer.limit_frame_rate();
 
-		window.gl_swap();
 		FrameMark;
-		TracyGpuCollect;
 	}
 
+	render_thread.stop();
+
+	// the same numbers for every run, to compare builds over a replayed session
+	timing::log_stats(timing::HISTORY_SIZE);
+	renderer.get_gpu_profiler().log_stats();
+
+	jobs::shutdown();
+	memory::shutdown();
 	SDL_Quit();
 	dev_ui::shutdown();
 	fs::destroy();
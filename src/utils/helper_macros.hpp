@@ -24,3 +24,21 @@
 
 /** Shorthand notation to the attribute <c>[[maybe_unused]]</c>. */
 #define M_UNUSED [[maybe_unused]]
+
+#ifdef _MSC_VER
+/** Keeps the function out of line, e.g. to reload thread locals after a fiber switch. */
+#	define M_NOINLINE __declspec(noinline)
+#else
+/** Keeps the function out of line, e.g. to reload thread locals after a fiber switch. */
+#	define M_NOINLINE __attribute__((noinline))
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+/** Compiles the function for the given instruction sets, e.g. "avx2,fma". It must only be
+    called after checking the CPU supports them. */
+#	define M_TARGET(isa) __attribute__((target(isa)))
+#else
+/** Compiles the function for the given instruction sets, e.g. "avx2,fma". It must only be
+    called after checking the CPU supports them. */
+#	define M_TARGET(isa)
+#endif
@@ -1,11 +1,65 @@
 #include "texture_utils.hpp"
 
+#include "core/async.hpp"
 #include "core/filesystem.hpp"
+#include "core/memory.hpp"
+#include "core/resources.hpp"
 
 #include <glad/gl.h>
 #include <stb/stb_image.h>
 
 #include <array>
+#include <span>
+#include <vector>
+
+namespace
+{
+	struct DecodedImage
+	{
+		unsigned char* data = nullptr;
+		int            width = 0;
+		int            height = 0;
+		int            nr_channels = 0;
+	};
+
+	static DecodedImage decode_image(std::span<const u8> image_contents)
+	{
+		DecodedImage image;
+
+		// flip the image for OpenGL, thread local so that workers can decode in parallel
+		stbi_set_flip_vertically_on_load_thread(true);
+
+		image.data = stbi_load_from_memory(
+		    image_contents.data(), static_cast<i32>(image_contents.size()), &image.width,
+		    &image.height, &image.nr_channels, 0);
+
+		return image;
+	}
+
+	static void upload_texture(const DecodedImage& image, u32 handle, b8 has_alpha)
+	{
+		if (image.data != nullptr)
+		{
+			// load texture data and configure
+			glBindTexture(GL_TEXTURE_2D, handle);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width, image.height, 0, has_alpha ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, image.data);
+			glGenerateMipmap(GL_TEXTURE_2D);
+			// set the texture wrapping/filtering options (on the currently bound texture object)
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			static constexpr std::array BORDER_COLOR = { 1.0f, 1.0f, 0.0f, 1.0f };
+			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, BORDER_COLOR.data());
+			stbi_image_free(image.data);
+		}
+		else
+		{
+			SPDLOG_ERROR("Failed to load texture");
+		}
+	}
+}  // namespace
 
 void load_texture(std::string_view file_name, u32 handle)
 {
@@ -16,34 +70,35 @@ void load_texture(std::string_view file_name, u32 handle)
 
 	// load texture from image
 	// load and generate the texture
-	int  width, height, nr_channels;
-	auto image_contents = core::fs::instance().read_file<std::vector<u8>>(core::CoreTextureFile(file_name));
+	memory::ScratchScope scratch;
+	std::pmr::vector<u8> image_contents{ scratch.get_resource() };
+	fs::instance().read_file(CoreTextureFile(file_name), &image_contents);
 
-	// flip the image for OpenGL
-	stbi_set_flip_vertically_on_load(true);
+	upload_texture(decode_image(image_contents), handle, has_alpha);
+}
 
-	unsigned char* data = stbi_load_from_memory(
-	    image_contents.data(), static_cast<i32>(image_contents.size()), &width, &height, &nr_channels, 0
-	);
+core::Task<> load_texture_async(
+    std::string file_name, core::HandlePool<core::Texture>* textures,
+    core::Handle<core::Texture> handle)
+{
+	using namespace core;
 
-	if (data != nullptr)
-	{
-		// load texture data and configure
-		glBindTexture(GL_TEXTURE_2D, handle);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, has_alpha ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		// set the texture wrapping/filtering options (on the currently bound texture object)
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		static constexpr std::array BORDER_COLOR = { 1.0f, 1.0f, 0.0f, 1.0f };
-		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, BORDER_COLOR.data());
-		stbi_image_free(data);
-	}
-	else
+	// little hack
+	bool has_alpha = file_name.ends_with(".png");
+
+	// resumes on a worker, decoding happens there too
+	auto image_contents = co_await async::read_file<std::vector<u8>>(CoreTextureFile(file_name));
+	DecodedImage image = decode_image(image_contents);
+
+	// OpenGL calls are only valid on the thread owning the context
+	co_await async::next_frame();
+
+	const Texture* texture = textures->get(handle);
+	if (texture == nullptr)
 	{
-		SPDLOG_ERROR("Failed to load texture");
+		stbi_image_free(image.data);
+		co_return;
 	}
-}
\ No newline at end of file
+
+	upload_texture(image, texture->id, has_alpha);
+}
@@ -1,6 +1,22 @@
 #pragma once
+#include "core/handle_pool.hpp"
+#include "core/task.hpp"
 #include "core/types.hpp"
 
+#include <string>
 #include <string_view>
 
-void load_texture(std::string_view file_name, u32 handle);
\ No newline at end of file
+namespace core
+{
+	class Texture;
+}
+
+void load_texture(std::string_view file_name, u32 handle);
+
+/**
+ * Reads and decodes the texture on a worker, the upload happens on the GL thread. Nothing is
+ * uploaded when the texture was destroyed in the meantime, its GL name may be reused already.
+ */
+core::Task<> load_texture_async(
+    std::string file_name, core::HandlePool<core::Texture>* textures,
+    core::Handle<core::Texture> handle);